@@ -0,0 +1,134 @@
+#pragma once
+
+#include<vector>
+#include<string>
+#include<utility>
+#include<chrono>
+#include<ctime>
+#include<fstream>
+#include<cstdio>
+
+//׼ԽJSONGoogle Benchmark--benchmark_format=jsonʽһ£
+//ֱtools/compare.pyȽύĽ
+class BenchmarkReport
+{
+public:
+	struct Result
+	{
+		std::string name;
+		uint64_t iterations;
+		double realTime;		//ÿεʱ䣬λtimeUnit
+		double cpuTime;
+		const char* timeUnit;	//"ns""us""ms"
+		std::vector<std::pair<std::string, double>> counters;
+	};
+
+	//ͬʱȡǽӺͽCPUʱ
+	class Timer
+	{
+	public:
+		Timer() : wallStart(std::chrono::steady_clock::now()), cpuStart(std::clock()) {}
+
+		double wallMs() const
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+		}
+
+		double cpuMs() const
+		{
+			return 1000.0 * static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+		}
+
+	private:
+		std::chrono::steady_clock::time_point wallStart;
+		std::clock_t cpuStart;
+	};
+
+	void setContext(const std::string& key, const std::string& value)
+	{
+		context.push_back({ key, value });
+	}
+
+	//ʱ䶼ʱ䣨룩ÿεʱ
+	void add(const std::string& name, uint64_t iterations, double totalWallMs, double totalCpuMs,
+		std::vector<std::pair<std::string, double>> counters = {}, const char* timeUnit = "ms")
+	{
+		double scale = 1.0;
+		if (std::string(timeUnit) == "us")
+			scale = 1e3;
+		else if (std::string(timeUnit) == "ns")
+			scale = 1e6;
+		double perIteration = iterations > 0 ? scale / iterations : 0.0;
+		results.push_back({ name, iterations, totalWallMs * perIteration, totalCpuMs * perIteration, timeUnit, std::move(counters) });
+	}
+
+	const std::vector<Result>& getResults() const { return results; }
+
+	void print() const
+	{
+		printf("%-48s %14s %14s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+		for (const auto& result : results)
+		{
+			printf("%-48s %11.3f %-2s %11.3f %-2s %12llu", result.name.c_str(), result.realTime, result.timeUnit,
+				result.cpuTime, result.timeUnit, static_cast<unsigned long long>(result.iterations));
+			for (const auto& counter : result.counters)
+				printf(" %s=%g", counter.first.c_str(), counter.second);
+			printf("\n");
+		}
+	}
+
+	std::string toJson() const
+	{
+		std::string json = "{\n  \"context\": {\n";
+		for (size_t i = 0; i < context.size(); i++)
+			json += "    \"" + escape(context[i].first) + "\": \"" + escape(context[i].second) + "\"" + (i + 1 < context.size() ? ",\n" : "\n");
+		json += "  },\n  \"benchmarks\": [\n";
+
+		char number[64];
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const Result& result = results[i];
+			json += "    {\n      \"name\": \"" + escape(result.name) + "\",\n";
+			json += "      \"run_name\": \"" + escape(result.name) + "\",\n";
+			json += "      \"run_type\": \"iteration\",\n";
+			json += "      \"iterations\": " + std::to_string(result.iterations) + ",\n";
+			snprintf(number, sizeof(number), "%.6f", result.realTime);
+			json += std::string("      \"real_time\": ") + number + ",\n";
+			snprintf(number, sizeof(number), "%.6f", result.cpuTime);
+			json += std::string("      \"cpu_time\": ") + number + ",\n";
+			for (const auto& counter : result.counters)
+			{
+				snprintf(number, sizeof(number), "%.6g", counter.second);
+				json += "      \"" + escape(counter.first) + "\": " + number + ",\n";
+			}
+			json += std::string("      \"time_unit\": \"") + result.timeUnit + "\"\n";
+			json += i + 1 < results.size() ? "    },\n" : "    }\n";
+		}
+		return json + "  ]\n}\n";
+	}
+
+	bool writeJson(const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file)
+			return false;
+		file << toJson();
+		return static_cast<bool>(file);
+	}
+
+private:
+	static std::string escape(const std::string& text)
+	{
+		std::string escaped;
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+				escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	std::vector<std::pair<std::string, std::string>> context;
+	std::vector<Result> results;
+};
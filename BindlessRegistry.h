@@ -0,0 +1,403 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDispatch.h"
+
+#include<vector>
+#include<stdexcept>
+#include<algorithm>
+#include<cstdio>
+
+//Դ32λڶӦ±꣬ͨͳɫ
+using BindlessHandle = uint32_t;
+constexpr BindlessHandle invalidBindlessHandle = ~0u;
+
+//ÿλ͵ľɫͬĲpush_constant
+struct BindlessPushConstants
+{
+	BindlessHandle image;
+	BindlessHandle sampler;
+	BindlessHandle buffer;
+	uint32_t drawIndex;
+};
+
+//ްԴһ飨ͼ񡢴洢塢ֻ֡һ
+//ʱUPDATE_AFTER_BINDעԴã
+//ûʱ˻ÿ֡һС飬ܵһ֡ʼդȹ֮дλһעԴ
+class BindlessRegistry
+{
+public:
+	enum Binding : uint32_t
+	{
+		SampledImages = 0,
+		StorageBuffers = 1,
+		Samplers = 2,
+		BindingCount = 3,
+	};
+
+	void init(VkPhysicalDevice physicalDevice, VkDevice device, const VulkanDispatch& dispatch, bool descriptorIndexing, uint32_t framesInFlight,
+		const VkAllocationCallbacks* allocationCallbacks)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+		this->allocationCallbacks = allocationCallbacks;
+		bindless = descriptorIndexing;
+		this->framesInFlight = framesInFlight;
+
+		chooseCapacities(physicalDevice);
+		createLayouts();
+		createSets(bindless ? 1 : framesInFlight);
+	}
+
+	bool isBindless() const { return bindless; }
+	VkDescriptorSetLayout setLayout() const { return descriptorSetLayout; }
+	VkPipelineLayout pipelineLayout() const { return layout; }
+
+	BindlessHandle registerImage(VkImageView imageView, VkImageLayout imageLayout)
+	{
+		VkDescriptorImageInfo info{ VK_NULL_HANDLE, imageView, imageLayout };
+		return add(SampledImages, images, info);
+	}
+
+	BindlessHandle registerBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE)
+	{
+		VkDescriptorBufferInfo info{ buffer, offset, range };
+		return add(StorageBuffers, buffers, info);
+	}
+
+	BindlessHandle registerSampler(VkSampler sampler)
+	{
+		VkDescriptorImageInfo info{ sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED };
+		return add(Samplers, samplers, info);
+	}
+
+	//Ҫз֡úܸã·¿ճλøĻָһԴ
+	//·0žλõģһֱռŲգԴҪregistry
+	void release(Binding binding, BindlessHandle handle)
+	{
+		if (!bindless && handle == 0)
+			return;
+		retired.push_back({ binding, handle, frameCounter + framesInFlight });
+		if (bindless)
+			return;
+
+		if (binding == StorageBuffers)
+			buffers[handle] = buffers[0];
+		else if (binding == SampledImages)
+			images[handle] = images[0];
+		else
+			samplers[handle] = samplers[0];
+		for (auto& dirty : slots[binding].dirty)
+			dirty.push_back(handle);
+	}
+
+	//һ֡դȹ֮ãյڵľ·°ܵĸдһ֡
+	void beginFrame(uint32_t frame)
+	{
+		currentSet = bindless ? 0 : frame;
+		frameCounter++;
+
+		for (size_t i = 0; i < retired.size();)
+		{
+			if (retired[i].releaseFrame > frameCounter)
+			{
+				i++;
+				continue;
+			}
+			slots[retired[i].binding].freeList.push_back(retired[i].handle);
+			retired[i] = retired.back();
+			retired.pop_back();
+		}
+
+		if (!bindless)
+			flushPending(frame);
+	}
+
+	//һ֡һΣ֮ÿλֻ;
+	void bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint) const
+	{
+		dispatch->vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, 0, 1, &sets[currentSet], 0, nullptr);
+	}
+
+	void push(VkCommandBuffer commandBuffer, const BindlessPushConstants& constants) const
+	{
+		dispatch->vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_ALL, 0, sizeof(constants), &constants);
+	}
+
+	void destroy()
+	{
+		dispatch->vkDestroyPipelineLayout(device, layout, allocationCallbacks);
+		dispatch->vkDestroyDescriptorPool(device, pool, allocationCallbacks);
+		dispatch->vkDestroyDescriptorSetLayout(device, descriptorSetLayout, allocationCallbacks);
+		layout = VK_NULL_HANDLE;
+		pool = VK_NULL_HANDLE;
+		descriptorSetLayout = VK_NULL_HANDLE;
+		sets.clear();
+	}
+
+	void printStats() const
+	{
+		printf("bindless: %s, images %u/%u, buffers %u/%u, samplers %u/%u, %llu descriptor writes\n",
+			bindless ? "update-after-bind" : "per-frame fallback",
+			slots[SampledImages].next, slots[SampledImages].capacity, slots[StorageBuffers].next, slots[StorageBuffers].capacity,
+			slots[Samplers].next, slots[Samplers].capacity, static_cast<unsigned long long>(descriptorWrites));
+	}
+
+private:
+	struct Slots
+	{
+		uint32_t capacity = 0;
+		uint32_t next = 0;						//ûùĵһ±
+		std::vector<BindlessHandle> freeList;
+		std::vector<std::vector<uint32_t>> dirty;	//·ÿ֡ûдȥ±
+	};
+
+	struct Retired
+	{
+		Binding binding;
+		BindlessHandle handle;
+		uint64_t releaseFrame;
+	};
+
+	static VkDescriptorType descriptorType(Binding binding)
+	{
+		switch (binding)
+		{
+		case SampledImages: return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+		case StorageBuffers: return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		default: return VK_DESCRIPTOR_TYPE_SAMPLER;
+		}
+	}
+
+	//С豸ƣްʱUPDATE_AFTER_BINDƣ·ͨÿ׶ơ
+	//ͼͻܳÿ׶Դ㣩Ųʱռһ롢ͼʣµģް󶨵һŲ¾˻ÿ֡·
+	void chooseCapacities(VkPhysicalDevice physicalDevice)
+	{
+		VkPhysicalDeviceDescriptorIndexingProperties indexingProperties{};
+		indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		if (bindless)
+		{
+			properties2.pNext = &indexingProperties;
+			dispatch->vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+		}
+		else
+		{
+			dispatch->vkGetPhysicalDeviceProperties(physicalDevice, &properties2.properties);
+		}
+		const VkPhysicalDeviceLimits& limits = properties2.properties.limits;
+
+		if (bindless)
+		{
+			slots[SampledImages].capacity = std::min({ 16384u, indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+				indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages });
+			slots[StorageBuffers].capacity = std::min({ 4096u, indexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+				indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers });
+			slots[Samplers].capacity = std::min({ 256u, indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+				indexingProperties.maxDescriptorSetUpdateAfterBindSamplers });
+			if (!fitResources(indexingProperties.maxPerStageUpdateAfterBindResources))
+			{
+				printf("bindless: the update-after-bind limits are too small, using the per-frame fallback\n");
+				bindless = false;
+			}
+		}
+		if (!bindless)
+		{
+			slots[SampledImages].capacity = std::min({ 256u, limits.maxPerStageDescriptorSampledImages, limits.maxDescriptorSetSampledImages });
+			slots[StorageBuffers].capacity = std::min({ 64u, limits.maxPerStageDescriptorStorageBuffers, limits.maxDescriptorSetStorageBuffers });
+			slots[Samplers].capacity = std::min({ 16u, limits.maxPerStageDescriptorSamplers, limits.maxDescriptorSetSamplers });
+			if (!fitResources(limits.maxPerStageResources))
+				throw std::runtime_error("device limits are too small for the bindless registry!");
+		}
+
+		for (auto& slot : slots)
+			slot.dirty.assign(bindless ? 0 : framesInFlight, {});
+		images.assign(slots[SampledImages].capacity, {});
+		buffers.assign(slots[StorageBuffers].capacity, {});
+		samplers.assign(slots[Samplers].capacity, {});
+	}
+
+	bool fitResources(uint32_t maxResources)
+	{
+		uint32_t& imageCapacity = slots[SampledImages].capacity;
+		uint32_t& bufferCapacity = slots[StorageBuffers].capacity;
+		if (imageCapacity == 0 || bufferCapacity == 0 || slots[Samplers].capacity == 0 || maxResources < 2)
+			return false;
+		if (static_cast<uint64_t>(imageCapacity) + bufferCapacity > maxResources)
+		{
+			bufferCapacity = std::min(bufferCapacity, maxResources / 2);
+			imageCapacity = std::min(imageCapacity, maxResources - bufferCapacity);
+		}
+		return true;
+	}
+
+	void createLayouts()
+	{
+		VkDescriptorSetLayoutBinding bindings[BindingCount]{};
+		VkDescriptorBindingFlags bindingFlags[BindingCount]{};
+		for (uint32_t i = 0; i < BindingCount; i++)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = descriptorType(static_cast<Binding>(i));
+			bindings[i].descriptorCount = slots[i].capacity;
+			bindings[i].stageFlags = VK_SHADER_STAGE_ALL;
+			//ְ󶨣ûע±Чδʹõ±ִڼҲܸ
+			bindingFlags[i] = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+				VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+		}
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+		flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+		flagsInfo.bindingCount = BindingCount;
+		flagsInfo.pBindingFlags = bindingFlags;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = BindingCount;
+		layoutInfo.pBindings = bindings;
+		if (bindless)
+		{
+			layoutInfo.pNext = &flagsInfo;
+			layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+		}
+		if (dispatch->vkCreateDescriptorSetLayout(device, &layoutInfo, allocationCallbacks, &descriptorSetLayout) != VK_SUCCESS)
+			throw std::runtime_error("failed to create bindless descriptor set layout!");
+
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_ALL;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(BindlessPushConstants);
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+		if (dispatch->vkCreatePipelineLayout(device, &pipelineLayoutInfo, allocationCallbacks, &layout) != VK_SUCCESS)
+			throw std::runtime_error("failed to create bindless pipeline layout!");
+	}
+
+	void createSets(uint32_t setCount)
+	{
+		VkDescriptorPoolSize poolSizes[BindingCount];
+		for (uint32_t i = 0; i < BindingCount; i++)
+			poolSizes[i] = { descriptorType(static_cast<Binding>(i)), slots[i].capacity * setCount };
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = bindless ? VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT : 0;
+		poolInfo.maxSets = setCount;
+		poolInfo.poolSizeCount = BindingCount;
+		poolInfo.pPoolSizes = poolSizes;
+		if (dispatch->vkCreateDescriptorPool(device, &poolInfo, allocationCallbacks, &pool) != VK_SUCCESS)
+			throw std::runtime_error("failed to create bindless descriptor pool!");
+
+		std::vector<VkDescriptorSetLayout> layouts(setCount, descriptorSetLayout);
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = pool;
+		allocInfo.descriptorSetCount = setCount;
+		allocInfo.pSetLayouts = layouts.data();
+		sets.resize(setCount);
+		if (dispatch->vkAllocateDescriptorSets(device, &allocInfo, sets.data()) != VK_SUCCESS)
+			throw std::runtime_error("failed to allocate bindless descriptor sets!");
+	}
+
+	template<typename Info>
+	BindlessHandle add(Binding binding, std::vector<Info>& infos, const Info& info)
+	{
+		Slots& slot = slots[binding];
+		BindlessHandle handle;
+		if (!slot.freeList.empty())
+		{
+			handle = slot.freeList.back();
+			slot.freeList.pop_back();
+		}
+		else if (slot.next < slot.capacity)
+		{
+			handle = slot.next++;
+		}
+		else
+		{
+			throw std::runtime_error("bindless registry is full!");
+		}
+
+		infos[handle] = info;
+		if (bindless)
+		{
+			//UPDATE_AFTER_BIND±ûбеãֱд
+			write(sets[0], binding, handle, 1);
+		}
+		else if (handle == 0)
+		{
+			//·ûвְ󶨣鶼ҪЧһעʱ0Ųգֻһ
+			std::fill(infos.begin(), infos.end(), info);
+			for (auto& dirty : slot.dirty)
+				dirty.push_back(allSlots);
+		}
+		else
+		{
+			for (auto& dirty : slot.dirty)
+				dirty.push_back(handle);
+		}
+		return handle;
+	}
+
+	void flushPending(uint32_t frame)
+	{
+		for (uint32_t binding = 0; binding < BindingCount; binding++)
+		{
+			auto& dirty = slots[binding].dirty[frame];
+			for (uint32_t index : dirty)
+			{
+				if (index == allSlots)
+					write(sets[frame], static_cast<Binding>(binding), 0, slots[binding].capacity);
+				else
+					write(sets[frame], static_cast<Binding>(binding), index, 1);
+			}
+			dirty.clear();
+		}
+	}
+
+	void write(VkDescriptorSet set, Binding binding, uint32_t first, uint32_t count)
+	{
+		VkWriteDescriptorSet descriptorWrite{};
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet = set;
+		descriptorWrite.dstBinding = binding;
+		descriptorWrite.dstArrayElement = first;
+		descriptorWrite.descriptorCount = count;
+		descriptorWrite.descriptorType = descriptorType(binding);
+		if (binding == StorageBuffers)
+			descriptorWrite.pBufferInfo = &buffers[first];
+		else
+			descriptorWrite.pImageInfo = binding == SampledImages ? &images[first] : &samplers[first];
+		dispatch->vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+		descriptorWrites += count;
+	}
+
+	static constexpr uint32_t allSlots = ~0u;
+
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;
+	const VkAllocationCallbacks* allocationCallbacks = nullptr;
+	bool bindless = false;
+	uint32_t framesInFlight = 1;
+	uint64_t frameCounter = 0;
+	uint32_t currentSet = 0;
+
+	VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+	VkPipelineLayout layout = VK_NULL_HANDLE;
+	VkDescriptorPool pool = VK_NULL_HANDLE;
+	std::vector<VkDescriptorSet> sets;				//ްʱֻһ
+
+	Slots slots[BindingCount];
+	std::vector<VkDescriptorImageInfo> images;
+	std::vector<VkDescriptorBufferInfo> buffers;
+	std::vector<VkDescriptorImageInfo> samplers;
+	std::vector<Retired> retired;
+	uint64_t descriptorWrites = 0;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDispatch.h"
+#include "JobSystem.h"
+
+#include<vector>
+#include<functional>
+#include<stdexcept>
+#include<algorithm>
+
+//߳¼ƶ壺ÿ֡ÿ߳һأ
+//ֻ߳ʹã¼ʱҪ
+class ParallelCommandRecorder
+{
+public:
+	using RecordFunction = std::function<void(VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end)>;
+
+	void init(VkDevice device, const VulkanDispatch& dispatch, uint32_t queueFamily, uint32_t framesInFlight, uint32_t workerCount)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+		pools.resize(framesInFlight);
+		for (auto& framePools : pools)
+		{
+			framePools.resize(workerCount);
+			for (auto& pool : framePools)
+			{
+				VkCommandPoolCreateInfo poolInfo{};
+				poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+				poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+				poolInfo.queueFamilyIndex = queueFamily;
+				if (dispatch.vkCreateCommandPool(device, &poolInfo, nullptr, &pool.commandPool) != VK_SUCCESS)
+					throw std::runtime_error("failed to create worker command pool!");
+			}
+		}
+	}
+
+	//һ֡դѾȹ֮ãñ
+	void resetFrame(uint32_t frame)
+	{
+		for (auto& pool : pools[frame])
+		{
+			dispatch->vkResetCommandPool(device, pool.commandPool, 0);
+			pool.used = 0;
+		}
+	}
+
+	//[0, itemCount)гƬ¼ƣÿƬһ壬ص˳Ƭ˳һ
+	const std::vector<VkCommandBuffer>& record(JobSystem& jobs, uint32_t frame, uint32_t itemCount, uint32_t itemsPerSlice,
+		const VkCommandBufferInheritanceInfo& inheritance, const RecordFunction& recordSlice)
+	{
+		uint32_t sliceCount = (itemCount + itemsPerSlice - 1) / itemsPerSlice;
+		slices.assign(sliceCount, VK_NULL_HANDLE);
+
+		jobs.parallelFor(sliceCount, 1, [&](uint32_t begin, uint32_t end, uint32_t worker)
+		{
+			for (uint32_t slice = begin; slice < end; slice++)
+			{
+				VkCommandBuffer commandBuffer = acquire(pools[frame][worker]);
+
+				VkCommandBufferBeginInfo beginInfo{};
+				beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+				beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+				beginInfo.pInheritanceInfo = &inheritance;
+				if (dispatch->vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+					throw std::runtime_error("failed to begin recording secondary command buffer!");
+
+				uint32_t first = slice * itemsPerSlice;
+				recordSlice(commandBuffer, first, std::min(first + itemsPerSlice, itemCount));
+
+				if (dispatch->vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+					throw std::runtime_error("failed to record secondary command buffer!");
+				slices[slice] = commandBuffer;
+			}
+		});
+		return slices;
+	}
+
+	void destroy()
+	{
+		for (auto& framePools : pools)
+			for (auto& pool : framePools)
+				dispatch->vkDestroyCommandPool(device, pool.commandPool, nullptr);
+		pools.clear();
+	}
+
+private:
+	//ֻغͷ
+	struct WorkerPool
+	{
+		VkCommandPool commandPool = VK_NULL_HANDLE;
+		std::vector<VkCommandBuffer> commandBuffers;
+		size_t used = 0;
+	};
+
+	VkCommandBuffer acquire(WorkerPool& pool)
+	{
+		if (pool.used == pool.commandBuffers.size())
+		{
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = pool.commandPool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+			allocInfo.commandBufferCount = 1;
+			VkCommandBuffer commandBuffer;
+			if (dispatch->vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+				throw std::runtime_error("failed to allocate secondary command buffer!");
+			pool.commandBuffers.push_back(commandBuffer);
+		}
+		return pool.commandBuffers[pool.used++];
+	}
+
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;
+	std::vector<std::vector<WorkerPool>> pools;	//[֡][߳]
+	std::vector<VkCommandBuffer> slices;
+};
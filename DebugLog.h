@@ -0,0 +1,279 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include<vector>
+#include<string>
+#include<thread>
+#include<atomic>
+#include<chrono>
+#include<memory>
+#include<algorithm>
+#include<cstring>
+#include<cstdio>
+
+//֤Ϣ첽־صֻˡmessageIdNumberȥأٰһ¼ŽУ
+//ʽдļ/̨ں̨߳Vulkan̲߳ᱻ
+class DebugLog
+{
+public:
+	struct MessageCount
+	{
+		int32_t messageId;
+		std::string name;
+		uint64_t count;
+	};
+
+	~DebugLog()
+	{
+		stop();
+	}
+
+	//pathΪʱд׼repeatLimitͬһmessageIdNumber
+	void start(const std::string& path, uint32_t repeatLimit = 1)
+	{
+		if (running)
+			return;
+		this->repeatLimit = repeatLimit;
+
+		output = stdout;
+		if (!path.empty())
+		{
+			output = fopen(path.c_str(), "w");
+			if (output == nullptr)
+			{
+				printf("debug log: cannot open %s, falling back to stdout\n", path.c_str());
+				output = stdout;
+			}
+		}
+
+		ring.reset(new Slot[ringCapacity]);
+		for (uint32_t i = 0; i < ringCapacity; i++)
+			ring[i].sequence.store(i, std::memory_order_relaxed);
+		enqueuePos.store(0, std::memory_order_relaxed);
+		dequeuePos = 0;
+
+		running = true;
+		stopRequested.store(false, std::memory_order_relaxed);
+		writer = std::thread(&DebugLog::writerLoop, this);
+	}
+
+	//дʣµϢ˳
+	void stop()
+	{
+		if (!running)
+			return;
+		stopRequested.store(true, std::memory_order_release);
+		writer.join();
+		running = false;
+
+		if (output != stdout)
+			fclose(output);
+		output = nullptr;
+	}
+
+	//ʱֻʹĵķΧЧ
+	void setFilter(VkDebugUtilsMessageSeverityFlagsEXT severities, VkDebugUtilsMessageTypeFlagsEXT types)
+	{
+		severityMask.store(severities, std::memory_order_relaxed);
+		typeMask.store(types, std::memory_order_relaxed);
+	}
+
+	VkDebugUtilsMessageSeverityFlagsEXT getSeverityFilter() const { return severityMask.load(std::memory_order_relaxed); }
+
+	//ԻصãͬʱԶ߳
+	void submit(VkDebugUtilsMessageSeverityFlagBitsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type,
+		const VkDebugUtilsMessengerCallbackDataEXT* data)
+	{
+		if (!(severity & severityMask.load(std::memory_order_relaxed)) || !(type & typeMask.load(std::memory_order_relaxed)))
+			return;
+
+		uint64_t count = countMessage(data->messageIdNumber, data->pMessageIdName);
+		if (count > repeatLimit || !running.load(std::memory_order_acquire))
+			return;
+
+		//VyukovнMPSCУλúд룬ŷ
+		uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+		Slot* slot;
+		for (;;)
+		{
+			slot = &ring[pos % ringCapacity];
+			uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+			int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+			if (diff == 0)
+			{
+				if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+			{
+				//˾Ͷȴ
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			else
+			{
+				pos = enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		Record& record = slot->record;
+		record.severity = severity;
+		record.type = type;
+		record.messageId = data->messageIdNumber;
+		record.repeat = static_cast<uint32_t>(count);
+		copyString(record.idName, sizeof(record.idName), data->pMessageIdName);
+		copyString(record.message, sizeof(record.message), data->pMessage);
+		slot->sequence.store(pos + 1, std::memory_order_release);
+	}
+
+	//messageIdNumberͳƵϢȥغ͹˵֮ǰĴ
+	std::vector<MessageCount> getCounts() const
+	{
+		std::vector<MessageCount> counts;
+		for (uint32_t i = 0; i < tableCapacity; i++)
+		{
+			const CountEntry& entry = table[i];
+			uint64_t key = entry.key.load(std::memory_order_acquire);
+			if (key == 0)
+				continue;
+			std::string name = entry.named.load(std::memory_order_acquire) ? entry.name : "";
+			counts.push_back({ static_cast<int32_t>(static_cast<uint32_t>(key)), name, entry.count.load(std::memory_order_relaxed) });
+		}
+		std::sort(counts.begin(), counts.end(), [](const MessageCount& a, const MessageCount& b) { return a.count > b.count; });
+		return counts;
+	}
+
+	void printCounts() const
+	{
+		auto counts = getCounts();
+		if (counts.empty() && dropped.load() == 0)
+			return;
+		printf("debug log: %zu distinct message ids, %llu dropped (queue full)\n", counts.size(),
+			static_cast<unsigned long long>(dropped.load()));
+		for (const auto& count : counts)
+			printf("  %10llu x %d %s\n", static_cast<unsigned long long>(count.count), count.messageId, count.name.c_str());
+	}
+
+private:
+	struct Record
+	{
+		uint32_t severity;
+		uint32_t type;
+		int32_t messageId;
+		uint32_t repeat;
+		char idName[64];
+		char message[1024];
+	};
+
+	struct Slot
+	{
+		std::atomic<uint64_t> sequence{ 0 };
+		Record record;
+	};
+
+	//Ѱַļkey(1<<32)|id0ʾλ
+	struct CountEntry
+	{
+		std::atomic<uint64_t> key{ 0 };
+		std::atomic<uint64_t> count{ 0 };
+		std::atomic<bool> named{ false };
+		char name[64] = {};
+	};
+
+	uint64_t countMessage(int32_t messageId, const char* name)
+	{
+		uint64_t key = (1ull << 32) | static_cast<uint32_t>(messageId);
+		uint32_t index = (static_cast<uint32_t>(messageId) * 2654435761u) % tableCapacity;
+		for (uint32_t probe = 0; probe < tableCapacity; probe++)
+		{
+			CountEntry& entry = table[(index + probe) % tableCapacity];
+			uint64_t current = entry.key.load(std::memory_order_acquire);
+			if (current == 0)
+			{
+				if (entry.key.compare_exchange_strong(current, key, std::memory_order_acq_rel))
+				{
+					copyString(entry.name, sizeof(entry.name), name);
+					entry.named.store(true, std::memory_order_release);
+					current = key;
+				}
+			}
+			if (current == key)
+				return entry.count.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
+		//ˣȥ
+		return 1;
+	}
+
+	static void copyString(char* dst, size_t size, const char* src)
+	{
+		if (src == nullptr)
+		{
+			dst[0] = '\0';
+			return;
+		}
+		size_t length = std::min(strlen(src), size - 1);
+		memcpy(dst, src, length);
+		dst[length] = '\0';
+	}
+
+	static const char* severityName(uint32_t severity)
+	{
+		if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) return "ERROR";
+		if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) return "WARNING";
+		if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) return "INFO";
+		return "VERBOSE";
+	}
+
+	static const char* typeName(uint32_t type)
+	{
+		if (type & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT) return "validation";
+		if (type & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT) return "performance";
+		return "general";
+	}
+
+	//̨̣߳п˾Ͷ˯ߣϢʱдˢһ
+	void writerLoop()
+	{
+		for (;;)
+		{
+			bool stopping = stopRequested.load(std::memory_order_acquire);
+			uint32_t written = 0;
+			Slot* slot;
+			while ((slot = &ring[dequeuePos % ringCapacity])->sequence.load(std::memory_order_acquire) == dequeuePos + 1)
+			{
+				const Record& record = slot->record;
+				fprintf(output, "[%s][%s] %s (0x%08x)%s\n%s\n", severityName(record.severity), typeName(record.type),
+					record.idName, static_cast<uint32_t>(record.messageId),
+					record.repeat == repeatLimit ? " [further repeats suppressed]" : "", record.message);
+				slot->sequence.store(dequeuePos + ringCapacity, std::memory_order_release);
+				dequeuePos++;
+				written++;
+			}
+			if (written > 0)
+				fflush(output);
+			else if (stopping)
+				return;
+			else
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+	}
+
+	static constexpr uint32_t ringCapacity = 1024;
+	static constexpr uint32_t tableCapacity = 4096;
+
+	std::unique_ptr<Slot[]> ring;
+	std::atomic<uint64_t> enqueuePos{ 0 };
+	uint64_t dequeuePos = 0;		//ֻк̨߳
+	std::atomic<uint64_t> dropped{ 0 };
+
+	CountEntry table[tableCapacity];
+	std::atomic<uint32_t> severityMask{ VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT };
+	std::atomic<uint32_t> typeMask{ VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT };
+	uint32_t repeatLimit = 1;
+
+	FILE* output = nullptr;
+	std::thread writer;
+	std::atomic<bool> stopRequested{ false };
+	std::atomic<bool> running{ false };
+};
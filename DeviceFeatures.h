@@ -0,0 +1,207 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include<vector>
+#include<string>
+#include<cstdio>
+#include<cstring>
+#include<algorithm>
+
+//豸Э̣vkGetPhysicalDeviceFeatures2ѯ豸ʵֵ֧1.2/1.3ܣ
+//ֵֻ֧Щѽĵúİ汾ûĵչչ1.0豸ȫر
+class DeviceFeatures
+{
+public:
+	uint32_t apiVersion = VK_API_VERSION_1_0;	//ʵ豸ߵСֵ
+	bool dynamicRendering = false;
+	bool synchronization2 = false;
+	bool timelineSemaphore = false;
+	bool bufferDeviceAddress = false;
+	bool descriptorIndexing = false;			//ްҪӹ
+	bool multiDrawIndirect = false;				//1.0ĻܣVkPhysicalDeviceFeatures
+	bool drawIndirectFirstInstance = false;
+	bool drawIndirectCount = false;				//ֻVK_KHR_draw_indirect_countչ1.2ĹλҪVulkan12Featuresһ
+
+	//汾չȡĺָ룬1.3ҪKHR׺
+	PFN_vkCmdBeginRendering cmdBeginRendering = nullptr;
+	PFN_vkCmdEndRendering cmdEndRendering = nullptr;
+	PFN_vkCmdPipelineBarrier2 cmdPipelineBarrier2 = nullptr;
+	PFN_vkCmdDrawIndexedIndirectCount cmdDrawIndexedIndirectCount = nullptr;
+	PFN_vkWaitSemaphores waitSemaphores = nullptr;
+	PFN_vkSignalSemaphore signalSemaphore = nullptr;
+
+	void query(VkPhysicalDevice physicalDevice, uint32_t instanceApiVersion, uint32_t maxApiVersion)
+	{
+		*this = DeviceFeatures{};
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		apiVersion = std::min({ withoutPatch(properties.apiVersion), withoutPatch(instanceApiVersion), withoutPatch(maxApiVersion) });
+
+		//ӻƵ1.0
+		VkPhysicalDeviceFeatures baseFeatures;
+		vkGetPhysicalDeviceFeatures(physicalDevice, &baseFeatures);
+		multiDrawIndirect = baseFeatures.multiDrawIndirect == VK_TRUE;
+		drawIndirectFirstInstance = baseFeatures.drawIndirectFirstInstance == VK_TRUE;
+
+		//vkGetPhysicalDeviceFeatures21.1ĺĺ1.0豸ֱ·
+		if (apiVersion < VK_API_VERSION_1_1)
+			return;
+
+		uint32_t extensionCount = 0;
+		vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+		std::vector<VkExtensionProperties> extensions(extensionCount);
+		vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data());
+		auto hasExtension = [&extensions](const char* name) {
+			for (const auto& extension : extensions)
+				if (strcmp(extension.extensionName, name) == 0)
+					return true;
+			return false;
+		};
+
+		//ȿİ汾չǷṩpNextѯĹλ
+		timelineExtension = apiVersion < VK_API_VERSION_1_2 && hasExtension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+		addressExtension = apiVersion < VK_API_VERSION_1_2 && hasExtension(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
+		indexingExtension = apiVersion < VK_API_VERSION_1_2 && hasExtension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+		sync2Extension = apiVersion < VK_API_VERSION_1_3 && hasExtension(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+		//KHR_dynamic_renderingչ1.2˺ģ1.1豸ϲ
+		renderingExtension = apiVersion == VK_API_VERSION_1_2 && hasExtension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+		drawIndirectCount = hasExtension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+		bool core12 = apiVersion >= VK_API_VERSION_1_2;
+		bool core13 = apiVersion >= VK_API_VERSION_1_3;
+
+		VkPhysicalDeviceFeatures2 features2{};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		resetChain(core12 || timelineExtension, core12 || addressExtension, core12 || indexingExtension,
+			core13 || sync2Extension, core13 || renderingExtension);
+		features2.pNext = head;
+		vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+		timelineSemaphore = timelineFeatures.timelineSemaphore == VK_TRUE;
+		bufferDeviceAddress = addressFeatures.bufferDeviceAddress == VK_TRUE;
+		descriptorIndexing = indexingFeatures.runtimeDescriptorArray && indexingFeatures.descriptorBindingPartiallyBound &&
+			indexingFeatures.shaderSampledImageArrayNonUniformIndexing && indexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+			indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind && indexingFeatures.descriptorBindingUpdateUnusedWhilePending;
+		synchronization2 = sync2Features.synchronization2 == VK_TRUE;
+		dynamicRendering = renderingFeatures.dynamicRendering == VK_TRUE;
+	}
+
+	//ֻЭ̳ɹĹλصӵVkDeviceCreateInfo::pNext
+	const void* chain()
+	{
+		resetChain(timelineSemaphore, bufferDeviceAddress, descriptorIndexing, synchronization2, dynamicRendering);
+		timelineFeatures.timelineSemaphore = timelineSemaphore;
+		addressFeatures.bufferDeviceAddress = bufferDeviceAddress;
+		if (descriptorIndexing)
+		{
+			indexingFeatures.runtimeDescriptorArray = VK_TRUE;
+			indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+			indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+			indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+			indexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+		}
+		sync2Features.synchronization2 = synchronization2;
+		renderingFeatures.dynamicRendering = dynamicRendering;
+		return head;
+	}
+
+	//λVkDeviceCreateInfo::pEnabledFeaturesָĽṹ
+	void enableBaseFeatures(VkPhysicalDeviceFeatures& enabled) const
+	{
+		enabled.multiDrawIndirect = multiDrawIndirect;
+		enabled.drawIndirectFirstInstance = drawIndirectFirstInstance;
+	}
+
+	//ûĵĹҪ豸չ
+	void addExtensions(std::vector<const char*>& extensions) const
+	{
+		if (timelineSemaphore && timelineExtension)
+			extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+		if (bufferDeviceAddress && addressExtension)
+			extensions.push_back(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
+		if (descriptorIndexing && indexingExtension)
+			extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+		if (synchronization2 && sync2Extension)
+			extensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+		if (dynamicRendering && renderingExtension)
+			extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+		if (drawIndirectCount)
+			extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+	}
+
+	//豸֮ȡĺָ룬ȡ͵֧
+	void loadFunctions(VkDevice device)
+	{
+		if (dynamicRendering)
+		{
+			cmdBeginRendering = (PFN_vkCmdBeginRendering)vkGetDeviceProcAddr(device, renderingExtension ? "vkCmdBeginRenderingKHR" : "vkCmdBeginRendering");
+			cmdEndRendering = (PFN_vkCmdEndRendering)vkGetDeviceProcAddr(device, renderingExtension ? "vkCmdEndRenderingKHR" : "vkCmdEndRendering");
+			dynamicRendering = cmdBeginRendering != nullptr && cmdEndRendering != nullptr;
+		}
+		if (synchronization2)
+		{
+			cmdPipelineBarrier2 = (PFN_vkCmdPipelineBarrier2)vkGetDeviceProcAddr(device, sync2Extension ? "vkCmdPipelineBarrier2KHR" : "vkCmdPipelineBarrier2");
+			synchronization2 = cmdPipelineBarrier2 != nullptr;
+		}
+		if (timelineSemaphore)
+		{
+			waitSemaphores = (PFN_vkWaitSemaphores)vkGetDeviceProcAddr(device, timelineExtension ? "vkWaitSemaphoresKHR" : "vkWaitSemaphores");
+			signalSemaphore = (PFN_vkSignalSemaphore)vkGetDeviceProcAddr(device, timelineExtension ? "vkSignalSemaphoreKHR" : "vkSignalSemaphore");
+			timelineSemaphore = waitSemaphores != nullptr && signalSemaphore != nullptr;
+		}
+		if (drawIndirectCount)
+		{
+			cmdDrawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCount)vkGetDeviceProcAddr(device, "vkCmdDrawIndexedIndirectCountKHR");
+			drawIndirectCount = cmdDrawIndexedIndirectCount != nullptr;
+		}
+	}
+
+	void print() const
+	{
+		printf("device features: api %u.%u, dynamicRendering=%d synchronization2=%d timelineSemaphore=%d bufferDeviceAddress=%d descriptorIndexing=%d\n",
+			apiVersion >> 22, (apiVersion >> 12) & 0x3FF, dynamicRendering, synchronization2, timelineSemaphore, bufferDeviceAddress, descriptorIndexing);
+		printf("device features: multiDrawIndirect=%d drawIndirectFirstInstance=%d drawIndirectCount=%d\n",
+			multiDrawIndirect, drawIndirectFirstInstance, drawIndirectCount);
+	}
+
+private:
+	static uint32_t withoutPatch(uint32_t version)
+	{
+		return version & ~0xFFFu;
+	}
+
+	//ҪĽṹ㲢headָͷ
+	void resetChain(bool timeline, bool address, bool indexing, bool sync2, bool rendering)
+	{
+		head = nullptr;
+		auto link = [this](auto& features, VkStructureType type, bool used) {
+			features = {};
+			features.sType = type;
+			if (!used)
+				return;
+			features.pNext = head;
+			head = &features;
+		};
+		link(timelineFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES, timeline);
+		link(addressFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES, address);
+		link(indexingFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES, indexing);
+		link(sync2Features, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES, sync2);
+		link(renderingFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES, rendering);
+	}
+
+	bool timelineExtension = false;
+	bool addressExtension = false;
+	bool indexingExtension = false;
+	bool sync2Extension = false;
+	bool renderingExtension = false;
+
+	void* head = nullptr;
+	VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+	VkPhysicalDeviceBufferDeviceAddressFeatures addressFeatures{};
+	VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+	VkPhysicalDeviceSynchronization2Features sync2Features{};
+	VkPhysicalDeviceDynamicRenderingFeatures renderingFeatures{};
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include<chrono>
+#include<thread>
+#include<vector>
+#include<algorithm>
+#include<cmath>
+#include<cstdio>
+
+//֡ģʽ
+enum class PacingMode
+{
+	Uncapped,	//֡Ⱦ
+	TargetFps,	//Ŀ֡ʣ˯ٶ
+	Vsync,		//FIFOģʽֱͬ
+	Idle,		//СʧȥʱglfwWaitEventsTimeoutȴ¼
+};
+
+inline const char* pacingModeName(PacingMode mode)
+{
+	switch (mode)
+	{
+	case PacingMode::Uncapped:  return "uncapped";
+	case PacingMode::TargetFps: return "fps";
+	case PacingMode::Vsync:     return "vsync";
+	case PacingMode::Idle:      return "idle";
+	}
+	return "unknown";
+}
+
+//֡ͳƣÿģʽ¼
+struct JitterStats
+{
+	std::vector<double> intervalsMs;
+
+	void add(double ms)
+	{
+		//ֻһʱһֱ
+		if (intervalsMs.size() >= maxSamples)
+			intervalsMs.erase(intervalsMs.begin(), intervalsMs.begin() + maxSamples / 2);
+		intervalsMs.push_back(ms);
+	}
+
+	void print(const char* label) const
+	{
+		if (intervalsMs.empty())
+			return;
+
+		double mean = 0.0;
+		for (double ms : intervalsMs)
+			mean += ms;
+		mean /= intervalsMs.size();
+
+		double variance = 0.0;
+		for (double ms : intervalsMs)
+			variance += (ms - mean) * (ms - mean);
+		double stddev = std::sqrt(variance / intervalsMs.size());
+
+		std::vector<double> sorted = intervalsMs;
+		std::sort(sorted.begin(), sorted.end());
+		double p50 = sorted[sorted.size() / 2];
+		double p99 = sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)];
+
+		printf("pacing %s: %zu frames, interval mean %.3f ms, stddev %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+			label, sorted.size(), mean, stddev, p50, p99, sorted.back());
+	}
+
+	static constexpr size_t maxSamples = 100000;
+};
+
+//֡ƣĿ֡ģʽ¸ȵһ֡Ŀʼʱ
+class FramePacer
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	void setTargetFps(double fps)
+	{
+		framePeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(fps, 1.0)));
+	}
+
+	//Ŀ֡ģʽ˯ֹʱǰһ㣬ʣµ룬˯Զ
+	void waitForNextFrame()
+	{
+		if (nextFrame == Clock::time_point{})
+			nextFrame = Clock::now();
+		nextFrame += framePeriod;
+
+		auto now = Clock::now();
+		//󳬹һ֡Ͳ׷ˣ¿ʼʱ
+		if (now > nextFrame + framePeriod)
+		{
+			nextFrame = now;
+			return;
+		}
+
+		auto sleepUntil = nextFrame - spinMargin;
+		if (sleepUntil > now)
+		{
+			std::this_thread::sleep_until(sleepUntil);
+
+			//¼˯ͷʱ䣬ȡ1.50.2~4
+			auto overshoot = Clock::now() - sleepUntil;
+			auto target = overshoot + overshoot / 2;
+			spinMargin = std::clamp<Clock::duration>((spinMargin * 7 + target) / 8,
+				std::chrono::microseconds(200), std::chrono::milliseconds(4));
+		}
+
+		while (Clock::now() < nextFrame)
+			std::this_thread::yield();
+	}
+
+	//ÿ֡ʼʱãģʽ¼֡
+	void recordFrame(PacingMode mode)
+	{
+		auto now = Clock::now();
+		if (lastFrame != Clock::time_point{} && mode == lastMode)
+			stats[static_cast<size_t>(mode)].add(std::chrono::duration<double, std::milli>(now - lastFrame).count());
+		lastFrame = now;
+		lastMode = mode;
+	}
+
+	//ģʽл󣨱ӿлָ¿ʼʱ
+	void reset()
+	{
+		nextFrame = Clock::time_point{};
+		lastFrame = Clock::time_point{};
+	}
+
+	void printStats() const
+	{
+		for (size_t i = 0; i < modeCount; i++)
+			stats[i].print(pacingModeName(static_cast<PacingMode>(i)));
+	}
+
+private:
+	static constexpr size_t modeCount = 4;
+
+	Clock::duration framePeriod = std::chrono::microseconds(16667);
+	Clock::duration spinMargin = std::chrono::milliseconds(2);
+	Clock::time_point nextFrame{};
+	Clock::time_point lastFrame{};
+	PacingMode lastMode = PacingMode::Uncapped;
+	JitterStats stats[modeCount];
+};
@@ -0,0 +1,586 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDispatch.h"
+#include "MemoryAllocator.h"
+#include "StagingRing.h"
+#include "SceneStore.h"
+#include "ShaderManager.h"
+
+#include<vector>
+#include<string>
+#include<cmath>
+#include<stdexcept>
+#include<cstdio>
+#include<cstring>
+#include<algorithm>
+
+//GPUȾİΧɫڴ洢ɫ׶޳
+//ѿɼѹVkDrawIndexedIndirectCommandͼζһӻƻꡣ
+//CpuģʽǶ飺CPUSceneStoreSIMDںͬ׶ԣÿɼ¼һvkCmdDrawIndexed
+enum class CullingMode
+{
+	Cpu,
+	Gpu,			//յб+vkCmdDrawIndexedIndirectCount
+	GpuNoCount,		//ÿ̶һ޳instanceCountΪ0vkCmdDrawIndexedIndirect
+};
+
+inline const char* cullingModeName(CullingMode mode)
+{
+	switch (mode)
+	{
+	case CullingMode::Cpu: return "cpu";
+	case CullingMode::Gpu: return "gpu";
+	case CullingMode::GpuNoCount: return "gpu-nocount";
+	}
+	return "unknown";
+}
+
+inline bool parseCullingMode(const std::string& name, CullingMode& mode)
+{
+	if (name == "cpu")
+		mode = CullingMode::Cpu;
+	else if (name == "gpu")
+		mode = CullingMode::Gpu;
+	else if (name == "gpu-nocount")
+		mode = CullingMode::GpuNoCount;
+	else
+		return false;
+	return true;
+}
+
+//shaders/cull.compobject.vertObjectһ
+struct GpuObject
+{
+	float center[3];
+	float halfSize;		//İ߳
+	float color[4];
+};
+
+class GpuDrivenScene
+{
+public:
+	//豸ԼӻƵ֧DeviceFeatures豸
+	struct Capabilities
+	{
+		bool drawIndirectFirstInstance = false;		//firstInstance
+		uint32_t maxDrawIndirectCount = 1;			//ûmultiDrawIndirectʱΪ1
+		PFN_vkCmdDrawIndexedIndirectCount cmdDrawIndexedIndirectCount = nullptr;	//ûVK_KHR_draw_indirect_countʱΪ
+	};
+
+	//renderPassΪʱ̬ȾͼιߣcolorFormatɫĸʽ
+	void init(VkDevice device, const VulkanDispatch& dispatch, MemoryAllocator& allocator, StagingRing& stagingRing, VkPipelineCache pipelineCache,
+		ShaderManager& shaders, VkRenderPass renderPass, VkFormat colorFormat, const Capabilities& capabilities, uint32_t objectCount)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+		this->allocator = &allocator;
+		this->shaders = &shaders;
+		this->pipelineCache = pipelineCache;
+		this->renderPass = renderPass;
+		this->colorFormat = colorFormat;
+		this->capabilities = capabilities;
+		count = objectCount;
+
+		createDescriptors();
+		if (createCullPipeline(cullPipeline) != VK_SUCCESS || createDrawPipeline(drawPipeline) != VK_SUCCESS)
+			throw std::runtime_error("failed to create gpu scene pipelines!");
+		//أcull.compֻؽ޳ߣobject.*ֻؽƹ
+		cullDependent = shaders.addDependent({ "cull.comp" },
+			[this] { return rebuildPipeline(&GpuDrivenScene::createCullPipeline, pendingCullPipeline); },
+			[this] { swapPipeline(cullPipeline, pendingCullPipeline); });
+		drawDependent = shaders.addDependent({ "object.vert", "object.frag" },
+			[this] { return rebuildPipeline(&GpuDrivenScene::createDrawPipeline, pendingDrawPipeline); },
+			[this] { swapPipeline(drawPipeline, pendingDrawPipeline); });
+		createBuffers(stagingRing);
+		updateDescriptors();
+		setMode(mode);
+	}
+
+	bool active() const { return device != VK_NULL_HANDLE; }
+	uint32_t objectCount() const { return count; }
+	CullingMode currentMode() const { return mode; }
+	void setCullKernel(CullKernel kernel) { cullKernel = kernel; }
+
+	//豸֧ʱˣûfirstInstanceֻCPUûмƾͻÿ
+	void setMode(CullingMode requested)
+	{
+		mode = requested;
+		if (mode != CullingMode::Cpu && !capabilities.drawIndirectFirstInstance)
+			mode = CullingMode::Cpu;
+		else if (mode == CullingMode::Gpu &&
+			(capabilities.cmdDrawIndexedIndirectCount == nullptr || capabilities.maxDrawIndirectCount < count))
+			mode = CullingMode::GpuNoCount;
+	}
+
+	//ԭ㿴-zɢΧ󲿷׶
+	void setCamera(float aspect)
+	{
+		cameraMatrix(count, aspect, viewProj);
+		frustum = Frustum::fromMatrix(viewProj);
+	}
+
+	//޳ѹ¼Ⱦ֮⣻CpuģʽʲôҲ
+	void recordCull(VkCommandBuffer commandBuffer)
+	{
+		if (!active() || mode == CullingMode::Cpu)
+			return;
+
+		//ֻһݣһ֡ļӻƶԺд
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		dispatch->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		bool compact = mode == CullingMode::Gpu;
+		if (compact)
+		{
+			dispatch->vkCmdFillBuffer(commandBuffer, countBuffer, 0, sizeof(uint32_t), 0);
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			dispatch->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+				1, &barrier, 0, nullptr, 0, nullptr);
+		}
+
+		CullPushConstants constants{};
+		memcpy(constants.planes, frustum.planes, sizeof(constants.planes));
+		constants.objectCount = count;
+		constants.compact = compact ? 1 : 0;
+		constants.indexCount = static_cast<uint32_t>(cubeIndices().size());
+
+		dispatch->vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline);
+		dispatch->vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullLayout, 0, 1, &descriptorSet, 0, nullptr);
+		dispatch->vkCmdPushConstants(commandBuffer, cullLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+		dispatch->vkCmdDispatch(commandBuffer, (count + cullGroupSize - 1) / cullGroupSize, 1, 1);
+
+		//ɫдͼӻƶ
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+		dispatch->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+			1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	//ƣ¼Ⱦ
+	void recordDraw(VkCommandBuffer commandBuffer, VkExtent2D extent)
+	{
+		if (!active())
+			return;
+
+		VkViewport viewport{ 0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f };
+		VkRect2D scissor{ { 0, 0 }, extent };
+		VkDeviceSize vertexOffset = 0;
+
+		dispatch->vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, drawPipeline);
+		dispatch->vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+		dispatch->vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+		dispatch->vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, drawLayout, 0, 1, &descriptorSet, 0, nullptr);
+		dispatch->vkCmdPushConstants(commandBuffer, drawLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(viewProj), viewProj);
+		dispatch->vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &vertexOffset);
+		dispatch->vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+
+		const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+		switch (mode)
+		{
+		case CullingMode::Cpu:
+		{
+			//޳ɼбٰб¼ƣfirstInstanceţͼһ
+			uint32_t visible = store.cull(frustum, cullKernel);
+			const uint32_t* indices = store.visibleIndices();
+			for (uint32_t i = 0; i < visible; i++)
+			{
+				uint32_t object = indices[i];
+				dispatch->vkCmdDrawIndexed(commandBuffer, store.indexCount[object], 1, store.firstIndex[object], 0, object);
+			}
+			break;
+		}
+		case CullingMode::Gpu:
+			capabilities.cmdDrawIndexedIndirectCount(commandBuffer, drawBuffer, 0, countBuffer, 0, count, stride);
+			break;
+		case CullingMode::GpuNoCount:
+			//һmaxDrawIndirectCountƣûmultiDrawIndirectʱÿֻܻһ
+			for (uint32_t first = 0; first < count; first += capabilities.maxDrawIndirectCount)
+			{
+				uint32_t batch = std::min(capabilities.maxDrawIndirectCount, count - first);
+				dispatch->vkCmdDrawIndexedIndirect(commandBuffer, drawBuffer, static_cast<VkDeviceSize>(first) * stride, batch, stride);
+			}
+			break;
+		}
+	}
+
+	void destroy()
+	{
+		if (device == VK_NULL_HANDLE)
+			return;
+
+		shaders->removeDependent(cullDependent);
+		shaders->removeDependent(drawDependent);
+		VkPipeline* pipelines[] = { &cullPipeline, &drawPipeline, &pendingCullPipeline, &pendingDrawPipeline };
+		for (VkPipeline* pipeline : pipelines)
+		{
+			dispatch->vkDestroyPipeline(device, *pipeline, nullptr);
+			*pipeline = VK_NULL_HANDLE;
+		}
+		dispatch->vkDestroyPipelineLayout(device, cullLayout, nullptr);
+		dispatch->vkDestroyPipelineLayout(device, drawLayout, nullptr);
+		dispatch->vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+		dispatch->vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+
+		VkBuffer* buffers[] = { &objectBuffer, &drawBuffer, &countBuffer, &vertexBuffer, &indexBuffer };
+		Allocation* allocations[] = { &objectAllocation, &drawAllocation, &countAllocation, &vertexAllocation, &indexAllocation };
+		for (size_t i = 0; i < 5; i++)
+		{
+			dispatch->vkDestroyBuffer(device, *buffers[i], nullptr);
+			allocator->free(*allocations[i]);
+			*buffers[i] = VK_NULL_HANDLE;
+		}
+		store = SceneStore{};
+		device = VK_NULL_HANDLE;
+	}
+
+	void printStats() const
+	{
+		if (!active())
+			return;
+		printf("gpu scene: %u objects, culling %s, %.1f MB object/draw buffers", count, cullingModeName(mode),
+			count * (sizeof(GpuObject) + sizeof(VkDrawIndexedIndirectCommand)) / (1024.0 * 1024.0));
+		if (mode == CullingMode::Cpu)
+			printf(", %s kernel, %u visible last frame", cullKernelName(cullKernel), store.visibleSize());
+		printf("\n");
+	}
+
+	//ɢķΧŴܶȲ仯
+	static float sceneExtent(uint32_t objectCount)
+	{
+		return 4.0f * std::cbrt(static_cast<float>(std::max(objectCount, 1u)));
+	}
+
+	//ԭ㿴-zɢΧ󲿷׶⣻
+	static void cameraMatrix(uint32_t objectCount, float aspect, float viewProj[16])
+	{
+		float nearPlane = 0.1f;
+		float farPlane = sceneExtent(objectCount) * 1.75f;
+		float f = 1.0f / std::tan(0.5f * 1.0471976f);	//60ȴֱӽ
+
+		//VulkanĲüռy¡z01
+		std::fill(viewProj, viewProj + 16, 0.0f);
+		viewProj[0] = f / aspect;
+		viewProj[5] = -f;
+		viewProj[10] = farPlane / (nearPlane - farPlane);
+		viewProj[11] = -1.0f;
+		viewProj[14] = nearPlane * farPlane / (nearPlane - farPlane);
+	}
+
+	//̶ɣÿͬĳCPU޳SoAstoregpuObjectsϴɫĲ
+	static void generateObjects(uint32_t count, SceneStore& store, std::vector<GpuObject>& gpuObjects)
+	{
+		uint32_t seed = 54321;
+		auto next = [&seed]() {
+			seed = seed * 1664525u + 1013904223u;
+			return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+		};
+		float extent = sceneExtent(count);
+		uint32_t indexCount = static_cast<uint32_t>(cubeIndices().size());
+		store.clear();
+		store.reserve(count);
+		gpuObjects.resize(count);
+		for (auto& object : gpuObjects)
+		{
+			for (float& c : object.center)
+				c = (next() * 2.0f - 1.0f) * extent;
+			object.halfSize = 0.2f + 0.4f * next();
+			object.color[0] = 0.2f + 0.8f * next();
+			object.color[1] = 0.2f + 0.8f * next();
+			object.color[2] = 0.2f + 0.8f * next();
+			object.color[3] = 1.0f;
+
+			//򣬺cull.compһ
+			store.add({ { object.center[0], object.center[1], object.center[2] }, object.halfSize, 1.7320508f, 0, indexCount });
+		}
+	}
+
+private:
+	static constexpr uint32_t cullGroupSize = 64;	//cull.complocal_size_xһ
+
+	struct CullPushConstants
+	{
+		float planes[6][4];
+		uint32_t objectCount;
+		uint32_t compact;
+		uint32_t indexCount;
+	};
+
+	//߳Ϊ2壬ɫٰhalfSize
+	static const std::vector<float>& cubeVertices()
+	{
+		static const std::vector<float> vertices = {
+			-1, -1, -1,  1, -1, -1,  1,  1, -1, -1,  1, -1,
+			-1, -1,  1,  1, -1,  1,  1,  1,  1, -1,  1,  1,
+		};
+		return vertices;
+	}
+
+	static const std::vector<uint16_t>& cubeIndices()
+	{
+		static const std::vector<uint16_t> indices = {
+			0, 1, 2, 2, 3, 0,  4, 6, 5, 6, 4, 7,
+			0, 3, 7, 7, 4, 0,  1, 5, 6, 6, 2, 1,
+			0, 4, 5, 5, 1, 0,  3, 2, 6, 6, 7, 3,
+		};
+		return indices;
+	}
+
+	//洢壺塢建嶥ɫҲҪ
+	void createDescriptors()
+	{
+		VkDescriptorSetLayoutBinding bindings[3]{};
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+		bindings[0].stageFlags |= VK_SHADER_STAGE_VERTEX_BIT;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = 3;
+		layoutInfo.pBindings = bindings;
+		if (dispatch->vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
+			throw std::runtime_error("failed to create gpu scene descriptor set layout!");
+
+		VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 };
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.maxSets = 1;
+		poolInfo.poolSizeCount = 1;
+		poolInfo.pPoolSizes = &poolSize;
+		if (dispatch->vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
+			throw std::runtime_error("failed to create gpu scene descriptor pool!");
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = descriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &descriptorSetLayout;
+		if (dispatch->vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet) != VK_SUCCESS)
+			throw std::runtime_error("failed to allocate gpu scene descriptor set!");
+
+		//ֹ߲ͬһ֣ͳø
+		VkPushConstantRange cullRange{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullPushConstants) };
+		VkPushConstantRange drawRange{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(viewProj) };
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &cullRange;
+		if (dispatch->vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &cullLayout) != VK_SUCCESS)
+			throw std::runtime_error("failed to create cull pipeline layout!");
+		pipelineLayoutInfo.pPushConstantRanges = &drawRange;
+		if (dispatch->vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &drawLayout) != VK_SUCCESS)
+			throw std::runtime_error("failed to create gpu scene pipeline layout!");
+	}
+
+	//ģShaderManagerУ߲٣ʱں̵̨߳
+	VkResult createCullPipeline(VkPipeline& pipeline)
+	{
+		VkComputePipelineCreateInfo computeInfo{};
+		computeInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		computeInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		computeInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		computeInfo.stage.module = shaders->get("cull.comp");
+		computeInfo.stage.pName = "main";
+		computeInfo.layout = cullLayout;
+		return dispatch->vkCreateComputePipelines(device, pipelineCache, 1, &computeInfo, nullptr, &pipeline);
+	}
+
+	VkResult createDrawPipeline(VkPipeline& pipeline)
+	{
+		VkPipelineShaderStageCreateInfo stages[2]{};
+		stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+		stages[0].module = shaders->get("object.vert");
+		stages[0].pName = "main";
+		stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+		stages[1].module = shaders->get("object.frag");
+		stages[1].pName = "main";
+
+		VkVertexInputBindingDescription binding{ 0, 3 * sizeof(float), VK_VERTEX_INPUT_RATE_VERTEX };
+		VkVertexInputAttributeDescription attribute{ 0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0 };
+		VkPipelineVertexInputStateCreateInfo vertexInput{};
+		vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		vertexInput.vertexBindingDescriptionCount = 1;
+		vertexInput.pVertexBindingDescriptions = &binding;
+		vertexInput.vertexAttributeDescriptionCount = 1;
+		vertexInput.pVertexAttributeDescriptions = &attribute;
+
+		VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+		inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+		VkPipelineViewportStateCreateInfo viewportState{};
+		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewportState.viewportCount = 1;
+		viewportState.scissorCount = 1;
+
+		//ûȻ壬޳忿
+		VkPipelineRasterizationStateCreateInfo rasterizer{};
+		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+		rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+		rasterizer.cullMode = VK_CULL_MODE_NONE;
+		rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+		rasterizer.lineWidth = 1.0f;
+
+		VkPipelineMultisampleStateCreateInfo multisampling{};
+		multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+		multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+		VkPipelineColorBlendAttachmentState blendAttachment{};
+		blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		VkPipelineColorBlendStateCreateInfo colorBlending{};
+		colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		colorBlending.attachmentCount = 1;
+		colorBlending.pAttachments = &blendAttachment;
+
+		VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+		VkPipelineDynamicStateCreateInfo dynamicState{};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = 2;
+		dynamicState.pDynamicStates = dynamicStates;
+
+		//̬ȾʱûȾ̣ʽ
+		VkPipelineRenderingCreateInfo renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+		renderingInfo.colorAttachmentCount = 1;
+		renderingInfo.pColorAttachmentFormats = &colorFormat;
+
+		VkGraphicsPipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.pNext = renderPass == VK_NULL_HANDLE ? &renderingInfo : nullptr;
+		pipelineInfo.stageCount = 2;
+		pipelineInfo.pStages = stages;
+		pipelineInfo.pVertexInputState = &vertexInput;
+		pipelineInfo.pInputAssemblyState = &inputAssembly;
+		pipelineInfo.pViewportState = &viewportState;
+		pipelineInfo.pRasterizationState = &rasterizer;
+		pipelineInfo.pMultisampleState = &multisampling;
+		pipelineInfo.pColorBlendState = &colorBlending;
+		pipelineInfo.pDynamicState = &dynamicState;
+		pipelineInfo.layout = drawLayout;
+		pipelineInfo.renderPass = renderPass;
+		pipelineInfo.subpass = 0;
+		return dispatch->vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
+	}
+
+	//̨̣߳õ¹ȷpendingһεĻûϾͱµĴ
+	bool rebuildPipeline(VkResult (GpuDrivenScene::*create)(VkPipeline&), VkPipeline& pending)
+	{
+		if (pending != VK_NULL_HANDLE)
+			dispatch->vkDestroyPipeline(device, pending, nullptr);
+		pending = VK_NULL_HANDLE;
+		return (this->*create)(pending) == VK_SUCCESS;
+	}
+
+	//֮߳֡ãɹ߿ܻڷ֡ţShaderManagerӺ
+	void swapPipeline(VkPipeline& current, VkPipeline& pending)
+	{
+		VkDevice device = this->device;
+		PFN_vkDestroyPipeline destroyPipeline = dispatch->vkDestroyPipeline;
+		VkPipeline old = current;
+		shaders->retire([device, destroyPipeline, old] { destroyPipeline(device, old, nullptr); });
+		current = pending;
+		pending = VK_NULL_HANDLE;
+	}
+
+	//ݴ滷ϴȴٷأͼζһ֡¼ʱȡȨ
+	void createBuffers(StagingRing& stagingRing)
+	{
+		std::vector<GpuObject> objects;
+		generateObjects(count, store, objects);
+		const auto& vertices = cubeVertices();
+		const auto& indices = cubeIndices();
+
+		VkDeviceSize objectSize = static_cast<VkDeviceSize>(count) * sizeof(GpuObject);
+		VkDeviceSize drawSize = static_cast<VkDeviceSize>(count) * sizeof(VkDrawIndexedIndirectCommand);
+		allocator->createBuffer(objectSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, objectBuffer, objectAllocation);
+		allocator->createBuffer(drawSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, drawBuffer, drawAllocation);
+		allocator->createBuffer(sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, countBuffer, countAllocation);
+		allocator->createBuffer(vertices.size() * sizeof(float), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer, vertexAllocation);
+		allocator->createBuffer(indices.size() * sizeof(uint16_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer, indexAllocation);
+
+		stagingRing.uploadBuffer(objectBuffer, 0, objects.data(), objectSize);
+		stagingRing.uploadBuffer(vertexBuffer, 0, vertices.data(), vertices.size() * sizeof(float));
+		stagingRing.uploadBuffer(indexBuffer, 0, indices.data(), indices.size() * sizeof(uint16_t));
+		stagingRing.waitIdle();
+	}
+
+	void updateDescriptors()
+	{
+		VkDescriptorBufferInfo bufferInfos[3] = {
+			{ objectBuffer, 0, VK_WHOLE_SIZE },
+			{ drawBuffer, 0, VK_WHOLE_SIZE },
+			{ countBuffer, 0, VK_WHOLE_SIZE },
+		};
+		VkWriteDescriptorSet writes[3]{};
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = descriptorSet;
+			writes[i].dstBinding = i;
+			writes[i].descriptorCount = 1;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[i].pBufferInfo = &bufferInfos[i];
+		}
+		dispatch->vkUpdateDescriptorSets(device, 3, writes, 0, nullptr);
+	}
+
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;		//¼ƺʹ豸ַ
+	MemoryAllocator* allocator = nullptr;
+	Capabilities capabilities;
+	CullingMode mode = CullingMode::Gpu;
+	uint32_t count = 0;
+	CullKernel cullKernel = bestCullKernel();
+
+	SceneStore store;						//CPU޳õSoA
+	float viewProj[16] = {};				//
+	Frustum frustum{};
+
+	VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+	VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+	VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+	VkPipelineLayout cullLayout = VK_NULL_HANDLE;
+	VkPipelineLayout drawLayout = VK_NULL_HANDLE;
+	VkPipeline cullPipeline = VK_NULL_HANDLE;
+	VkPipeline drawPipeline = VK_NULL_HANDLE;
+
+	ShaderManager* shaders = nullptr;
+	VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+	VkRenderPass renderPass = VK_NULL_HANDLE;		//ΪʱǶ̬Ⱦ
+	VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+	uint32_t cullDependent = 0;						//ShaderManagerǼǵı
+	uint32_t drawDependent = 0;
+	VkPipeline pendingCullPipeline = VK_NULL_HANDLE;	//ں̨áûϵĹ
+	VkPipeline pendingDrawPipeline = VK_NULL_HANDLE;
+
+	VkBuffer objectBuffer = VK_NULL_HANDLE;
+	VkBuffer drawBuffer = VK_NULL_HANDLE;
+	VkBuffer countBuffer = VK_NULL_HANDLE;
+	VkBuffer vertexBuffer = VK_NULL_HANDLE;
+	VkBuffer indexBuffer = VK_NULL_HANDLE;
+	Allocation objectAllocation;
+	Allocation drawAllocation;
+	Allocation countAllocation;
+	Allocation vertexAllocation;
+	Allocation indexAllocation;
+};
@@ -0,0 +1,2958 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include<iostream>
+#include<stdexcept>
+#include<cstdlib>
+#include<vector>
+#include<string.h>
+#include<optional>
+#include<string>
+#include<algorithm>
+#include<map>
+#include<chrono>
+#include<cstdio>
+#include<fstream>
+#include<filesystem>
+
+#include "FramePacer.h"
+#include "PipelineCache.h"
+#include "MemoryAllocator.h"
+#include "StagingRing.h"
+#include "JobSystem.h"
+#include "CommandRecorder.h"
+#include "Profiler.h"
+#include "StartupTimer.h"
+#include "DebugLog.h"
+#include "ValidationProfile.h"
+#include "DeviceFeatures.h"
+#include "BindlessRegistry.h"
+#include "VulkanDispatch.h"
+#include "HostAllocator.h"
+#include "BenchmarkReport.h"
+#include "RegressionTest.h"
+#include "GpuDrivenScene.h"
+#include "MeshImport.h"
+#include "RenderGraph.h"
+#include "TimelineScheduler.h"
+
+const uint32_t WIDTH = 800;
+const uint32_t HEIGHT = 600;
+
+//б׼֤㶼VK_LAYER_KHRONOS_validation
+const std::vector<const char*> validationLayers = {
+	"VK_LAYER_KHRONOS_validation"
+};
+
+
+//ãв
+struct AppConfig
+{
+	bool headless = false;		//޴ģʽʼGLFWlavapipeʵ
+	std::string deviceOverride;	//ƣӴUUIDָ豸Ϊѡ
+	uint32_t framesInFlight = 2;	//CPUGPU֡
+	uint32_t frameCount = 300;		//޴ģʽȾ֡
+	PacingMode pacing = PacingMode::Vsync;	//֡ģʽ
+	double targetFps = 60.0;		//TargetFpsģʽĿ֡
+	bool idleThrottle = true;		//Сʧȥʱ֡
+	double idleFps = 4.0;			//ʧȥʱ֡ʣСʱȾ
+	std::string pipelineCachePath = "pipeline_cache.bin";	//߻ļΪ򲻶д
+	uint32_t stagingRingMB = 32;	//ϴõݴ滷λС
+	uint32_t uploadBenchMB = 0;		//ϴ²ԣ0ʾ
+	uint32_t recordThreads = 0;		//¼̣߳߳0ʾCPU
+	uint32_t drawCount = 0;			//Ļ0ʱö߳¼ƶ
+	bool recordBench = false;		//ܶ߳¼ƵչԲ
+	std::string tracePath;			//˳ʱܷ¼дChrome traceΪд
+	std::string startupReportPath;	//ʱ棨JSONдļΪֻӡ
+	uint32_t startupBenchRuns = 0;	//0ʱֻʼ/ͳʱķֲ
+	bool printStats = true;			//˳ʱӡģͳƣѡ豸ʱӡ豸б
+	std::string debugLogPath;		//֤ϢдļΪд̨
+	VkDebugUtilsMessageSeverityFlagsEXT debugSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;	//ĵϢ
+	uint32_t debugRepeatLimit = 1;	//ͬһmessageIdNumberΣֻ֮
+	ValidationProfile validation = defaultValidationProfile();	//֤λڻ
+	bool validationBench = false;	//ÿ֤λһ飬Ƚϳʼÿ֡Ŀ
+	bool hostAllocator = true;		//ʵ豸ȶڴԼķصͳƺͲй©
+	bool dispatchBench = false;		//ȱȽϼͷַĵÿ
+	std::string regressionScene;	//عԵĳǿʱȾ̶֡һ֡ͼÿ֡ʱ
+	std::string goldenPath;			//׼ͼΪʱgolden/<>.ppm
+	bool updateGolden = false;		//ȾĽдµĽ׼Ƚ
+	uint32_t imageTolerance = 2;	//ͽ׼ȽʱÿͨĲֵ
+	double cpuBudgetMs = 0.0;		//ǳÿ֡CPUʱԤ㣬0ʾóԴ
+	double gpuBudgetMs = 0.0;		//ǳÿ֡GPUʱԤ
+	uint32_t maxApiVersion = VK_API_VERSION_1_3;	//ʹõVulkan汾ͿԲ豸Ļ·
+	uint32_t objectCount = 0;		//GPU0ʾܺ--drawsһ
+	CullingMode culling = CullingMode::Gpu;	//GPU޳ͻƷʽ
+	bool cullingBench = false;		//ȱȽCPUƺGPU޳+ӻ
+	std::string shaderDir = "shaders";	//ʱõSPIR-VĿ¼ûԴʧʱ
+	std::string shaderSourceDir = VULKAN_01_SHADER_SOURCE_DIR;	//GLSLԴĿ¼ʱ벢
+	std::string shaderCacheDir = "shader_cache";	//ݹϣűõSPIR-V
+	std::string shaderCompiler = VULKAN_01_GLSLC;	//ʱõglslc
+	bool shaderHotReload = false;	//ԴĿ¼Ķں̨ؽӰĹ
+	CullKernel cullKernel = bestCullKernel();	//CPU޳SIMDںˣĬϰCPUֵָ֧ѡ
+	bool cullKernelBench = false;	//ȱȽϸ޳ںÿÿ봦
+	std::string meshPath;			//ʱص.vkmeshVulkan_01_meshconvɣΪ򲻼
+	bool meshBench = false;			//ȱȽϽOBJӳ.vkmeshļʱ
+	bool renderGraph = false;		//Ⱦͼ¼ÿ֡⽵ϳɽͼ
+	bool renderGraphBench = false;	//ȲʾȾͼʱʱԴ
+	bool schedulerBench = false;	//ȱȽύ+ȶпкʱߵͬһCPU/GPUͼ
+	std::string schedulerTracePath;	//ԵĶصдChrome traceΪд
+};
+
+//豸ϸҪ豸suitableΪfalse
+struct DeviceScore
+{
+	bool suitable = false;
+	uint32_t typeScore = 0;		//豸
+	uint32_t memoryScore = 0;	//豸ԴС
+	uint32_t queueScore = 0;	//ļ/
+	uint32_t limitScore = 0;	//Ӳ
+	uint32_t featureScore = 0;	//֧ް
+
+	uint32_t total() const
+	{
+		return typeScore + memoryScore + queueScore + limitScore + featureScore;
+	}
+};
+
+//豸Ķнṹ
+struct QueueFamilyIndices
+{
+	std::optional<uint32_t> graphicsFamily;
+	std::optional<uint32_t> computeFamily;		//ֻм㹦ܵĶ壬ûоͺͼι
+	std::optional<uint32_t> transferFamily;		//ֻд书ܵĶ壬ûоüͼζ
+	std::optional<uint32_t> presentFamily;		//ֵĶ壬ȾʱΪ
+
+	bool isComplete()
+	{
+		return graphicsFamily.has_value();
+	}
+};
+
+//ֵ֧Ϣ
+struct SwapChainSupportDetails
+{
+	VkSurfaceCapabilitiesKHR capabilities;
+	std::vector<VkSurfaceFormatKHR> formats;
+	std::vector<VkPresentModeKHR> presentModes;
+};
+
+//ÿһ֡ԴCPU¼ƵN+1֡ʱGPUԻִеN֡
+struct FrameData
+{
+	VkCommandPool commandPool = VK_NULL_HANDLE;
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	VkSemaphore imageAvailableSemaphore = VK_NULL_HANDLE;
+	VkFence inFlightFence = VK_NULL_HANDLE;
+};
+
+//һʱһδ棬֡0~1
+struct DrawItem
+{
+	float x, y, width, height;
+	float color[4];
+};
+
+//֡ʱͳƣCPUȴդʱռȸ˵ƿGPU֮CPU
+struct FrameStats
+{
+	uint64_t frames = 0;
+	double frameMs = 0.0;		//֡ʼ֮ʱ
+	double fenceWaitMs = 0.0;	//ȴդGPUϣʱ
+	double acquireWaitMs = 0.0;	//ȴͼֱܴͬƣʱ
+
+	void print(const char* label) const
+	{
+		if (frames == 0)
+			return;
+		double avgFrame = frameMs / frames;
+		double avgFence = fenceWaitMs / frames;
+		double avgAcquire = acquireWaitMs / frames;
+		printf("%s: %llu frames, frame %.3f ms, fence wait %.3f ms, acquire wait %.3f ms -> %s-bound\n",
+			label, static_cast<unsigned long long>(frames), avgFrame, avgFence, avgAcquire,
+			avgFence > avgFrame * 0.5 ? "GPU" : "CPU");
+	}
+};
+
+//VulkanĳʼȾѭ͸ԣ壨main.cppͻ׼Գbench.cpp
+class HelloTriangleApplication{
+public:
+	explicit HelloTriangleApplication(const AppConfig& config = AppConfig{})
+		: config(config), enableValidationLayers(config.validation != ValidationProfile::Off) {}
+
+	void run()
+	{
+		PROFILE_THREAD_NAME("main");
+		startupTimer.time("initWindow", [this] { initWindow(); });
+		initVulcan();
+		if (config.uploadBenchMB > 0)
+			runUploadBenchmark();
+		if (config.recordBench)
+			runRecordBenchmark();
+		if (config.dispatchBench)
+			runDispatchBenchmark();
+		if (config.cullKernelBench)
+			runCullKernelBenchmark();
+		if (config.meshBench)
+			runMeshBenchmark();
+		if (config.renderGraphBench)
+			runRenderGraphBenchmark();
+		if (config.schedulerBench)
+			runSchedulerBenchmark();
+		if (config.cullingBench)
+			runCullingBenchmark();
+		mainLoop();
+		bool regressionPassed = config.regressionScene.empty() || checkRegression();
+		startupTimer.time("cleanup", [this] { cleanup(); });
+		reportStartup();
+		if (!regressionPassed)
+			throw std::runtime_error("regression test '" + config.regressionScene + "' failed!");
+	}
+
+	//ãֻʼѭ
+	void runStartupCycle()
+	{
+		startupTimer.time("initWindow", [this] { initWindow(); });
+		initVulcan();
+		startupTimer.time("cleanup", [this] { cleanup(); });
+	}
+
+	const StartupTimer& getStartupTimer() const { return startupTimer; }
+
+	//ʼȾ̶֡棬ȽϲͬõĿ
+	void runFrameCycle()
+	{
+		startupTimer.time("initWindow", [this] { initWindow(); });
+		initVulcan();
+		mainLoop();
+		startupTimer.time("cleanup", [this] { cleanup(); });
+	}
+
+	const FrameStats& getTotalStats() const { return totalStats; }
+
+	//׼Գãϴ¼ƺ͵ÿԣȾ̶֡ӵreport
+	void runBenchmarkCycle(BenchmarkReport& report)
+	{
+		benchmarkReport = &report;
+		startupTimer.time("initWindow", [this] { initWindow(); });
+		initVulcan();
+		if (config.uploadBenchMB > 0)
+			runUploadBenchmark();
+		if (config.recordBench)
+			runRecordBenchmark();
+		if (config.dispatchBench)
+			runDispatchBenchmark();
+		if (config.cullKernelBench)
+			runCullKernelBenchmark();
+		if (config.meshBench)
+			runMeshBenchmark();
+		if (config.renderGraphBench)
+			runRenderGraphBenchmark();
+		if (config.schedulerBench)
+			runSchedulerBenchmark();
+		if (config.cullingBench)
+			runCullingBenchmark();
+		mainLoop();
+		startupTimer.time("cleanup", [this] { cleanup(); });
+		benchmarkReport = nullptr;
+	}
+
+	std::string getDeviceName() const { return deviceName; }
+
+private:
+	void initWindow()
+	{
+		//޴ģʽҪGLFW
+		if (config.headless)
+			return;
+
+		//ȳʼglfw
+		glfwInit();
+
+		//رOPGL
+		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+
+		//ôڲɵС
+		glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+
+		//
+		window = glfwCreateWindow(WIDTH,HEIGHT,"Vulkan",nullptr,nullptr);
+
+	}
+
+	void initVulcan() 
+	{
+		auto initStart = std::chrono::steady_clock::now();
+
+		//ʵ豸˳ֻдʱڴŽarena
+		//֮Ķؽarena黹ܷŽȥ
+		hostAllocator.init(config.hostAllocator);
+
+		startupTimer.time("createInstance", [this] { HostAllocator::ArenaScope arena(hostAllocator); createInstance(); });
+		startupTimer.time("setupDebugMessenger", [this] { setupDebugMessenger(); });
+		startupTimer.time("createSurface", [this] { createSurface(); });
+		startupTimer.time("pickPhysicalDevice", [this] { pickPhysicalDevice(); });
+		startupTimer.time("createLogicalDevice", [this] { HostAllocator::ArenaScope arena(hostAllocator); createLogicalDevice(); });
+		startupTimer.time("createAllocator", [this] { createAllocator(); });
+		startupTimer.time("createStagingRing", [this] { createStagingRing(); });
+		startupTimer.time("createPipelineCache", [this] { createPipelineCache(); });
+		startupTimer.time("createSwapChain", [this] { createSwapChain(); });
+		startupTimer.time("createImageViews", [this] { createImageViews(); });
+		startupTimer.time("createRenderPass", [this] { createRenderPass(); });
+		startupTimer.time("createFramebuffers", [this] { createFramebuffers(); });
+		startupTimer.time("createFrameResources", [this] { createFrameResources(); });
+		startupTimer.time("createCommandRecorder", [this] { createCommandRecorder(); });
+		startupTimer.time("createProfiler", [this] { createProfiler(); });
+		startupTimer.time("createFrameTimestamps", [this] { createFrameTimestamps(); });
+		startupTimer.time("createBindlessRegistry", [this] { createBindlessRegistry(); });
+		startupTimer.time("createShaderManager", [this] { createShaderManager(); });
+		startupTimer.time("createGpuScene", [this] { createGpuScene(); });
+		startupTimer.time("createMesh", [this] { createMesh(); });
+		startupTimer.time("createRenderGraph", [this] { createRenderGraph(); });
+
+		//߻УʱԱ
+		if (!config.printStats)
+			return;
+		double initMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - initStart).count();
+		printf("startup: initVulcan %.3f ms, pipeline cache %s (%zu bytes loaded)\n",
+			initMs, pipelineCache.isWarm() ? "warm" : "cold", pipelineCache.loadedSize());
+	}
+
+	void mainLoop()
+	{
+		pacer.setTargetFps(config.targetFps);
+
+		if (config.headless)
+		{
+			//޴ģʽûдϢȡȾ̶֡˳
+			for (uint32_t i = 0; i < config.frameCount; i++)
+			{
+				if (config.pacing == PacingMode::TargetFps)
+					pacer.waitForNextFrame();
+				pacer.recordFrame(config.pacing);
+				drawFrame();
+			}
+		}
+		else
+		{
+			while (!glfwWindowShouldClose(window))
+			{
+				//СʧȥʱģʽȴϢһֱѯ
+				bool minimized = glfwGetWindowAttrib(window, GLFW_ICONIFIED) != 0;
+				bool focused = glfwGetWindowAttrib(window, GLFW_FOCUSED) != 0;
+				if (config.idleThrottle && (minimized || !focused))
+				{
+					glfwWaitEventsTimeout(1.0 / config.idleFps);
+					if (minimized)
+					{
+						pacer.reset();
+						continue;
+					}
+					pacer.recordFrame(PacingMode::Idle);
+					drawFrame();
+					continue;
+				}
+
+				//ȡϢ
+				glfwPollEvents();
+				if (config.pacing == PacingMode::TargetFps)
+					pacer.waitForNextFrame();
+				pacer.recordFrame(config.pacing);
+				drawFrame();
+			}
+		}
+
+		//GPUй
+		dispatch.vkDeviceWaitIdle(device);
+		if (!config.printStats)
+			return;
+		totalStats.print("total");
+		pacer.printStats();
+
+		Profiler::instance().printSummary();
+		if (!config.tracePath.empty())
+		{
+			if (Profiler::instance().writeChromeTrace(config.tracePath))
+				printf("profiler: trace written to %s\n", config.tracePath.c_str());
+			else
+				printf("profiler: failed to write %s (profiler compiled out?)\n", config.tracePath.c_str());
+		}
+	}
+
+	void cleanup()
+	{
+		cleanupSwapChain();
+		dispatch.vkDestroyRenderPass(device, renderPass, nullptr);
+
+		gpuProfiler.destroy();
+		frameTimestamps.destroy();
+
+		if (config.printStats)
+			bindless.printStats();
+		bindless.destroy();
+
+		if (config.printStats)
+			gpuScene.printStats();
+		gpuScene.destroy();
+
+		if (config.printStats)
+			meshBuffers.printStats();
+		meshBuffers.destroy();
+
+		if (config.printStats)
+			renderGraph.printStats(true);
+		renderGraph.destroy();
+
+		//ɫĶԺ̡ͣ߳ģ
+		if (config.printStats)
+			shaderManager.printStats();
+		shaderManager.destroy();
+
+		//ͣ¼߳ǵ
+		jobs.stop();
+		commandRecorder.destroy();
+
+		//ÿ֡ͬ
+		for (auto& frame : frames)
+		{
+			dispatch.vkDestroySemaphore(device, frame.imageAvailableSemaphore, nullptr);
+			dispatch.vkDestroyFence(device, frame.inFlightFence, nullptr);
+			dispatch.vkDestroyCommandPool(device, frame.commandPool, nullptr);
+		}
+
+		//߻дش
+		if (!config.pipelineCachePath.empty())
+			pipelineCache.save();
+		pipelineCache.destroy();
+
+		if (config.printStats)
+			stagingRing.printStats();
+		stagingRing.destroy();
+
+		//ͷԴ
+		if (config.printStats)
+			allocator.printStats();
+		allocator.destroy();
+
+		//߼豸
+		dispatch.vkDestroyDevice(device, hostAllocator.callbacks());
+
+		//棬Ѿǰ
+		if (surface != VK_NULL_HANDLE)
+			dispatch.vkDestroySurfaceKHR(instance, surface, hostAllocator.callbacks());
+
+		//Ϣ
+		if (enableValidationLayers && dispatch.vkDestroyDebugUtilsMessengerEXT != nullptr) {
+			dispatch.vkDestroyDebugUtilsMessengerEXT(instance, debugMessenger, hostAllocator.callbacks());
+		}
+		//VKʵ
+		dispatch.vkDestroyInstance(instance, hostAllocator.callbacks());
+
+		//ʵʱҲϢͣ־߳
+		if (enableValidationLayers) {
+			debugLog.stop();
+			if (config.printStats)
+				debugLog.printCounts();
+		}
+
+		//ʵԺٳǷڴ棬ʣµĶй©
+		if (config.printStats)
+			hostAllocator.printStats();
+		hostAllocator.destroy();
+
+		if (!config.headless)
+		{
+			//
+			glfwDestroyWindow(window);
+
+
+			//GLFW
+			glfwTerminate();
+		}
+	}
+
+private:
+	//ʱ棬һJSONͬʱд--startup-reportָļ
+	void reportStartup()
+	{
+		char extra[128];
+		snprintf(extra, sizeof(extra), "\"headless\":%s,\"pipeline_cache\":\"%s\",\"pipeline_cache_bytes\":%zu",
+			config.headless ? "true" : "false", pipelineCache.isWarm() ? "warm" : "cold", pipelineCache.loadedSize());
+		std::string json = startupTimer.toJson(extra);
+		printf("startup-report %s\n", json.c_str());
+
+		if (!config.startupReportPath.empty())
+		{
+			std::ofstream file(config.startupReportPath, std::ios::trunc);
+			file << json << std::endl;
+		}
+	}
+
+	//ʵ
+	void createInstance()
+	{
+		//֤ 鵫Ǽܲ
+		if (enableValidationLayers && !checkValidationLayerSupport())
+		{
+			throw std::runtime_error(std::string("validation profile '") + validationProfileName(config.validation) + "' requested, but not available!");
+		}
+
+		//APPϢǱҪ
+		VkApplicationInfo appInfo{};
+		appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;  //עЩϢϢΪϢ
+		appInfo.pApplicationName = "Hello Triangle";
+		appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
+		appInfo.pEngineName = "No Engine";
+		appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
+		appInfo.apiVersion = getInstanceApiVersion();
+
+		//VKʵϢҪ
+		VkInstanceCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+		createInfo.pApplicationInfo = &appInfo;
+
+		/*uint32_t glfwExtensionCount = 0;
+		const char** glfwExtension;
+		glfwExtension = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+		ⲿʹúԶgetRequiredExtensionsˣڲдһּ*/
+
+		auto extensions = getRequiredExtensions();
+
+		createInfo.enabledExtensionCount = static_cast<uint32_t> (extensions.size());
+		createInfo.ppEnabledExtensionNames = extensions.data();
+
+		VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
+		if (enableValidationLayers) {
+			createInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
+			createInfo.ppEnabledLayerNames = validationLayers.data();
+
+			//ʵʱϢҲ첽־־߳Ҫ
+			debugLog.setFilter(config.debugSeverity, validationSettings.messageTypes());
+			debugLog.start(config.debugLogPath, config.debugRepeatLimit);
+
+			//Ϣʹ֤λãûvalidation features
+			populateDebugMessengerCreateInfo(debugCreateInfo);
+			createInfo.pNext = validationSettings.chain(&debugCreateInfo);
+			if (config.printStats)
+				printf("validation: %s (%s)\n", validationProfileName(config.validation), validationSettings.mechanism());
+		}
+		else {
+			createInfo.enabledLayerCount = 0;
+
+			createInfo.pNext = nullptr;
+		}
+
+		//ʼʵ
+		if (vkCreateInstance(&createInfo, hostAllocator.callbacks(), &instance) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create instance!");
+		}
+
+		//ʵָֻȡһ
+		dispatch.loadInstance(instance);
+		
+	}
+
+	//ѡ豸
+	void pickPhysicalDevice()
+	{
+		//гп豸
+		uint32_t deviceCount = 0;
+		dispatch.vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
+
+		if (deviceCount == 0)
+		{
+			throw std::runtime_error("failed to find GPUs with Vulkan support!");
+		}
+
+		std::vector<VkPhysicalDevice> devices(deviceCount);
+		dispatch.vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+		
+		//ÿ豸֣ȡ߷ָ֣豸ʱֻƥ豸ѡ
+		uint32_t bestScore = 0;
+		for (const auto& device:devices)
+		{
+			VkPhysicalDeviceProperties deviceProperties;
+			dispatch.vkGetPhysicalDeviceProperties(device, &deviceProperties);
+
+			DeviceScore score = rateDeviceSuitability(device);
+			std::string uuid = getDeviceUUID(device);
+
+			//׼ͷʼʱӡʡÿεöˢһ豸б
+			if (config.printStats)
+				std::cout << "device: " << deviceProperties.deviceName << " [" << uuid << "]"
+					<< " suitable=" << score.suitable
+					<< " type=" << score.typeScore
+					<< " memory=" << score.memoryScore
+					<< " queue=" << score.queueScore
+					<< " limit=" << score.limitScore
+					<< " feature=" << score.featureScore
+					<< " total=" << score.total() << "\n";
+
+			if (!config.deviceOverride.empty() &&
+				strstr(deviceProperties.deviceName, config.deviceOverride.c_str()) == nullptr &&
+				uuid != config.deviceOverride)
+				continue;
+
+			if (score.suitable && (physicalDevice == VK_NULL_HANDLE || score.total() > bestScore))
+			{
+				physicalDevice = device;
+				bestScore = score.total();
+			}
+		}
+
+		if (physicalDevice == VK_NULL_HANDLE)
+		{
+			if (!config.deviceOverride.empty())
+				throw std::runtime_error("no suitable GPU matches '" + config.deviceOverride + "'!");
+			throw std::runtime_error("failed to find a suitable GPU!");
+		}
+
+		VkPhysicalDeviceProperties deviceProperties;
+		dispatch.vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+		if (config.printStats)
+			std::cout << "selected device: " << deviceProperties.deviceName << " (score " << bestScore << ")" << std::endl;
+		deviceName = deviceProperties.deviceName;
+	}
+
+	//߼豸
+	void createLogicalDevice()
+	{
+		//ָ
+		QueueFamilyIndices indices = findQueueFamily(physicalDevice);
+
+		//ÿͬĶ崴һУͼζȼߣöʱȡߵȼ
+		std::map<uint32_t, float> uniqueQueueFamilies;
+		uniqueQueueFamilies[indices.graphicsFamily.value()] = 1.0f;
+		if (indices.presentFamily.has_value())
+			uniqueQueueFamilies[indices.presentFamily.value()] = 1.0f;
+		if (indices.computeFamily.has_value())
+			uniqueQueueFamilies.emplace(indices.computeFamily.value(), 0.75f);
+		if (indices.transferFamily.has_value())
+			uniqueQueueFamilies.emplace(indices.transferFamily.value(), 0.5f);
+
+		std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+		for (const auto& family : uniqueQueueFamilies)
+		{
+			VkDeviceQueueCreateInfo queueCreateInfo{};
+			queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+			queueCreateInfo.queueFamilyIndex = family.first;
+			queueCreateInfo.queueCount = 1;
+			queueCreateInfo.pQueuePriorities = &family.second;
+			queueCreateInfos.push_back(queueCreateInfo);
+		}
+
+		//ָʹ豸Щ
+		VkPhysicalDeviceFeatures deviceFeatures{};
+
+		//1.2/1.3ĹȲѯã豸ֵ֧ıֹر
+		features.query(physicalDevice, instanceApiVersion, config.maxApiVersion);
+		features.enableBaseFeatures(deviceFeatures);
+
+		//߼豸Ϣ
+		VkDeviceCreateInfo deviceCreateInfo{};
+		deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		deviceCreateInfo.pNext = features.chain();
+		deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
+		deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+
+		deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
+
+		auto deviceExtensions = getRequiredDeviceExtensions();
+		features.addExtensions(deviceExtensions);
+		deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+		deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
+		if (enableValidationLayers)
+		{
+			deviceCreateInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
+			deviceCreateInfo.ppEnabledLayerNames = validationLayers.data();
+		}
+		else
+		{
+			deviceCreateInfo.enabledLayerCount = 0;
+		}
+		//߼豸
+		if (dispatch.vkCreateDevice(physicalDevice, &deviceCreateInfo, hostAllocator.callbacks(), &device) != VK_SUCCESS)
+			throw std::runtime_error("failed to create logical device!");
+		dispatch.loadDevice(device);
+		features.loadFunctions(device);
+		if (config.printStats)
+			features.print();
+
+		//һضоöʱõͬһ
+		dispatch.vkGetDeviceQueue(device, indices.graphicsFamily.value(), 0, &graphicsQueue);
+		computeQueue = graphicsQueue;
+		transferQueue = graphicsQueue;
+		if (indices.computeFamily.has_value())
+			dispatch.vkGetDeviceQueue(device, indices.computeFamily.value(), 0, &computeQueue);
+		if (indices.transferFamily.has_value())
+			dispatch.vkGetDeviceQueue(device, indices.transferFamily.value(), 0, &transferQueue);
+		if (indices.presentFamily.has_value())
+			dispatch.vkGetDeviceQueue(device, indices.presentFamily.value(), 0, &presentQueue);
+		queueFamilies = indices;
+	}
+
+	//ԴӷڴͺԴֿ
+	void createAllocator()
+	{
+		allocator.init(physicalDevice, device, dispatch, features.apiVersion >= VK_API_VERSION_1_1);
+	}
+
+	//ϴfindQueueFamilyѡĴУûжʱͼζ
+	void createStagingRing()
+	{
+		uint32_t transferFamily = queueFamilies.transferFamily.value_or(queueFamilies.graphicsFamily.value());
+		stagingRing.init(device, dispatch, allocator, transferQueue, transferFamily, queueFamilies.graphicsFamily.value(),
+			static_cast<VkDeviceSize>(config.stagingRingMB) * 1024 * 1024);
+	}
+
+	//߻棬֮й߶ͨ
+	void createPipelineCache()
+	{
+		VkPhysicalDeviceProperties properties;
+		dispatch.vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		pipelineCache.create(device, dispatch, properties, config.pipelineCachePath);
+	}
+
+	//ڱ
+	void createSurface()
+	{
+		if (config.headless)
+		{
+			//֧VK_EXT_headless_surfaceʱ棬ֱȾͼ
+			if (!headlessSurfaceSupported)
+				return;
+
+			VkHeadlessSurfaceCreateInfoEXT createInfo{};
+			createInfo.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+
+			if (dispatch.vkCreateHeadlessSurfaceEXT == nullptr ||
+				dispatch.vkCreateHeadlessSurfaceEXT(instance, &createInfo, hostAllocator.callbacks(), &surface) != VK_SUCCESS)
+				throw std::runtime_error("failed to create headless surface!");
+			return;
+		}
+
+		if (glfwCreateWindowSurface(instance, window, hostAllocator.callbacks(), &surface) != VK_SUCCESS)
+			throw std::runtime_error("failed to create window surface!");
+	}
+
+	//ѯ豸ԱĽ֧
+	SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device)
+	{
+		SwapChainSupportDetails details;
+		dispatch.vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &details.capabilities);
+
+		uint32_t formatCount = 0;
+		dispatch.vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &formatCount, nullptr);
+		details.formats.resize(formatCount);
+		dispatch.vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &formatCount, details.formats.data());
+
+		uint32_t presentModeCount = 0;
+		dispatch.vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &presentModeCount, nullptr);
+		details.presentModes.resize(presentModeCount);
+		dispatch.vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &presentModeCount, details.presentModes.data());
+
+		return details;
+	}
+
+	//ѡʽsRGB
+	VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats)
+	{
+		for (const auto& availableFormat : availableFormats)
+		{
+			if (availableFormat.format == VK_FORMAT_B8G8R8A8_SRGB && availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+				return availableFormat;
+		}
+		return availableFormats[0];
+	}
+
+	//ѡģʽֱͬFIFOһ֧֣ģʽCPUƽ࣬Ȳȴֱͬģʽ
+	VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes)
+	{
+		if (config.pacing == PacingMode::Vsync)
+			return VK_PRESENT_MODE_FIFO_KHR;
+
+		for (VkPresentModeKHR mode : { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR })
+		{
+			if (std::find(availablePresentModes.begin(), availablePresentModes.end(), mode) != availablePresentModes.end())
+				return mode;
+		}
+		return VK_PRESENT_MODE_FIFO_KHR;
+	}
+
+	//ѡ񽻻ͼС޴ʱĬϴС
+	VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities)
+	{
+		if (capabilities.currentExtent.width != UINT32_MAX)
+			return capabilities.currentExtent;
+
+		int width = WIDTH, height = HEIGHT;
+		if (window != nullptr)
+			glfwGetFramebufferSize(window, &width, &height);
+
+		VkExtent2D actualExtent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+		actualExtent.width = std::clamp(actualExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
+		actualExtent.height = std::clamp(actualExtent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+		return actualExtent;
+	}
+
+	//ûбʱͼ
+	void createSwapChain()
+	{
+		if (surface == VK_NULL_HANDLE)
+		{
+			createOffscreenImages();
+			return;
+		}
+
+		SwapChainSupportDetails swapChainSupport = querySwapChainSupport(physicalDevice);
+		VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
+		VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+		VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
+
+		//ͼһţ
+		uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+		if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount)
+			imageCount = swapChainSupport.capabilities.maxImageCount;
+
+		VkSwapchainCreateInfoKHR createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+		createInfo.surface = surface;
+		createInfo.minImageCount = imageCount;
+		createInfo.imageFormat = surfaceFormat.format;
+		createInfo.imageColorSpace = surfaceFormat.colorSpace;
+		createInfo.imageExtent = extent;
+		createInfo.imageArrayLayers = 1;
+		createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+		//Ⱦͼĺϳͨøдͼ
+		if (config.renderGraph)
+		{
+			if ((swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) == 0)
+				throw std::runtime_error("swap chain images cannot be transfer destinations, which --render-graph needs!");
+			createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		}
+
+		//ͼκͳֶ岻ͬʱͼҪܱ干
+		uint32_t queueFamilyIndices[] = { queueFamilies.graphicsFamily.value(), queueFamilies.presentFamily.value() };
+		if (queueFamilies.graphicsFamily != queueFamilies.presentFamily)
+		{
+			createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+			createInfo.queueFamilyIndexCount = 2;
+			createInfo.pQueueFamilyIndices = queueFamilyIndices;
+		}
+		else
+		{
+			createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		}
+
+		createInfo.preTransform = swapChainSupport.capabilities.currentTransform;
+		createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+		createInfo.presentMode = presentMode;
+		createInfo.clipped = VK_TRUE;
+		createInfo.oldSwapchain = VK_NULL_HANDLE;
+
+		if (dispatch.vkCreateSwapchainKHR(device, &createInfo, nullptr, &swapChain) != VK_SUCCESS)
+			throw std::runtime_error("failed to create swap chain!");
+
+		//һؽͼ
+		dispatch.vkGetSwapchainImagesKHR(device, swapChain, &imageCount, nullptr);
+		swapChainImages.resize(imageCount);
+		dispatch.vkGetSwapchainImagesKHR(device, swapChain, &imageCount, swapChainImages.data());
+
+		swapChainImageFormat = surfaceFormat.format;
+		swapChainExtent = extent;
+
+		//õźͼ䣬ǰͬһͼ񲻻ٱȡ
+		renderFinishedSemaphores.resize(imageCount);
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		for (auto& semaphore : renderFinishedSemaphores)
+		{
+			if (dispatch.vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS)
+				throw std::runtime_error("failed to create semaphores!");
+		}
+	}
+
+	//ûбʱÿ֡һͼ񣬵iֻ֡õi
+	void createOffscreenImages()
+	{
+		swapChainImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+		swapChainExtent = { WIDTH, HEIGHT };
+		swapChainImages.resize(config.framesInFlight);
+		offscreenAllocations.resize(config.framesInFlight);
+
+		for (size_t i = 0; i < swapChainImages.size(); i++)
+		{
+			VkImageCreateInfo imageInfo{};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.format = swapChainImageFormat;
+			imageInfo.extent = { swapChainExtent.width, swapChainExtent.height, 1 };
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+				(config.renderGraph ? VK_IMAGE_USAGE_TRANSFER_DST_BIT : 0);
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+			allocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, swapChainImages[i], offscreenAllocations[i]);
+		}
+	}
+
+	//ÿͼ񴴽ͼͼ
+	void createImageViews()
+	{
+		swapChainImageViews.resize(swapChainImages.size());
+
+		for (size_t i = 0; i < swapChainImages.size(); i++)
+		{
+			VkImageViewCreateInfo createInfo{};
+			createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			createInfo.image = swapChainImages[i];
+			createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			createInfo.format = swapChainImageFormat;
+			createInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			createInfo.subresourceRange.baseMipLevel = 0;
+			createInfo.subresourceRange.levelCount = 1;
+			createInfo.subresourceRange.baseArrayLayer = 0;
+			createInfo.subresourceRange.layerCount = 1;
+
+			if (dispatch.vkCreateImageView(device, &createInfo, nullptr, &swapChainImageViews[i]) != VK_SUCCESS)
+				throw std::runtime_error("failed to create image views!");
+		}
+	}
+
+	//Ⱦ̣Ŀǰֶֻ֧̬ȾʱҪȾ̺֡
+	void createRenderPass()
+	{
+		if (features.dynamicRendering)
+			return;
+
+		VkAttachmentDescription colorAttachment{};
+		colorAttachment.format = swapChainImageFormat;
+		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		//ͼȾŸض
+		colorAttachment.finalLayout = swapChain != VK_NULL_HANDLE ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+		VkAttachmentReference colorAttachmentRef{};
+		colorAttachmentRef.attachment = 0;
+		colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		VkSubpassDescription subpass{};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = 1;
+		subpass.pColorAttachments = &colorAttachmentRef;
+
+		//Ȼȡͼź֮дɫ
+		VkSubpassDependency dependency{};
+		dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependency.dstSubpass = 0;
+		dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependency.srcAccessMask = 0;
+		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+		VkRenderPassCreateInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = 1;
+		renderPassInfo.pAttachments = &colorAttachment;
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpass;
+		renderPassInfo.dependencyCount = 1;
+		renderPassInfo.pDependencies = &dependency;
+
+		if (dispatch.vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+			throw std::runtime_error("failed to create render pass!");
+	}
+
+	//ÿͼ񴴽֡
+	void createFramebuffers()
+	{
+		if (features.dynamicRendering)
+			return;
+
+		swapChainFramebuffers.resize(swapChainImageViews.size());
+
+		for (size_t i = 0; i < swapChainImageViews.size(); i++)
+		{
+			VkFramebufferCreateInfo framebufferInfo{};
+			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+			framebufferInfo.renderPass = renderPass;
+			framebufferInfo.attachmentCount = 1;
+			framebufferInfo.pAttachments = &swapChainImageViews[i];
+			framebufferInfo.width = swapChainExtent.width;
+			framebufferInfo.height = swapChainExtent.height;
+			framebufferInfo.layers = 1;
+
+			if (dispatch.vkCreateFramebuffer(device, &framebufferInfo, nullptr, &swapChainFramebuffers[i]) != VK_SUCCESS)
+				throw std::runtime_error("failed to create framebuffer!");
+		}
+	}
+
+	//ÿ֡ءͬ
+	void createFrameResources()
+	{
+		frames.resize(std::max(config.framesInFlight, 1u));
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = queueFamilies.graphicsFamily.value();
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		//դʼΪѴһ֡õ
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+		for (auto& frame : frames)
+		{
+			if (dispatch.vkCreateCommandPool(device, &poolInfo, nullptr, &frame.commandPool) != VK_SUCCESS)
+				throw std::runtime_error("failed to create command pool!");
+
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = frame.commandPool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+
+			if (dispatch.vkAllocateCommandBuffers(device, &allocInfo, &frame.commandBuffer) != VK_SUCCESS)
+				throw std::runtime_error("failed to allocate command buffers!");
+
+			if (dispatch.vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.imageAvailableSemaphore) != VK_SUCCESS ||
+				dispatch.vkCreateFence(device, &fenceInfo, nullptr, &frame.inFlightFence) != VK_SUCCESS)
+				throw std::runtime_error("failed to create synchronization objects for a frame!");
+		}
+	}
+
+	//¼̣߳ÿ߳ÿ֡һأɳĻб
+	void createCommandRecorder()
+	{
+		jobs.start(config.recordThreads);
+		commandRecorder.init(device, dispatch, queueFamilies.graphicsFamily.value(), static_cast<uint32_t>(frames.size()), jobs.workerCount());
+		drawList = generateDrawList(config.drawCount);
+	}
+
+	//GPUʱĻ豸timestampPeriod
+	void createProfiler()
+	{
+		gpuProfiler.init(physicalDevice, device, dispatch, queueFamilies.graphicsFamily.value(), static_cast<uint32_t>(frames.size()));
+		if (!config.tracePath.empty())
+			Profiler::instance().enableCapture();
+	}
+
+	//عԺ޳ҪGPUʱ䣬ֻģʽ´ÿ֡ʱ
+	void createFrameTimestamps()
+	{
+		if (!config.regressionScene.empty() || config.cullingBench)
+			frameTimestamps.init(physicalDevice, device, dispatch, queueFamilies.graphicsFamily.value(), static_cast<uint32_t>(frames.size()));
+	}
+
+	//ްԴ豸֧ʱÿ֡һݵС
+	void createBindlessRegistry()
+	{
+		bindless.init(physicalDevice, device, dispatch, features.descriptorIndexing, static_cast<uint32_t>(frames.size()),
+			hostAllocator.callbacks());
+	}
+
+	//ɫģ鶼ȡԴûʱֱӶ̻棬ñ
+	void createShaderManager()
+	{
+		shaderManager.init(device, dispatch, config.shaderSourceDir, config.shaderDir, config.shaderCacheDir, config.shaderCompiler,
+			static_cast<uint32_t>(frames.size()));
+		if (config.shaderHotReload)
+			shaderManager.startWatching();
+	}
+
+	//GPUֻûлбʱͶ·
+	void createGpuScene()
+	{
+		if (config.objectCount > 0)
+			initGpuScene(config.objectCount, config.culling);
+	}
+
+	//ӳ--meshָļֱӽݴ滷һ֡¼ʱͼζȡȨ
+	void createMesh()
+	{
+		meshBuffers.init(device, dispatch, allocator, stagingRing);
+		if (config.meshPath.empty())
+			return;
+		MeshFile file;
+		file.open(config.meshPath);
+		meshBuffers.load(file);
+		stagingRing.flush();
+	}
+
+	//--render-graphÿ֡Ⱦͼ¼ƣͨö̬Ⱦʱͼ
+	void createRenderGraph()
+	{
+		if (!config.renderGraph)
+			return;
+		if (!features.dynamicRendering)
+			throw std::runtime_error("--render-graph needs dynamic rendering (Vulkan 1.3 or VK_KHR_dynamic_rendering)!");
+		renderGraphBackbuffer = buildRenderGraph(renderGraph);
+	}
+
+	//ʾ֡ʱͼ⣬ϳʱѳͷ⸴ƽͼ
+	//ͼûͨᱻ޳ͨⲻִ˳˳ɶдϵؽͼԴ
+	uint32_t buildRenderGraph(RenderGraph& graph)
+	{
+		//ð뾫ȸ㣬豸ܶʱ˻ؽʽ
+		VkFormat bloomFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+		const VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+		VkFormatProperties formatProperties;
+		dispatch.vkGetPhysicalDeviceFormatProperties(physicalDevice, bloomFormat, &formatProperties);
+		if ((formatProperties.optimalTilingFeatures & blitFeatures) != blitFeatures)
+			bloomFormat = swapChainImageFormat;
+		dispatch.vkGetPhysicalDeviceFormatProperties(physicalDevice, swapChainImageFormat, &formatProperties);
+		if ((formatProperties.optimalTilingFeatures & blitFeatures) != blitFeatures)
+			throw std::runtime_error("swap chain format does not support blits, which --render-graph needs!");
+		VkFilter filter = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0 ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+
+		graph.init(device, dispatch, allocator, features.synchronization2 ? features.cmdPipelineBarrier2 : nullptr);
+		uint32_t width = swapChainExtent.width;
+		uint32_t height = swapChainExtent.height;
+		uint32_t halfWidth = std::max(width / 2, 1u), halfHeight = std::max(height / 2, 1u);
+		uint32_t quarterWidth = std::max(width / 4, 1u), quarterHeight = std::max(height / 4, 1u);
+
+		//ͻȡͼźȴͬһ׶Σֻض
+		bool present = swapChain != VK_NULL_HANDLE;
+		uint32_t backbuffer = graph.importImage("backbuffer", { width, height, swapChainImageFormat },
+			VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+			present ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			present ? VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+			present ? VK_ACCESS_2_NONE : VK_ACCESS_2_TRANSFER_READ_BIT);
+		uint32_t scene = graph.createImage("scene", { width, height, swapChainImageFormat });
+		uint32_t bloomHalf = graph.createImage("bloom-half", { halfWidth, halfHeight, bloomFormat });
+		uint32_t bloomQuarter = graph.createImage("bloom-quarter", { quarterWidth, quarterHeight, bloomFormat });
+		uint32_t bloomUp = graph.createImage("bloom-up", { halfWidth, halfHeight, bloomFormat });
+		uint32_t debugView = graph.createImage("debug-view", { halfWidth, halfHeight, swapChainImageFormat });
+
+		//ͼŸ
+		auto blit = [this, filter](VkCommandBuffer commandBuffer, const RenderGraph& g, uint32_t src, uint32_t dst) {
+			blitImage(commandBuffer, g.image(src), { 0, 0, g.desc(src).width, g.desc(src).height },
+				g.image(dst), { 0, 0, g.desc(dst).width, g.desc(dst).height }, filter);
+		};
+
+		//СϽǣ㿴ϳõ
+		graph.addPass("composite", { { scene, GraphAccess::TransferRead }, { bloomUp, GraphAccess::TransferRead }, { backbuffer, GraphAccess::TransferWrite } },
+			[this, blit, scene, bloomUp, backbuffer, filter](VkCommandBuffer commandBuffer, const RenderGraph& g) {
+				blit(commandBuffer, g, scene, backbuffer);
+				uint32_t w = g.desc(backbuffer).width, h = g.desc(backbuffer).height;
+				blitImage(commandBuffer, g.image(bloomUp), { 0, 0, g.desc(bloomUp).width, g.desc(bloomUp).height },
+					g.image(backbuffer), { static_cast<int32_t>(w - w / 4), 0, std::max(w / 4, 1u), std::max(h / 4, 1u) }, filter);
+			});
+		graph.addPass("bloom-up", { { bloomQuarter, GraphAccess::TransferRead }, { bloomUp, GraphAccess::TransferWrite } },
+			[blit, bloomQuarter, bloomUp](VkCommandBuffer commandBuffer, const RenderGraph& g) { blit(commandBuffer, g, bloomQuarter, bloomUp); });
+		graph.addPass("debug-view", { { scene, GraphAccess::TransferRead }, { debugView, GraphAccess::TransferWrite } },
+			[blit, scene, debugView](VkCommandBuffer commandBuffer, const RenderGraph& g) { blit(commandBuffer, g, scene, debugView); });
+		graph.addPass("scene", { { scene, GraphAccess::ColorAttachmentWrite } },
+			[this, scene](VkCommandBuffer commandBuffer, const RenderGraph& g) {
+				renderScene(commandBuffer, g.view(scene), renderGraphImageIndex, renderGraphClearColor);
+			});
+		graph.addPass("bloom-down", { { scene, GraphAccess::TransferRead }, { bloomHalf, GraphAccess::TransferWrite } },
+			[blit, scene, bloomHalf](VkCommandBuffer commandBuffer, const RenderGraph& g) { blit(commandBuffer, g, scene, bloomHalf); });
+		graph.addPass("bloom-down-2", { { bloomHalf, GraphAccess::TransferRead }, { bloomQuarter, GraphAccess::TransferWrite } },
+			[blit, bloomHalf, bloomQuarter](VkCommandBuffer commandBuffer, const RenderGraph& g) { blit(commandBuffer, g, bloomHalf, bloomQuarter); });
+		graph.compile();
+		return backbuffer;
+	}
+
+	void initGpuScene(uint32_t objectCount, CullingMode mode)
+	{
+		VkPhysicalDeviceProperties properties;
+		dispatch.vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+		GpuDrivenScene::Capabilities capabilities;
+		capabilities.drawIndirectFirstInstance = features.drawIndirectFirstInstance;
+		capabilities.maxDrawIndirectCount = features.multiDrawIndirect ? properties.limits.maxDrawIndirectCount : 1;
+		capabilities.cmdDrawIndexedIndirectCount = features.drawIndirectCount ? features.cmdDrawIndexedIndirectCount : nullptr;
+
+		gpuScene.init(device, dispatch, allocator, stagingRing, pipelineCache.handle(), shaderManager,
+			features.dynamicRendering ? VK_NULL_HANDLE : renderPass, swapChainImageFormat, capabilities, objectCount);
+		gpuScene.setMode(mode);
+		gpuScene.setCullKernel(config.cullKernel);
+		gpuScene.setCamera(static_cast<float>(swapChainExtent.width) / static_cast<float>(swapChainExtent.height));
+		if (gpuScene.currentMode() != mode)
+			printf("gpu scene: culling %s not supported, using %s\n", cullingModeName(mode), cullingModeName(gpuScene.currentMode()));
+	}
+
+	//ɹ̶ĲԳһѴСɫͬС
+	static std::vector<DrawItem> generateDrawList(uint32_t count)
+	{
+		std::vector<DrawItem> items(count);
+		uint32_t seed = 12345;
+		auto next = [&seed]() {
+			seed = seed * 1664525u + 1013904223u;
+			return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+		};
+		for (auto& item : items)
+		{
+			item.width = 0.01f + 0.05f * next();
+			item.height = 0.01f + 0.05f * next();
+			item.x = next() * (1.0f - item.width);
+			item.y = next() * (1.0f - item.height);
+			item.color[0] = next();
+			item.color[1] = next();
+			item.color[2] = next();
+			item.color[3] = 1.0f;
+		}
+		return items;
+	}
+
+	//ͽСصĶ
+	void cleanupSwapChain()
+	{
+		for (auto framebuffer : swapChainFramebuffers)
+			dispatch.vkDestroyFramebuffer(device, framebuffer, nullptr);
+		for (auto imageView : swapChainImageViews)
+			dispatch.vkDestroyImageView(device, imageView, nullptr);
+		for (auto semaphore : renderFinishedSemaphores)
+			dispatch.vkDestroySemaphore(device, semaphore, nullptr);
+
+		if (swapChain != VK_NULL_HANDLE)
+		{
+			dispatch.vkDestroySwapchainKHR(device, swapChain, nullptr);
+			swapChain = VK_NULL_HANDLE;
+		}
+		else
+		{
+			for (size_t i = 0; i < swapChainImages.size(); i++)
+			{
+				dispatch.vkDestroyImage(device, swapChainImages[i], nullptr);
+				allocator.free(offscreenAllocations[i]);
+			}
+			offscreenAllocations.clear();
+		}
+
+		swapChainFramebuffers.clear();
+		swapChainImageViews.clear();
+		swapChainImages.clear();
+		renderFinishedSemaphores.clear();
+	}
+
+	//ڴС仯򽻻ʱؽ
+	void recreateSwapChain()
+	{
+		//Сʱȴڻָ
+		int width = 0, height = 0;
+		if (window != nullptr)
+		{
+			glfwGetFramebufferSize(window, &width, &height);
+			while (width == 0 || height == 0)
+			{
+				glfwGetFramebufferSize(window, &width, &height);
+				glfwWaitEvents();
+			}
+		}
+
+		dispatch.vkDeviceWaitIdle(device);
+
+		cleanupSwapChain();
+		createSwapChain();
+		createImageViews();
+		createFramebuffers();
+		if (config.renderGraph)
+		{
+			renderGraph.destroy();
+			renderGraphBackbuffer = buildRenderGraph(renderGraph);
+		}
+		if (gpuScene.active())
+			gpuScene.setCamera(static_cast<float>(swapChainExtent.width) / static_cast<float>(swapChainExtent.height));
+	}
+
+	//ϴ²ԣģÿ֡ʽϴһݣͳºÿ֡ϴϵCPUʱ
+	void runUploadBenchmark()
+	{
+		const VkDeviceSize chunkSize = 4ull * 1024 * 1024;
+		const VkDeviceSize dstSize = 64ull * 1024 * 1024;
+		const uint64_t chunkCount = (static_cast<uint64_t>(config.uploadBenchMB) * 1024 * 1024 + chunkSize - 1) / chunkSize;
+
+		VkBuffer dstBuffer;
+		Allocation dstAllocation;
+		allocator.createBuffer(dstSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, dstBuffer, dstAllocation);
+
+		std::vector<uint32_t> source(chunkSize / sizeof(uint32_t));
+		for (size_t i = 0; i < source.size(); i++)
+			source[i] = static_cast<uint32_t>(i * 2654435761u);
+
+		uint64_t stallsBefore = stagingRing.stallCount();
+		std::vector<double> callMs;
+		callMs.reserve(chunkCount);
+
+		BenchmarkReport::Timer timer;
+		auto start = std::chrono::steady_clock::now();
+		for (uint64_t i = 0; i < chunkCount; i++)
+		{
+			auto callStart = std::chrono::steady_clock::now();
+			stagingRing.uploadBuffer(dstBuffer, (i * chunkSize) % dstSize, source.data(), chunkSize);
+			stagingRing.flush();
+			callMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - callStart).count());
+		}
+		stagingRing.waitIdle();
+		double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::sort(callMs.begin(), callMs.end());
+		double totalMB = static_cast<double>(chunkCount * chunkSize) / (1024.0 * 1024.0);
+		printf("upload bench: %.0f MB in %.3f ms = %.1f MB/s, per-frame upload call p50 %.3f ms, p99 %.3f ms, %llu stalls\n",
+			totalMB, totalMs, totalMB / (totalMs / 1000.0),
+			callMs[callMs.size() / 2], callMs[std::min(callMs.size() - 1, callMs.size() * 99 / 100)],
+			static_cast<unsigned long long>(stagingRing.stallCount() - stallsBefore));
+		if (benchmarkReport != nullptr)
+			benchmarkReport->add("upload/chunk_mb:4/total_mb:" + std::to_string(config.uploadBenchMB), chunkCount, totalMs, timer.cpuMs(),
+				{ { "bytes_per_second", chunkCount * chunkSize / (totalMs / 1000.0) },
+				  { "p99_call_ms", callMs[std::min(callMs.size() - 1, callMs.size() * 99 / 100)] },
+				  { "stalls", static_cast<double>(stagingRing.stallCount() - stallsBefore) } });
+
+		stagingRing.discardAcquireBarriers();
+		dispatch.vkDestroyBuffer(device, dstBuffer, nullptr);
+		allocator.free(dstAllocation);
+	}
+
+	//¼չԲԣͬһݻбֱ1N߳¼ƣֻ¼Ʋύ
+	void runRecordBenchmark()
+	{
+		const uint32_t iterations = 50;
+		std::vector<DrawItem> savedDrawList = drawList;
+		if (drawList.empty())
+			drawList = generateDrawList(100000);
+
+		uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+		double singleThreadMs = 0.0;
+		for (uint32_t threadCount = 1; threadCount <= maxThreads; threadCount++)
+		{
+			JobSystem benchJobs;
+			benchJobs.start(threadCount);
+			ParallelCommandRecorder benchRecorder;
+			benchRecorder.init(device, dispatch, queueFamilies.graphicsFamily.value(), 1, benchJobs.workerCount());
+
+			VkCommandBufferInheritanceInfo inheritance{};
+			VkCommandBufferInheritanceRenderingInfo renderingInheritance{};
+			fillInheritance(0, inheritance, renderingInheritance);
+
+			double totalMs = 0.0;
+			double cpuMs = 0.0;
+			for (uint32_t i = 0; i <= iterations; i++)
+			{
+				benchRecorder.resetFrame(0);
+				BenchmarkReport::Timer timer;
+				auto start = std::chrono::steady_clock::now();
+				benchRecorder.record(benchJobs, 0, static_cast<uint32_t>(drawList.size()), drawsPerSlice, inheritance,
+					[this](VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end) { recordDraws(commandBuffer, begin, end); });
+				//һҪ壬
+				if (i > 0)
+				{
+					totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+					cpuMs += timer.cpuMs();
+				}
+			}
+
+			double frameMs = totalMs / iterations;
+			if (threadCount == 1)
+				singleThreadMs = frameMs;
+			printf("record bench: %u threads, %zu draws, %.3f ms/frame, %.2f Mdraws/s, speedup %.2fx, %llu steals\n",
+				threadCount, drawList.size(), frameMs, drawList.size() / (frameMs * 1000.0), singleThreadMs / frameMs,
+				static_cast<unsigned long long>(benchJobs.stealCount()));
+			if (benchmarkReport != nullptr)
+				benchmarkReport->add("record/draws:" + std::to_string(drawList.size()) + "/threads:" + std::to_string(threadCount),
+					iterations, totalMs, cpuMs, { { "draws_per_second", drawList.size() / (frameMs / 1000.0) }, { "speedup", singleThreadMs / frameMs } });
+
+			benchJobs.stop();
+			benchRecorder.destroy();
+		}
+
+		drawList = savedDrawList;
+	}
+
+	//ÿԣͬһֱֱӵã壩ַͨãȽÿεõʱ
+	void runDispatchBenchmark()
+	{
+		const uint32_t calls = 1000000;
+		const uint32_t submits = 100000;
+		const uint32_t rounds = 5;
+
+		VkCommandPool pool;
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = queueFamilies.graphicsFamily.value();
+		if (dispatch.vkCreateCommandPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+			throw std::runtime_error("failed to create benchmark command pool!");
+
+		VkCommandBuffer commandBuffer;
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = pool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+		if (dispatch.vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+			throw std::runtime_error("failed to allocate benchmark command buffer!");
+
+		//ÿֵܼȡһ֣ųڴӰ
+		auto timeRecording = [&](const auto& recordCall) {
+			double best = 1e30;
+			for (uint32_t round = 0; round < rounds; round++)
+			{
+				dispatch.vkResetCommandPool(device, pool, 0);
+				VkCommandBufferBeginInfo beginInfo{};
+				beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+				beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+				dispatch.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+				auto start = std::chrono::steady_clock::now();
+				for (uint32_t i = 0; i < calls; i++)
+					recordCall(i);
+				best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls);
+				dispatch.vkEndCommandBuffer(commandBuffer);
+			}
+			return best;
+		};
+
+		BindlessPushConstants constants{};
+		VkPipelineLayout layout = bindless.pipelineLayout();
+		VkViewport viewport{ 0.0f, 0.0f, static_cast<float>(swapChainExtent.width), static_cast<float>(swapChainExtent.height), 0.0f, 1.0f };
+
+		double pushLoader = timeRecording([&](uint32_t i) {
+			constants.drawIndex = i;
+			vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_ALL, 0, sizeof(constants), &constants);
+		});
+		double pushTable = timeRecording([&](uint32_t i) {
+			constants.drawIndex = i;
+			dispatch.vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_ALL, 0, sizeof(constants), &constants);
+		});
+		double viewportLoader = timeRecording([&](uint32_t) { vkCmdSetViewport(commandBuffer, 0, 1, &viewport); });
+		double viewportTable = timeRecording([&](uint32_t) { dispatch.vkCmdSetViewport(commandBuffer, 0, 1, &viewport); });
+
+		//ύֻ·漰GPU
+		auto timeSubmits = [&](PFN_vkQueueSubmit submit) {
+			auto start = std::chrono::steady_clock::now();
+			for (uint32_t i = 0; i < submits; i++)
+				submit(graphicsQueue, 0, nullptr, VK_NULL_HANDLE);
+			return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / submits;
+		};
+		double submitLoader = timeSubmits(&vkQueueSubmit);
+		double submitTable = timeSubmits(dispatch.vkQueueSubmit);
+		dispatch.vkQueueWaitIdle(graphicsQueue);
+
+		//̵߳ĽѭﲻCPUʱ䰴ǽʱ
+		auto print = [this](const char* name, uint32_t count, double loader, double table) {
+			printf("dispatch bench: %-20s loader %7.2f ns, table %7.2f ns, %+.1f%%\n", name, loader, table, (loader - table) / loader * 100.0);
+			if (benchmarkReport == nullptr)
+				return;
+			benchmarkReport->add(std::string("dispatch/") + name + "/loader", count, loader * count / 1e6, loader * count / 1e6, {}, "ns");
+			benchmarkReport->add(std::string("dispatch/") + name + "/table", count, table * count / 1e6, table * count / 1e6, {}, "ns");
+		};
+		print("vkCmdPushConstants", calls, pushLoader, pushTable);
+		print("vkCmdSetViewport", calls, viewportLoader, viewportTable);
+		print("vkQueueSubmit(empty)", submits, submitLoader, submitTable);
+
+		dispatch.vkDestroyCommandPool(device, pool, nullptr);
+	}
+
+	//޳ں˲ԣ̷߳޳ͬһSoAÿÿ봦ȽϱSSEAVX2
+	//ɼͱ汾һ
+	void runCullKernelBenchmark()
+	{
+		const uint32_t objectCounts[] = { 100000, 300000, 1000000 };
+		const CullKernel kernels[] = { CullKernel::Scalar, CullKernel::Sse, CullKernel::Avx2 };
+		const uint64_t objectsPerKernel = 50000000;		//ÿںٴô壬1Mʱ50
+		float aspect = static_cast<float>(swapChainExtent.width) / static_cast<float>(swapChainExtent.height);
+
+		for (uint32_t objectCount : objectCounts)
+		{
+			SceneStore store;
+			std::vector<GpuObject> gpuObjects;
+			GpuDrivenScene::generateObjects(objectCount, store, gpuObjects);
+			float viewProj[16];
+			GpuDrivenScene::cameraMatrix(objectCount, aspect, viewProj);
+			Frustum frustum = Frustum::fromMatrix(viewProj);
+			uint32_t expected = store.cull(frustum, CullKernel::Scalar);
+			uint32_t rounds = static_cast<uint32_t>(std::max<uint64_t>(3, objectsPerKernel / objectCount));
+
+			for (CullKernel kernel : kernels)
+			{
+				if (!cullKernelSupported(kernel))
+				{
+					printf("cull kernel bench: %7u objects, %-6s not supported by this CPU, skipped\n", objectCount, cullKernelName(kernel));
+					continue;
+				}
+
+				store.cull(frustum, kernel);
+				uint32_t visible = 0;
+				BenchmarkReport::Timer timer;
+				for (uint32_t i = 0; i < rounds; i++)
+					visible = store.cull(frustum, kernel);
+				double wallMs = timer.wallMs();
+				double cpuMs = timer.cpuMs();
+				if (visible != expected)
+					throw std::runtime_error(std::string("cull kernel ") + cullKernelName(kernel) + " disagrees with the scalar kernel!");
+
+				double objectsPerSecond = static_cast<double>(objectCount) * rounds / (wallMs / 1000.0);
+				printf("cull kernel bench: %7u objects, %-6s %8.1f M objects/s per core, %.3f ms per pass, %u visible\n",
+					objectCount, cullKernelName(kernel), objectsPerSecond / 1e6, wallMs / rounds, visible);
+				if (benchmarkReport != nullptr)
+					benchmarkReport->add("cull_kernel/objects:" + std::to_string(objectCount) + "/kernel:" + cullKernelName(kernel),
+						rounds, wallMs, cpuMs, { { "objects_per_second", objectsPerSecond }, { "visible", static_cast<double>(visible) } });
+			}
+		}
+	}
+
+	//زԣͬһֱOBJmeshletӳ.vkmeshӳLZ4ѹ.vkmeshϴ
+	//ʱϴΪֹļдҳȵǽ͸ƣǴ
+	void runMeshBenchmark()
+	{
+		const uint32_t gridSize = 512;		//512x512ıΣԼ26򶥵㡢52
+		const uint32_t rounds = 5;
+		std::filesystem::path directory = std::filesystem::temp_directory_path() / "vulkan01_mesh_bench";
+		std::filesystem::create_directories(directory);
+		const std::string paths[] = { (directory / "grid.obj").string(), (directory / "grid.vkmesh").string(), (directory / "grid_lz4.vkmesh").string() };
+		const char* names[] = { "obj", "vkmesh", "vkmesh-lz4" };
+
+		writeGridObj(paths[0], gridSize);
+		MeshData source = loadObj(paths[0]);
+		buildMeshlets(source);
+		writeMeshFile(source, paths[1], false);
+		writeMeshFile(source, paths[2], true);
+		double gpuMB = (source.vertices.size() * sizeof(MeshVertex) + source.indices.size() * sizeof(uint32_t) + source.meshlets.size() * sizeof(Meshlet) +
+			source.meshletVertices.size() * sizeof(uint32_t) + source.meshletTriangles.size()) / (1024.0 * 1024.0);
+
+		MeshBuffers buffers;
+		buffers.init(device, dispatch, allocator, stagingRing);
+		double parseMs = 0.0;
+		for (size_t loader = 0; loader < 3; loader++)
+		{
+			std::vector<double> roundMs;
+			BenchmarkReport::Timer timer;
+			for (uint32_t i = 0; i < rounds; i++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				if (loader == 0)
+				{
+					MeshData mesh = loadObj(paths[0]);
+					buildMeshlets(mesh);
+					buffers.load(mesh);
+				}
+				else
+				{
+					MeshFile file;
+					file.open(paths[loader]);
+					buffers.load(file);
+				}
+				stagingRing.waitIdle();
+				roundMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+				//û֡ȥȡȨֱͷ
+				stagingRing.discardAcquireBarriers();
+				buffers.release();
+			}
+			double wallMs = timer.wallMs();
+			double cpuMs = timer.cpuMs();
+
+			std::sort(roundMs.begin(), roundMs.end());
+			double p50 = roundMs[roundMs.size() / 2];
+			if (loader == 0)
+				parseMs = p50;
+			double fileMB = std::filesystem::file_size(paths[loader]) / (1024.0 * 1024.0);
+			printf("mesh bench: %-10s %6.1f MB file, load+upload p50 %8.2f ms, %7.1f MB/s to the GPU, %5.1fx vs obj\n",
+				names[loader], fileMB, p50, gpuMB / (p50 / 1000.0), parseMs / p50);
+			if (benchmarkReport != nullptr)
+				benchmarkReport->add(std::string("mesh_load/loader:") + names[loader], rounds, wallMs, cpuMs,
+					{ { "p50_ms", p50 }, { "file_bytes", fileMB * 1024.0 * 1024.0 } });
+		}
+		buffers.destroy();
+
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+	}
+
+	//õƽsize x sizeıΣ߶uvߣʱҪƽߣ
+	static void writeGridObj(const std::string& path, uint32_t size)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+			throw std::runtime_error("failed to create " + path + "!");
+		std::string text;
+		char line[128];
+		for (uint32_t y = 0; y <= size; y++)
+		{
+			for (uint32_t x = 0; x <= size; x++)
+			{
+				float height = 0.05f * std::sin(x * 0.1f) * std::cos(y * 0.1f);
+				text.append(line, snprintf(line, sizeof(line), "v %.4f %.4f %.4f\nvt %.4f %.4f\n",
+					x / static_cast<float>(size), height, y / static_cast<float>(size), x / static_cast<float>(size), y / static_cast<float>(size)));
+			}
+		}
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				uint32_t a = y * (size + 1) + x + 1;
+				uint32_t b = a + size + 1;
+				text.append(line, snprintf(line, sizeof(line), "f %u/%u %u/%u %u/%u %u/%u\n", a, a, a + 1, a + 1, b + 1, b + 1, b, b));
+			}
+		}
+		file.write(text.data(), text.size());
+	}
+
+	//Ⱦͼԣʾ֡Ⱦͼ޳ʱͼ񡢷Դ桢ϣ
+	//ʱÿ֡ϺϲͱǰʱԴ
+	void runRenderGraphBenchmark()
+	{
+		if (!features.dynamicRendering)
+		{
+			printf("render graph bench: skipped, needs dynamic rendering\n");
+			return;
+		}
+		const uint32_t rounds = 50;
+		std::vector<double> roundMs;
+		RenderGraph::Stats stats;
+		BenchmarkReport::Timer timer;
+		for (uint32_t i = 0; i < rounds; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			RenderGraph graph;
+			buildRenderGraph(graph);
+			roundMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+			stats = graph.getStats();
+			graph.destroy();
+		}
+		double wallMs = timer.wallMs();
+		double cpuMs = timer.cpuMs();
+
+		std::sort(roundMs.begin(), roundMs.end());
+		double p50 = roundMs[roundMs.size() / 2];
+		printf("render graph bench: %ux%u, compile p50 %.3f ms, %u/%u passes live, %u barriers in %u calls, "
+			"transient %.2f MB -> %.2f MB with aliasing\n", swapChainExtent.width, swapChainExtent.height, p50,
+			stats.passes - stats.culledPasses, stats.passes, stats.barriers, stats.barrierCalls,
+			stats.peakWithoutAliasing / (1024.0 * 1024.0), stats.peakWithAliasing / (1024.0 * 1024.0));
+		if (benchmarkReport != nullptr)
+			benchmarkReport->add("render_graph/compile", rounds, wallMs, cpuMs,
+				{ { "p50_ms", p50 }, { "barriers", static_cast<double>(stats.barriers) }, { "barrier_calls", static_cast<double>(stats.barrierCalls) },
+				{ "transient_bytes", static_cast<double>(stats.peakWithoutAliasing) }, { "aliased_bytes", static_cast<double>(stats.peakWithAliasing) } });
+	}
+
+	//ԣһ֡CPU/GPUͼCPUģ׼һ֡зֿϴиӣ
+	//ͼζлӰ͹գϴӺCPUģ⣩CPUضÿԼĻ壬ֻʾ˳
+	//Ȱ˳ִУÿύvkQueueWaitIdleٽʱߵȽÿ֡ʱύص
+	void runSchedulerBenchmark()
+	{
+		if (!features.timelineSemaphore)
+		{
+			printf("scheduler bench: skipped, needs timeline semaphores\n");
+			return;
+		}
+		const VkDeviceSize chunkSize = 8ull * 1024 * 1024;
+		const uint32_t uploadChunks = 4;
+		const uint32_t frameCount = 20;
+		const auto cpuWork = [](uint32_t microseconds) {
+			auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(microseconds);
+			while (std::chrono::steady_clock::now() < end)
+			{
+			}
+		};
+
+		//һأͬʱã
+		struct QueueSlot
+		{
+			QueueType type;
+			VkQueue queue;
+			uint32_t family;
+			VkCommandPool pool = VK_NULL_HANDLE;
+		};
+		uint32_t graphicsFamily = queueFamilies.graphicsFamily.value();
+		QueueSlot slots[] = {
+			{ QueueType::Graphics, graphicsQueue, graphicsFamily },
+			{ QueueType::Compute, computeQueue, queueFamilies.computeFamily.value_or(graphicsFamily) },
+			{ QueueType::Transfer, transferQueue, queueFamilies.transferFamily.value_or(graphicsFamily) },
+		};
+		for (auto& slot : slots)
+		{
+			VkCommandPoolCreateInfo poolInfo{};
+			poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			poolInfo.queueFamilyIndex = slot.family;
+			if (dispatch.vkCreateCommandPool(device, &poolInfo, nullptr, &slot.pool) != VK_SUCCESS)
+				throw std::runtime_error("failed to create benchmark command pool!");
+		}
+
+		VkBuffer staging, uploadTarget, particles, shadowSource, shadowTarget;
+		Allocation stagingAllocation, uploadAllocation, particleAllocation, shadowSourceAllocation, shadowTargetAllocation;
+		allocator.createBuffer(chunkSize * uploadChunks, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			staging, stagingAllocation);
+		allocator.createBuffer(chunkSize * uploadChunks, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, uploadTarget, uploadAllocation);
+		allocator.createBuffer(chunkSize * 4, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, particles, particleAllocation);
+		allocator.createBuffer(chunkSize * 4, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, shadowSource, shadowSourceAllocation);
+		allocator.createBuffer(chunkSize * 4, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, shadowTarget, shadowTargetAllocation);
+
+		//¼һΣÿ֡ظύһ֡ɺύ
+		auto record = [this](VkCommandPool pool, const std::function<void(VkCommandBuffer)>& commands) {
+			VkCommandBuffer commandBuffer;
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = pool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+			if (dispatch.vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+				throw std::runtime_error("failed to allocate benchmark command buffer!");
+			VkCommandBufferBeginInfo beginInfo{};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			dispatch.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+			commands(commandBuffer);
+			if (dispatch.vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+				throw std::runtime_error("failed to record benchmark command buffer!");
+			return commandBuffer;
+		};
+		std::vector<VkCommandBuffer> uploads;
+		for (uint32_t i = 0; i < uploadChunks; i++)
+		{
+			uploads.push_back(record(slots[2].pool, [&](VkCommandBuffer commandBuffer) {
+				VkBufferCopy region{ i * chunkSize, i * chunkSize, chunkSize };
+				dispatch.vkCmdCopyBuffer(commandBuffer, staging, uploadTarget, 1, &region);
+			}));
+		}
+		VkCommandBuffer particleUpdate = record(slots[1].pool, [&](VkCommandBuffer commandBuffer) {
+			dispatch.vkCmdFillBuffer(commandBuffer, particles, 0, VK_WHOLE_SIZE, 0x3f800000);
+		});
+		VkCommandBuffer shadows = record(slots[0].pool, [&](VkCommandBuffer commandBuffer) {
+			VkBufferCopy region{ 0, 0, chunkSize * 2 };
+			dispatch.vkCmdCopyBuffer(commandBuffer, shadowSource, shadowTarget, 1, &region);
+		});
+		VkCommandBuffer lighting = record(slots[0].pool, [&](VkCommandBuffer commandBuffer) {
+			VkBufferCopy region{ chunkSize * 2, chunkSize * 2, chunkSize * 2 };
+			dispatch.vkCmdCopyBuffer(commandBuffer, shadowSource, shadowTarget, 1, &region);
+		});
+
+		//飺˳һÿύȶп
+		uint64_t serialSubmits = 0;
+		auto submitAndWait = [&](VkQueue queue, VkCommandBuffer commandBuffer) {
+			VkSubmitInfo submitInfo{};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &commandBuffer;
+			if (dispatch.vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+				throw std::runtime_error("failed to submit benchmark command buffer!");
+			dispatch.vkQueueWaitIdle(queue);
+			serialSubmits++;
+		};
+		BenchmarkReport::Timer serialTimer;
+		for (uint32_t frame = 0; frame < frameCount; frame++)
+		{
+			cpuWork(2000);
+			for (VkCommandBuffer upload : uploads)
+				submitAndWait(transferQueue, upload);
+			submitAndWait(computeQueue, particleUpdate);
+			submitAndWait(graphicsQueue, shadows);
+			submitAndWait(graphicsQueue, lighting);
+			cpuWork(2000);
+			cpuWork(1000);
+		}
+		double serialMs = serialTimer.wallMs();
+		double serialCpuMs = serialTimer.cpuMs();
+
+		TimelineScheduler scheduler;
+		scheduler.init(physicalDevice, device, dispatch, features.waitSemaphores, features.signalSemaphore,
+			{ graphicsQueue, slots[0].family }, { computeQueue, slots[1].family }, { transferQueue, slots[2].family }, 2, true);
+		BenchmarkReport::Timer timelineTimer;
+		for (uint32_t frame = 0; frame < frameCount; frame++)
+		{
+			auto simulate = scheduler.addCpuTask("simulate", [&] { cpuWork(2000); });
+			std::vector<TimelineScheduler::TaskId> shadowDependencies;
+			for (VkCommandBuffer upload : uploads)
+				shadowDependencies.push_back(scheduler.addGpuTask("upload", QueueType::Transfer, upload));
+			auto particleTask = scheduler.addGpuTask("particles", QueueType::Compute, particleUpdate);
+			auto shadowTask = scheduler.addGpuTask("shadows", QueueType::Graphics, shadows, shadowDependencies);
+			auto lightingTask = scheduler.addGpuTask("lighting", QueueType::Graphics, lighting, { shadowTask, particleTask, simulate });
+			scheduler.addCpuTask("build next frame", [&] { cpuWork(2000); });
+			scheduler.addCpuTask("readback", [&] { cpuWork(1000); }, { lightingTask });
+			scheduler.waitIdle();
+		}
+		double timelineMs = timelineTimer.wallMs();
+		double timelineCpuMs = timelineTimer.cpuMs();
+		const TimelineScheduler::Stats& stats = scheduler.getStats();
+
+		printf("scheduler bench: serial + vkQueueWaitIdle %.2f ms/frame, %.1f submits/frame\n", serialMs / frameCount,
+			static_cast<double>(serialSubmits) / frameCount);
+		printf("scheduler bench: timeline scheduler       %.2f ms/frame, %.1f submits/frame (%.1f submit infos), %.2fx faster\n",
+			timelineMs / frameCount, static_cast<double>(stats.queueSubmits) / frameCount, static_cast<double>(stats.submitInfos) / frameCount,
+			serialMs / timelineMs);
+		scheduler.printStats();
+		if (!config.schedulerTracePath.empty())
+		{
+			if (scheduler.writeTrace(config.schedulerTracePath))
+				printf("scheduler bench: trace written to %s\n", config.schedulerTracePath.c_str());
+			else
+				printf("scheduler bench: failed to write %s\n", config.schedulerTracePath.c_str());
+		}
+		if (benchmarkReport != nullptr)
+		{
+			benchmarkReport->add("scheduler/mode:serial", frameCount, serialMs, serialCpuMs,
+				{ { "submits_per_frame", static_cast<double>(serialSubmits) / frameCount } });
+			benchmarkReport->add("scheduler/mode:timeline", frameCount, timelineMs, timelineCpuMs,
+				{ { "submits_per_frame", static_cast<double>(stats.queueSubmits) / frameCount },
+				{ "overlap_pct", stats.spanMs > 0.0 ? stats.overlapMs / stats.spanMs * 100.0 : 0.0 },
+				{ "concurrency", stats.spanMs > 0.0 ? stats.busyMs / stats.spanMs : 0.0 } });
+		}
+
+		scheduler.destroy();
+		for (auto& slot : slots)
+			dispatch.vkDestroyCommandPool(device, slot.pool, nullptr);
+		VkBuffer buffers[] = { staging, uploadTarget, particles, shadowSource, shadowTarget };
+		Allocation* allocations[] = { &stagingAllocation, &uploadAllocation, &particleAllocation, &shadowSourceAllocation, &shadowTargetAllocation };
+		for (size_t i = 0; i < 5; i++)
+		{
+			dispatch.vkDestroyBuffer(device, buffers[i], nullptr);
+			allocator.free(*allocations[i]);
+		}
+	}
+
+	//޳ԣͬһֱCPUơGPU޳+ӻơGPU޳+ӻƻʮ֡
+	//Ƚÿ֡¼CPUʱGPUʱ䣨p50
+	void runCullingBenchmark()
+	{
+		const uint32_t objectCounts[] = { 10000, 100000, 1000000 };
+		const CullingMode modes[] = { CullingMode::Cpu, CullingMode::Gpu, CullingMode::GpuNoCount };
+		const uint32_t warmupFrames = 5;		//ڷ֡ģʽǰ¼Ƶ֡
+		const uint32_t measuredFrames = 30;
+
+		for (uint32_t objectCount : objectCounts)
+		{
+			dispatch.vkDeviceWaitIdle(device);
+			gpuScene.destroy();
+			initGpuScene(objectCount, CullingMode::Cpu);
+
+			for (CullingMode mode : modes)
+			{
+				gpuScene.setMode(mode);
+				if (gpuScene.currentMode() != mode)
+				{
+					printf("culling bench: %7u objects, %-11s not supported, skipped\n", objectCount, cullingModeName(mode));
+					continue;
+				}
+
+				for (uint32_t i = 0; i < warmupFrames; i++)
+					drawFrame();
+				gpuFrameTimes = FrameBudget{};
+				double recordMs = 0.0;
+				BenchmarkReport::Timer timer;
+				for (uint32_t i = 0; i < measuredFrames; i++)
+				{
+					drawFrame();
+					recordMs += lastRecordMs;
+				}
+				double wallMs = timer.wallMs();
+
+				//֡ʱGPUȡ
+				dispatch.vkDeviceWaitIdle(device);
+				for (uint32_t frame = 0; frame < frames.size(); frame++)
+				{
+					double gpuMs = frameTimestamps.collect(frame);
+					if (gpuMs >= 0.0)
+						gpuFrameTimes.add(gpuMs);
+				}
+
+				double gpuMs = gpuFrameTimes.percentile(0.5);
+				if (gpuFrameTimes.count() > 0)
+					printf("culling bench: %7u objects, %-11s record %8.3f ms, gpu %8.3f ms, frame %8.3f ms\n", objectCount,
+						cullingModeName(mode), recordMs / measuredFrames, gpuMs, wallMs / measuredFrames);
+				else
+					printf("culling bench: %7u objects, %-11s record %8.3f ms, gpu n/a, frame %8.3f ms\n", objectCount,
+						cullingModeName(mode), recordMs / measuredFrames, wallMs / measuredFrames);
+				if (benchmarkReport != nullptr)
+					benchmarkReport->add("culling/objects:" + std::to_string(objectCount) + "/mode:" + cullingModeName(mode),
+						measuredFrames, recordMs, recordMs, { { "gpu_ms", gpuMs }, { "frame_ms", wallMs / measuredFrames } });
+			}
+		}
+
+		//ָָĳ֮֡ͳ
+		dispatch.vkDeviceWaitIdle(device);
+		gpuScene.destroy();
+		createGpuScene();
+		gpuFrameTimes = FrameBudget{};
+		cpuFrameTimes = FrameBudget{};
+		intervalStats = FrameStats{};
+		totalStats = FrameStats{};
+	}
+
+	//عԣضһ֡ͽ׼Ƚϣټÿ֡ʱûгԤ
+	bool checkRegression()
+	{
+		const RegressionScene* scene = findRegressionScene(config.regressionScene);
+		if (frameNumber == 0)
+			throw std::runtime_error("regression test rendered no frames!");
+
+		//ѭʱѾȹ豸Уʣ¼֡ʱҲ
+		for (uint32_t i = 0; i < frames.size(); i++)
+		{
+			double gpuMs = frameTimestamps.collect(i);
+			if (gpuMs >= 0.0)
+				gpuFrameTimes.add(gpuMs);
+		}
+
+		//عԲ棬ͼͼ
+		if (swapChain != VK_NULL_HANDLE || swapChainImageFormat != VK_FORMAT_R8G8B8A8_UNORM)
+			throw std::runtime_error("regression test needs the offscreen render target!");
+		RegressionImage image = readBackImage(swapChainImages[lastImageIndex]);
+
+		std::string goldenPath = config.goldenPath.empty() ? "golden/" + config.regressionScene + ".ppm" : config.goldenPath;
+		bool imagePassed = true;
+		if (config.updateGolden)
+		{
+			std::filesystem::path parent = std::filesystem::path(goldenPath).parent_path();
+			if (!parent.empty())
+				std::filesystem::create_directories(parent);
+			if (!image.writePpm(goldenPath))
+				throw std::runtime_error("failed to write golden image " + goldenPath + "!");
+			printf("regression: golden image written to %s\n", goldenPath.c_str());
+		}
+		else
+		{
+			RegressionImage golden;
+			if (!golden.readPpm(goldenPath))
+			{
+				printf("regression: cannot read golden image %s (create it with --update-golden or the regression-update target)\n", goldenPath.c_str());
+				imagePassed = false;
+			}
+			else
+			{
+				ImageDiff diff = compareImages(image, golden, config.imageTolerance);
+				imagePassed = diff.sizeMatches && diff.mismatchedPixels == 0;
+				if (!diff.sizeMatches)
+					printf("regression: image is %ux%u, golden is %ux%u\n", image.width, image.height, golden.width, golden.height);
+				else
+					printf("regression: image max channel diff %u, %llu pixels over tolerance %u -> %s\n", diff.maxChannelDiff,
+						static_cast<unsigned long long>(diff.mismatchedPixels), config.imageTolerance, imagePassed ? "ok" : "MISMATCH");
+			}
+		}
+
+		bool cpuPassed = cpuFrameTimes.check("cpu", config.cpuBudgetMs > 0.0 ? config.cpuBudgetMs : scene->cpuBudgetMs);
+		bool gpuPassed = gpuFrameTimes.check("gpu", config.gpuBudgetMs > 0.0 ? config.gpuBudgetMs : scene->gpuBudgetMs);
+		bool passed = imagePassed && cpuPassed && gpuPassed;
+		printf("regression: scene %s, %llu frames -> %s\n", scene->name, static_cast<unsigned long long>(frameNumber), passed ? "PASSED" : "FAILED");
+		return passed;
+	}
+
+	//ͼ񿽵ɼĻأͼRGBA8ÿ֡ʱTRANSFER_SRC
+	RegressionImage readBackImage(VkImage image)
+	{
+		RegressionImage result;
+		result.width = swapChainExtent.width;
+		result.height = swapChainExtent.height;
+		VkDeviceSize size = static_cast<VkDeviceSize>(result.width) * result.height * 4;
+
+		VkBuffer buffer;
+		Allocation allocation;
+		allocator.createBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffer, allocation);
+
+		VkCommandPool pool;
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = queueFamilies.graphicsFamily.value();
+		if (dispatch.vkCreateCommandPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+			throw std::runtime_error("failed to create readback command pool!");
+
+		VkCommandBuffer commandBuffer;
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = pool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+		if (dispatch.vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+			throw std::runtime_error("failed to allocate readback command buffer!");
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		dispatch.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+		VkBufferImageCopy region{};
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageExtent = { result.width, result.height, 1 };
+		dispatch.vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+
+		//ɼ
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		dispatch.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+		dispatch.vkEndCommandBuffer(commandBuffer);
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+		if (dispatch.vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+			throw std::runtime_error("failed to submit readback!");
+		dispatch.vkQueueWaitIdle(graphicsQueue);
+
+		result.rgba.resize(static_cast<size_t>(size));
+		memcpy(result.rgba.data(), allocation.mapped, result.rgba.size());
+
+		dispatch.vkDestroyCommandPool(device, pool, nullptr);
+		dispatch.vkDestroyBuffer(device, buffer, nullptr);
+		allocator.free(allocation);
+		return result;
+	}
+
+	//¼һ֡
+	void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+	{
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		if (dispatch.vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+			throw std::runtime_error("failed to begin recording command buffer!");
+
+		//ɵϴȡȨ
+		stagingRing.recordAcquireBarriers(commandBuffer);
+		gpuProfiler.beginFrame(commandBuffer, currentFrame);
+		frameTimestamps.begin(commandBuffer, currentFrame);
+
+		//޳ļɷҪȾ棻лбʱбӻƣ޳Ҳ
+		if (drawList.empty())
+			gpuScene.recordCull(commandBuffer);
+
+		//ɫ֡ű仯
+		float t = static_cast<float>(frameNumber % 256) / 255.0f;
+		VkClearValue clearColor = { {{ 0.1f, 0.2f * t, 0.4f, 1.0f }} };
+
+		if (config.renderGraph)
+		{
+			GPU_PROFILE_SCOPE(gpuProfiler, commandBuffer, "render graph");
+			renderGraphImageIndex = imageIndex;
+			renderGraphClearColor = clearColor;
+			renderGraph.setImportedImage(renderGraphBackbuffer, swapChainImages[imageIndex], swapChainImageViews[imageIndex]);
+			renderGraph.execute(commandBuffer);
+		}
+		else
+		{
+			GPU_PROFILE_SCOPE(gpuProfiler, commandBuffer, "render pass");
+			if (features.dynamicRendering)
+				recordDynamicRendering(commandBuffer, imageIndex, clearColor);
+			else
+				recordRenderPass(commandBuffer, imageIndex, clearColor);
+		}
+		frameTimestamps.end(commandBuffer, currentFrame);
+
+		if (dispatch.vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+			throw std::runtime_error("failed to record command buffer!");
+	}
+
+	//1.0·Ⱦ̸𲼾ת
+	void recordRenderPass(VkCommandBuffer commandBuffer, uint32_t imageIndex, const VkClearValue& clearColor)
+	{
+		VkRenderPassBeginInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderPassInfo.renderPass = renderPass;
+		renderPassInfo.framebuffer = swapChainFramebuffers[imageIndex];
+		renderPassInfo.renderArea.offset = { 0, 0 };
+		renderPassInfo.renderArea.extent = swapChainExtent;
+		renderPassInfo.clearValueCount = 1;
+		renderPassInfo.pClearValues = &clearColor;
+
+		if (drawList.empty())
+		{
+			dispatch.vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+			gpuScene.recordDraw(commandBuffer, swapChainExtent);
+			dispatch.vkCmdEndRenderPass(commandBuffer);
+			return;
+		}
+
+		//бƬ¼Ƴɶ壬ٰ˳ִ
+		dispatch.vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+		const auto& secondaries = recordDrawList(currentFrame, imageIndex);
+		dispatch.vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+		dispatch.vkCmdEndRenderPass(commandBuffer);
+	}
+
+	//̬Ⱦ·ֱȾͼͼתԼ
+	void recordDynamicRendering(VkCommandBuffer commandBuffer, uint32_t imageIndex, const VkClearValue& clearColor)
+	{
+		//ͻȡͼźȴͬһ׶Σ֤ͼúת
+		transitionImage(commandBuffer, swapChainImages[imageIndex], VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_NONE,
+			VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+
+		renderScene(commandBuffer, swapChainImageViews[imageIndex], imageIndex, clearColor);
+
+		//ֻضȾ̵finalLayoutһ
+		if (swapChain != VK_NULL_HANDLE)
+			transitionImage(commandBuffer, swapChainImages[imageIndex], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+				VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, VK_ACCESS_2_NONE);
+		else
+			transitionImage(commandBuffer, swapChainImages[imageIndex], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT);
+	}
+
+	//һŽСʽɫͼͼѾCOLOR_ATTACHMENT_OPTIMAL
+	void renderScene(VkCommandBuffer commandBuffer, VkImageView imageView, uint32_t imageIndex, const VkClearValue& clearColor)
+	{
+		VkRenderingAttachmentInfo colorAttachment{};
+		colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+		colorAttachment.imageView = imageView;
+		colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment.clearValue = clearColor;
+
+		VkRenderingInfo renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+		renderingInfo.flags = drawList.empty() ? 0 : VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+		renderingInfo.renderArea.offset = { 0, 0 };
+		renderingInfo.renderArea.extent = swapChainExtent;
+		renderingInfo.layerCount = 1;
+		renderingInfo.colorAttachmentCount = 1;
+		renderingInfo.pColorAttachments = &colorAttachment;
+
+		features.cmdBeginRendering(commandBuffer, &renderingInfo);
+		if (!drawList.empty())
+		{
+			const auto& secondaries = recordDrawList(currentFrame, imageIndex);
+			dispatch.vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+		}
+		else
+			gpuScene.recordDraw(commandBuffer, swapChainExtent);
+		features.cmdEndRendering(commandBuffer);
+	}
+
+	//ŸһͼѾֱTRANSFER_SRCTRANSFER_DST
+	void blitImage(VkCommandBuffer commandBuffer, VkImage src, const VkRect2D& srcRect, VkImage dst, const VkRect2D& dstRect, VkFilter filter)
+	{
+		VkImageBlit region{};
+		region.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.srcOffsets[0] = { srcRect.offset.x, srcRect.offset.y, 0 };
+		region.srcOffsets[1] = { srcRect.offset.x + static_cast<int32_t>(srcRect.extent.width), srcRect.offset.y + static_cast<int32_t>(srcRect.extent.height), 1 };
+		region.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.dstOffsets[0] = { dstRect.offset.x, dstRect.offset.y, 0 };
+		region.dstOffsets[1] = { dstRect.offset.x + static_cast<int32_t>(dstRect.extent.width), dstRect.offset.y + static_cast<int32_t>(dstRect.extent.height), 1 };
+		dispatch.vkCmdBlitImage(commandBuffer, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region, filter);
+	}
+
+	//ɫͼĲתsynchronization2ʱvkCmdPipelineBarrier2
+	//˻ϽӿڣõĽ׶κͷλöֵͬ
+	void transitionImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+		VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess)
+	{
+		VkImageSubresourceRange range{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		if (features.synchronization2)
+		{
+			VkImageMemoryBarrier2 barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+			barrier.srcStageMask = srcStage;
+			barrier.srcAccessMask = srcAccess;
+			barrier.dstStageMask = dstStage;
+			barrier.dstAccessMask = dstAccess;
+			barrier.oldLayout = oldLayout;
+			barrier.newLayout = newLayout;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = image;
+			barrier.subresourceRange = range;
+
+			VkDependencyInfo dependency{};
+			dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+			dependency.imageMemoryBarrierCount = 1;
+			dependency.pImageMemoryBarriers = &barrier;
+			features.cmdPipelineBarrier2(commandBuffer, &dependency);
+			return;
+		}
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = static_cast<VkAccessFlags>(srcAccess);
+		barrier.dstAccessMask = static_cast<VkAccessFlags>(dstAccess);
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange = range;
+		dispatch.vkCmdPipelineBarrier(commandBuffer, static_cast<VkPipelineStageFlags>(srcStage), static_cast<VkPipelineStageFlags>(dstStage),
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+
+	//ļ̳Ϣ̬Ⱦʱ̳иʽ̳Ⱦ̺֡
+	void fillInheritance(uint32_t imageIndex, VkCommandBufferInheritanceInfo& inheritance, VkCommandBufferInheritanceRenderingInfo& renderingInheritance)
+	{
+		inheritance = {};
+		inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		if (features.dynamicRendering)
+		{
+			renderingInheritance = {};
+			renderingInheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+			renderingInheritance.colorAttachmentCount = 1;
+			renderingInheritance.pColorAttachmentFormats = &swapChainImageFormat;
+			renderingInheritance.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+			inheritance.pNext = &renderingInheritance;
+			return;
+		}
+		inheritance.renderPass = renderPass;
+		inheritance.subpass = 0;
+		inheritance.framebuffer = swapChainFramebuffers[imageIndex];
+	}
+
+	const std::vector<VkCommandBuffer>& recordDrawList(uint32_t frame, uint32_t imageIndex)
+	{
+		VkCommandBufferInheritanceInfo inheritance{};
+		VkCommandBufferInheritanceRenderingInfo renderingInheritance{};
+		fillInheritance(imageIndex, inheritance, renderingInheritance);
+
+		return commandRecorder.record(jobs, frame, static_cast<uint32_t>(drawList.size()), drawsPerSlice, inheritance,
+			[this](VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end) { recordDraws(commandBuffer, begin, end); });
+	}
+
+	//¼ƻб[begin, end)һ
+	void recordDraws(VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end)
+	{
+		PROFILE_SCOPE("recordDraws");
+		for (uint32_t i = begin; i < end; i++)
+		{
+			const DrawItem& item = drawList[i];
+
+			VkClearAttachment attachment{};
+			attachment.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			attachment.colorAttachment = 0;
+			memcpy(attachment.clearValue.color.float32, item.color, sizeof(item.color));
+
+			VkClearRect rect{};
+			rect.rect.offset = { static_cast<int32_t>(item.x * swapChainExtent.width), static_cast<int32_t>(item.y * swapChainExtent.height) };
+			rect.rect.extent = { std::max(1u, static_cast<uint32_t>(item.width * swapChainExtent.width)),
+				std::max(1u, static_cast<uint32_t>(item.height * swapChainExtent.height)) };
+			rect.baseArrayLayer = 0;
+			rect.layerCount = 1;
+
+			dispatch.vkCmdClearAttachments(commandBuffer, 1, &attachment, 1, &rect);
+		}
+	}
+
+	//Ⱦһ֡դ -> ȡͼ -> ¼ -> ύ -> 
+	void drawFrame()
+	{
+		PROFILE_SCOPE("drawFrame");
+		auto frameStart = std::chrono::steady_clock::now();
+		FrameData& frame = frames[currentFrame];
+
+		//ֻCPUGPU֡ʱŻ
+		{
+			PROFILE_SCOPE("wait fence");
+			dispatch.vkWaitForFences(device, 1, &frame.inFlightFence, VK_TRUE, UINT64_MAX);
+		}
+		auto fenceDone = std::chrono::steady_clock::now();
+
+		//դȹˣ֡һֵGPUʱԶ
+		double gpuMs = frameTimestamps.collect(currentFrame);
+		if (gpuMs >= 0.0)
+			gpuFrameTimes.add(gpuMs);
+
+		//ں̨õĹߣȺ̨߳
+		shaderManager.update();
+
+		//Ⱦʱi̶֡ʹõiͼ
+		uint32_t imageIndex = currentFrame;
+		if (swapChain != VK_NULL_HANDLE)
+		{
+			PROFILE_SCOPE("acquire");
+			VkResult result = dispatch.vkAcquireNextImageKHR(device, swapChain, UINT64_MAX, frame.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+			if (result == VK_ERROR_OUT_OF_DATE_KHR)
+			{
+				recreateSwapChain();
+				return;
+			}
+			else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+			{
+				throw std::runtime_error("failed to acquire swap chain image!");
+			}
+		}
+		auto acquireDone = std::chrono::steady_clock::now();
+
+		//ύһ֡Ŷӵϴ˳ɵ
+		{
+			PROFILE_SCOPE("staging flush");
+			stagingRing.flush();
+		}
+
+		//ȷҪύդ
+		{
+			PROFILE_SCOPE("record");
+			auto recordStart = std::chrono::steady_clock::now();
+			dispatch.vkResetFences(device, 1, &frame.inFlightFence);
+			dispatch.vkResetCommandPool(device, frame.commandPool, 0);
+			commandRecorder.resetFrame(currentFrame);
+			bindless.beginFrame(currentFrame);
+			recordCommandBuffer(frame.commandBuffer, imageIndex);
+			lastRecordMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recordStart).count();
+		}
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		if (swapChain != VK_NULL_HANDLE)
+		{
+			submitInfo.waitSemaphoreCount = 1;
+			submitInfo.pWaitSemaphores = &frame.imageAvailableSemaphore;
+			submitInfo.pWaitDstStageMask = &waitStage;
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &renderFinishedSemaphores[imageIndex];
+		}
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &frame.commandBuffer;
+
+		{
+			PROFILE_SCOPE("submit");
+			if (dispatch.vkQueueSubmit(graphicsQueue, 1, &submitInfo, frame.inFlightFence) != VK_SUCCESS)
+				throw std::runtime_error("failed to submit draw command buffer!");
+		}
+
+		if (swapChain != VK_NULL_HANDLE)
+		{
+			PROFILE_SCOPE("present");
+			VkPresentInfoKHR presentInfo{};
+			presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+			presentInfo.waitSemaphoreCount = 1;
+			presentInfo.pWaitSemaphores = &renderFinishedSemaphores[imageIndex];
+			presentInfo.swapchainCount = 1;
+			presentInfo.pSwapchains = &swapChain;
+			presentInfo.pImageIndices = &imageIndex;
+
+			VkResult result = dispatch.vkQueuePresentKHR(presentQueue, &presentInfo);
+			if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+				recreateSwapChain();
+			else if (result != VK_SUCCESS)
+				throw std::runtime_error("failed to present swap chain image!");
+		}
+
+		lastImageIndex = imageIndex;
+		currentFrame = (currentFrame + 1) % static_cast<uint32_t>(frames.size());
+		frameNumber++;
+		Profiler::instance().collect();
+
+		//ͳƵȴʱ䣬֡ʱ䰴֡ʼ֮
+		auto toMs = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+		double fenceWait = toMs(fenceDone - frameStart);
+		double acquireWait = toMs(acquireDone - fenceDone);
+		double frameTime = frameNumber > 1 ? toMs(frameStart - lastFrameStart) : 0.0;
+		lastFrameStart = frameStart;
+
+		//عԵCPUʱֻһ֡ԼĹդ͵ͼ
+		if (!config.regressionScene.empty())
+			cpuFrameTimes.add(toMs(std::chrono::steady_clock::now() - frameStart) - fenceWait - acquireWait);
+
+		for (FrameStats* stats : { &intervalStats, &totalStats })
+		{
+			stats->frames++;
+			stats->frameMs += frameTime;
+			stats->fenceWaitMs += fenceWait;
+			stats->acquireWaitMs += acquireWait;
+		}
+		if (intervalStats.frames == statsInterval)
+		{
+			if (config.printStats)
+				intervalStats.print("frames");
+			intervalStats = FrameStats{};
+		}
+	}
+private:
+	//ϢṹϢ
+	//ֻõļĬϲҪVERBOSE֤ͲΪַ
+	void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo) {
+		createInfo = {};
+		createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+		createInfo.messageSeverity = config.debugSeverity;
+		createInfo.messageType = validationSettings.messageTypes();
+		createInfo.pfnUserCallback = debugCallback;
+		createInfo.pUserData = &debugLog;
+	}
+
+	//debugϢ
+	void setupDebugMessenger()
+	{
+		if (!enableValidationLayers) return;
+
+		VkDebugUtilsMessengerCreateInfoEXT createInfo{};
+		populateDebugMessengerCreateInfo(createInfo);
+
+		if (dispatch.vkCreateDebugUtilsMessengerEXT == nullptr ||
+			dispatch.vkCreateDebugUtilsMessengerEXT(instance, &createInfo, hostAllocator.callbacks(), &debugMessenger) != VK_SUCCESS) {
+			throw std::runtime_error("failed to set up debug messenger!");
+		}
+	}
+
+	//Ƿ
+	bool checkValidationLayerSupport()
+	{
+		uint32_t layerCount;
+		vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+
+		std::vector<VkLayerProperties> availableLayers(layerCount);
+		vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
+
+		//üǷ 
+		//check if all of the layers in validationLayers exist in the availableLayers list
+		//ⲿBǷAֻҪһûоͷfalse
+		for (const char* layerName : validationLayers)
+		{
+			bool layerFound = false;
+
+			for (const auto& layerProperties : availableLayers)
+			{
+				if (strcmp(layerName, layerProperties.layerName) == 0)
+				{
+					layerFound = true;
+					break;
+				}
+			}
+			
+			if (!layerFound)
+				return false;
+		}
+
+		//֤ԼṩչPerfλַʽ
+		uint32_t extensionCount = 0;
+		vkEnumerateInstanceExtensionProperties(ValidationSettings::layerName, &extensionCount, nullptr);
+		std::vector<VkExtensionProperties> layerExtensions(extensionCount);
+		vkEnumerateInstanceExtensionProperties(ValidationSettings::layerName, &extensionCount, layerExtensions.data());
+
+		validationSettings.select(config.validation, layerExtensions);
+		return validationSettings.supported();
+	}
+
+	//ʵǷ֧ĳչ
+	bool checkInstanceExtensionSupport(const char* extensionName)
+	{
+		uint32_t extensionCount = 0;
+		vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+
+		std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+		vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, availableExtensions.data());
+
+		for (const auto& extension : availableExtensions)
+		{
+			if (strcmp(extensionName, extension.extensionName) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	//ѯֵ֧ʵ汾õ1.31.1ϲܲѯ豸UUIDFeatures2
+	uint32_t getInstanceApiVersion()
+	{
+		auto func = (PFN_vkEnumerateInstanceVersion)vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion");
+		uint32_t version = VK_API_VERSION_1_0;
+		if (func != nullptr)
+			func(&version);
+
+		instanceApiVersion = VK_API_VERSION_1_0;
+		for (uint32_t candidate : { VK_API_VERSION_1_1, VK_API_VERSION_1_2, VK_API_VERSION_1_3 })
+		{
+			if (version >= candidate && config.maxApiVersion >= candidate)
+				instanceApiVersion = candidate;
+		}
+		return instanceApiVersion;
+	}
+
+	//ȡչ
+	std::vector<const char*> getRequiredExtensions() 
+	{
+		std::vector<const char*> extensions;
+
+		if (config.headless)
+		{
+			//޴ģʽVK_EXT_headless_surfaceûоֻȾ
+			//عRGBA8ͼ񣬸ʽղֶȷܻضͽ׼Ƚ
+			headlessSurfaceSupported = config.regressionScene.empty() && checkInstanceExtensionSupport(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+			if (headlessSurfaceSupported)
+			{
+				extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+				extensions.push_back(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+			}
+		}
+		else
+		{
+			uint32_t glfwExtensionCount = 0;
+			const char** glfwExtensions;
+			glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+
+			extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+		}
+
+		if (enableValidationLayers)
+		{
+			extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+			validationSettings.addExtensions(extensions);
+		}
+
+		return extensions;
+	}
+
+	//debugصֻˡӣʽ־߳
+	static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
+		VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
+		VkDebugUtilsMessageTypeFlagsEXT messageType,
+		const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
+		void* pUserData) {
+		static_cast<DebugLog*>(pUserData)->submit(messageSeverity, messageType, pCallbackData);
+		return VK_FALSE;
+	}
+
+	//ȡ豸չбʱҪ
+	std::vector<const char*> getRequiredDeviceExtensions()
+	{
+		std::vector<const char*> extensions;
+		if (surface != VK_NULL_HANDLE)
+			extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+		return extensions;
+	}
+
+	//豸Ƿ֧չ
+	bool checkDeviceExtensionSupport(VkPhysicalDevice device)
+	{
+		uint32_t extensionCount = 0;
+		dispatch.vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+		std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+		dispatch.vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+		for (const char* extensionName : getRequiredDeviceExtensions())
+		{
+			bool extensionFound = false;
+			for (const auto& extension : availableExtensions)
+			{
+				if (strcmp(extensionName, extension.extensionName) == 0)
+				{
+					extensionFound = true;
+					break;
+				}
+			}
+
+			if (!extensionFound)
+				return false;
+		}
+		return true;
+	}
+
+	//ȡ豸UUIDַ--deviceָ豸ʵ汾1.1ʱΪ
+	std::string getDeviceUUID(VkPhysicalDevice device)
+	{
+		VkPhysicalDeviceProperties deviceProperties;
+		dispatch.vkGetPhysicalDeviceProperties(device, &deviceProperties);
+		if (instanceApiVersion < VK_API_VERSION_1_1 || deviceProperties.apiVersion < VK_API_VERSION_1_1)
+			return "";
+
+		VkPhysicalDeviceIDProperties idProperties{};
+		idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &idProperties;
+		dispatch.vkGetPhysicalDeviceProperties2(device, &properties2);
+
+		//ʽΪ xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+		static const char* hex = "0123456789abcdef";
+		std::string uuid;
+		for (uint32_t i = 0; i < VK_UUID_SIZE; i++)
+		{
+			if (i == 4 || i == 6 || i == 8 || i == 10)
+				uuid += '-';
+			uuid += hex[idProperties.deviceUUID[i] >> 4];
+			uuid += hex[idProperties.deviceUUID[i] & 0xF];
+		}
+		return uuid;
+	}
+
+	//豸ǷҪͼζС֧չ
+	bool isDeviceSuitable(VkPhysicalDevice device) {
+		//豸Ķ
+		QueueFamilyIndices indice=findQueueFamily(device);
+		if (!indice.isComplete() || !checkDeviceExtensionSupport(device))
+			return false;
+
+		//бʱҪ֣ܳһָʽͳģʽ
+		if (surface != VK_NULL_HANDLE)
+		{
+			if (!indice.presentFamily.has_value())
+				return false;
+			SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device);
+			return !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
+		}
+		return true;
+	}
+
+	//豸ֻ֣ܴɫĶ
+	DeviceScore rateDeviceSuitability(VkPhysicalDevice device) {
+		VkPhysicalDeviceProperties  deviceProperties;
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		dispatch.vkGetPhysicalDeviceProperties(device, &deviceProperties);
+		dispatch.vkGetPhysicalDeviceMemoryProperties(device, &memoryProperties);
+
+		DeviceScore score;
+		score.suitable = isDeviceSuitable(device);
+
+		//豸ͣ >  > GPU > CPUʵ֣lavapipe
+		switch (deviceProperties.deviceType)
+		{
+		case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   score.typeScore = 10000; break;
+		case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: score.typeScore = 5000; break;
+		case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    score.typeScore = 2000; break;
+		case VK_PHYSICAL_DEVICE_TYPE_CPU:            score.typeScore = 100; break;
+		default: break;
+		}
+
+		//豸Դ棬ÿGB100֣4000
+		VkDeviceSize deviceLocalSize = 0;
+		for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+		{
+			if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+				deviceLocalSize += memoryProperties.memoryHeaps[i].size;
+		}
+		score.memoryScore = static_cast<uint32_t>(std::min<VkDeviceSize>(deviceLocalSize / (1024 * 1024 * 1024) * 100, 4000));
+
+		//壺жļԺͼβ
+		QueueFamilyIndices indice = findQueueFamily(device);
+		if (indice.computeFamily.has_value() && indice.computeFamily != indice.graphicsFamily)
+			score.queueScore += 300;
+		if (indice.transferFamily.has_value() && indice.transferFamily != indice.graphicsFamily && indice.transferFamily != indice.computeFamily)
+			score.queueScore += 200;
+
+		//Ӳƣߴͼ㹤С
+		score.limitScore = deviceProperties.limits.maxImageDimension2D / 64 +
+			deviceProperties.limits.maxComputeWorkGroupInvocations / 16;
+
+		//û豸Ȼãް󶨱߻·ֻں
+		DeviceFeatures candidateFeatures;
+		candidateFeatures.query(device, instanceApiVersion, config.maxApiVersion);
+		if (candidateFeatures.descriptorIndexing)
+			score.featureScore = 1000;
+
+		return score;
+	}
+
+	//Ѱ豸Ķ
+	QueueFamilyIndices findQueueFamily(VkPhysicalDevice device)
+	{
+		//г豸Ӧж
+		QueueFamilyIndices indice;
+		uint32_t queueFamilyCount = 0;
+		dispatch.vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
+
+		std::vector<VkQueueFamilyProperties> queueFamily(queueFamilyCount);
+		dispatch.vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamily.data());
+
+		//ĶУѡͼֵܳĶ
+		int i = 0;
+		for (const auto& queue : queueFamily)
+		{
+			VkBool32 presentSupport = false;
+			if (surface != VK_NULL_HANDLE)
+				dispatch.vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+
+			if (presentSupport && !indice.presentFamily.has_value())
+				indice.presentFamily = i;
+
+			if ((queue.queueFlags & VK_QUEUE_GRAPHICS_BIT) && !indice.graphicsFamily.has_value())
+			{
+				indice.graphicsFamily = i;
+			}
+			if ((queue.queueFlags & VK_QUEUE_GRAPHICS_BIT) && presentSupport)
+			{
+				indice.graphicsFamily = i;
+				indice.presentFamily = i;
+			}
+			if (indice.isComplete() && (surface == VK_NULL_HANDLE || indice.presentFamily == indice.graphicsFamily))
+				break;
+			i++;
+
+		}
+
+		//רõļʹ壬ܺͼζвй
+		std::optional<uint32_t> computeOnly;
+		std::optional<uint32_t> transferOnly;
+		for (uint32_t j = 0; j < queueFamilyCount; j++)
+		{
+			VkQueueFlags flags = queueFamily[j].queueFlags;
+			if (!computeOnly.has_value() && (flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT))
+				computeOnly = j;
+			if (!transferOnly.has_value() && (flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+				transferOnly = j;
+		}
+
+		//ûרöʱ˻صõĶ壨ͼκͼ嶼ִ֧䣩
+		if (computeOnly.has_value())
+			indice.computeFamily = computeOnly;
+		else if (indice.graphicsFamily.has_value() && (queueFamily[indice.graphicsFamily.value()].queueFlags & VK_QUEUE_COMPUTE_BIT))
+			indice.computeFamily = indice.graphicsFamily;
+
+		if (transferOnly.has_value())
+			indice.transferFamily = transferOnly;
+		else if (computeOnly.has_value())
+			indice.transferFamily = computeOnly;
+		else
+			indice.transferFamily = indice.graphicsFamily;
+
+		return indice;
+	}
+
+private:
+	AppConfig config;
+	bool enableValidationLayers = false;				//֤λOffʱ֤
+	ValidationSettings validationSettings;				//֤λӦʵpNext
+	bool headlessSurfaceSupported = false;
+	uint32_t instanceApiVersion = VK_API_VERSION_1_0;
+
+	GLFWwindow* window = nullptr;
+	VkInstance instance = VK_NULL_HANDLE;
+	VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
+	DebugLog debugLog;									//֤Ϣ첽
+	VkSurfaceKHR surface = VK_NULL_HANDLE;
+	HostAllocator hostAllocator;						//ʵʹ豸ڴص
+
+	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;   //豸
+	std::string deviceName;
+	VkDevice device = VK_NULL_HANDLE;					//߼豸
+	VkQueue  graphicsQueue = VK_NULL_HANDLE;			//о
+	VkQueue  computeQueue = VK_NULL_HANDLE;				//첽
+	VkQueue  transferQueue = VK_NULL_HANDLE;			//
+	VkQueue  presentQueue = VK_NULL_HANDLE;				//ֶ
+	QueueFamilyIndices queueFamilies;					//߼豸ʹõĶ
+
+	VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+	std::vector<VkImage> swapChainImages;				//ͼȾʱԼͼ
+	std::vector<Allocation> offscreenAllocations;
+	VkFormat swapChainImageFormat = VK_FORMAT_UNDEFINED;
+	VkExtent2D swapChainExtent{};
+	std::vector<VkImageView> swapChainImageViews;
+	std::vector<VkFramebuffer> swapChainFramebuffers;
+	std::vector<VkSemaphore> renderFinishedSemaphores;	//ÿŽͼһ
+	VkRenderPass renderPass = VK_NULL_HANDLE;				//̬Ⱦʱ
+	DeviceFeatures features;							//Э̺õ1.2/1.3
+	VulkanDispatch dispatch;							//ʵ豸ĺָ룬ĵö
+	BindlessRegistry bindless;							//ɫԴ飬
+	PipelineCache pipelineCache;						//ʱpipelineCache.handle()
+	MemoryAllocator allocator;							//лͼԴ涼
+	StagingRing stagingRing;							//㡢ݵϴͨ
+	JobSystem jobs;										//¼̳߳
+	ParallelCommandRecorder commandRecorder;			//ÿ߳ÿ֡һ
+	std::vector<DrawItem> drawList;						//Ļб
+	static constexpr uint32_t drawsPerSlice = 256;		//ÿ¼ƵĻ
+	GpuProfiler gpuProfiler;							//ÿ֡һʱѯ
+	FrameTimestamps frameTimestamps;					//عõÿ֡GPUʱ
+	FrameBudget cpuFrameTimes;
+	FrameBudget gpuFrameTimes;
+	ShaderManager shaderManager;						//ɫģĻ
+	GpuDrivenScene gpuScene;							//--objects壬GPU޳ӻ
+	MeshBuffers meshBuffers;							//--meshص
+	RenderGraph renderGraph;							//--render-graphͨʱͼ
+	uint32_t renderGraphBackbuffer = 0;					//ȾͼｻͼԴ
+	uint32_t renderGraphImageIndex = 0;					//¼Ƶͼɫͨ
+	VkClearValue renderGraphClearColor{};
+	double lastRecordMs = 0.0;							//һ֡¼CPUʱ
+	StartupTimer startupTimer;							//ʼ׶εĺʱ
+	BenchmarkReport* benchmarkReport = nullptr;			//׼ԳʱռƽʱΪ
+
+	std::vector<FrameData> frames;						//֡Դ
+	uint32_t currentFrame = 0;
+	uint32_t lastImageIndex = 0;						//ύһ֡Ⱦͼ񣬻عԴض
+	uint64_t frameNumber = 0;
+
+	static constexpr uint64_t statsInterval = 300;		//ÿ֡һͳ
+	FrameStats intervalStats;
+	FrameStats totalStats;
+	std::chrono::steady_clock::time_point lastFrameStart;
+	FramePacer pacer;
+};
+
+//ŷָϢ𣬱"warning,error"
+inline VkDebugUtilsMessageSeverityFlagsEXT parseSeverityList(const std::string& list)
+{
+	VkDebugUtilsMessageSeverityFlagsEXT mask = 0;
+	size_t begin = 0;
+	while (begin <= list.size())
+	{
+		size_t end = std::min(list.find(',', begin), list.size());
+		std::string name = list.substr(begin, end - begin);
+		if (name == "verbose")
+			mask |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT;
+		else if (name == "info")
+			mask |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
+		else if (name == "warning")
+			mask |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
+		else if (name == "error")
+			mask |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+		else
+			throw std::runtime_error("unknown debug severity: " + name);
+		begin = end + 1;
+	}
+	return mask;
+}
+
+//в
+inline AppConfig parseArgs(int argc, char** argv)
+{
+	AppConfig config;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--headless")
+			config.headless = true;
+		else if (arg == "--device" && i + 1 < argc)
+			config.deviceOverride = argv[++i];
+		else if (arg == "--frames-in-flight" && i + 1 < argc)
+			config.framesInFlight = std::max(1, std::stoi(argv[++i]));
+		else if (arg == "--frames" && i + 1 < argc)
+			config.frameCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--pacing" && i + 1 < argc)
+		{
+			std::string mode = argv[++i];
+			if (mode == "uncapped")
+				config.pacing = PacingMode::Uncapped;
+			else if (mode == "fps")
+				config.pacing = PacingMode::TargetFps;
+			else if (mode == "vsync")
+				config.pacing = PacingMode::Vsync;
+			else
+				throw std::runtime_error("unknown pacing mode: " + mode);
+		}
+		else if (arg == "--fps" && i + 1 < argc)
+		{
+			config.pacing = PacingMode::TargetFps;
+			config.targetFps = std::stod(argv[++i]);
+		}
+		else if (arg == "--idle-fps" && i + 1 < argc)
+			config.idleFps = std::max(0.1, std::stod(argv[++i]));
+		else if (arg == "--no-idle-throttle")
+			config.idleThrottle = false;
+		else if (arg == "--pipeline-cache" && i + 1 < argc)
+			config.pipelineCachePath = argv[++i];
+		else if (arg == "--no-pipeline-cache")
+			config.pipelineCachePath.clear();
+		else if (arg == "--staging-mb" && i + 1 < argc)
+			config.stagingRingMB = std::max(1, std::stoi(argv[++i]));
+		else if (arg == "--upload-bench" && i + 1 < argc)
+			config.uploadBenchMB = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--threads" && i + 1 < argc)
+			config.recordThreads = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--draws" && i + 1 < argc)
+			config.drawCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--record-bench")
+			config.recordBench = true;
+		else if (arg == "--trace" && i + 1 < argc)
+			config.tracePath = argv[++i];
+		else if (arg == "--startup-report" && i + 1 < argc)
+			config.startupReportPath = argv[++i];
+		else if (arg == "--startup-bench" && i + 1 < argc)
+			config.startupBenchRuns = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--validation" && i + 1 < argc)
+		{
+			std::string profile = argv[++i];
+			if (!parseValidationProfile(profile, config.validation))
+				throw std::runtime_error("unknown validation profile: " + profile);
+		}
+		else if (arg == "--validation-bench")
+			config.validationBench = true;
+		else if (arg == "--no-host-allocator")
+			config.hostAllocator = false;
+		else if (arg == "--dispatch-bench")
+			config.dispatchBench = true;
+		else if (arg == "--regression" && i + 1 < argc)
+		{
+			//֡--draws--framesٸ
+			const RegressionScene* scene = findRegressionScene(argv[++i]);
+			if (scene == nullptr)
+				throw std::runtime_error(std::string("unknown regression scene: ") + argv[i]);
+			config.regressionScene = scene->name;
+			config.headless = true;
+			config.pacing = PacingMode::Uncapped;
+			config.drawCount = scene->drawCount;
+			config.frameCount = scene->frames;
+		}
+		else if (arg == "--golden" && i + 1 < argc)
+			config.goldenPath = argv[++i];
+		else if (arg == "--update-golden")
+			config.updateGolden = true;
+		else if (arg == "--tolerance" && i + 1 < argc)
+			config.imageTolerance = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--cpu-budget" && i + 1 < argc)
+			config.cpuBudgetMs = std::stod(argv[++i]);
+		else if (arg == "--gpu-budget" && i + 1 < argc)
+			config.gpuBudgetMs = std::stod(argv[++i]);
+		else if (arg == "--max-api" && i + 1 < argc)
+		{
+			std::string version = argv[++i];
+			if (version == "1.0")
+				config.maxApiVersion = VK_API_VERSION_1_0;
+			else if (version == "1.1")
+				config.maxApiVersion = VK_API_VERSION_1_1;
+			else if (version == "1.2")
+				config.maxApiVersion = VK_API_VERSION_1_2;
+			else if (version == "1.3")
+				config.maxApiVersion = VK_API_VERSION_1_3;
+			else
+				throw std::runtime_error("unknown api version: " + version);
+		}
+		else if (arg == "--objects" && i + 1 < argc)
+			config.objectCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--culling" && i + 1 < argc)
+		{
+			std::string mode = argv[++i];
+			if (!parseCullingMode(mode, config.culling))
+				throw std::runtime_error("unknown culling mode: " + mode);
+		}
+		else if (arg == "--culling-bench")
+			config.cullingBench = true;
+		else if (arg == "--shader-dir" && i + 1 < argc)
+			config.shaderDir = argv[++i];
+		else if (arg == "--shader-src" && i + 1 < argc)
+			config.shaderSourceDir = argv[++i];
+		else if (arg == "--shader-cache" && i + 1 < argc)
+			config.shaderCacheDir = argv[++i];
+		else if (arg == "--hot-reload")
+			config.shaderHotReload = true;
+		else if (arg == "--cull-kernel" && i + 1 < argc)
+		{
+			std::string kernel = argv[++i];
+			if (!parseCullKernel(kernel, config.cullKernel))
+				throw std::runtime_error("unknown cull kernel: " + kernel);
+			if (!cullKernelSupported(config.cullKernel))
+				throw std::runtime_error("cull kernel " + kernel + " is not supported by this CPU");
+		}
+		else if (arg == "--cull-kernel-bench")
+			config.cullKernelBench = true;
+		else if (arg == "--mesh" && i + 1 < argc)
+			config.meshPath = argv[++i];
+		else if (arg == "--mesh-bench")
+			config.meshBench = true;
+		else if (arg == "--render-graph")
+			config.renderGraph = true;
+		else if (arg == "--render-graph-bench")
+			config.renderGraphBench = true;
+		else if (arg == "--scheduler-bench")
+			config.schedulerBench = true;
+		else if (arg == "--scheduler-trace" && i + 1 < argc)
+			config.schedulerTracePath = argv[++i];
+		else if (arg == "--debug-log" && i + 1 < argc)
+			config.debugLogPath = argv[++i];
+		else if (arg == "--debug-severity" && i + 1 < argc)
+			config.debugSeverity = parseSeverityList(argv[++i]);
+		else if (arg == "--debug-repeat" && i + 1 < argc)
+			config.debugRepeatLimit = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else
+			throw std::runtime_error("unknown argument: " + arg);
+	}
+	//GPUȾ¼ƣб߶壬߲ͬʱ
+	if ((config.objectCount > 0 || config.cullingBench) && config.drawCount > 0)
+		throw std::runtime_error("--objects/--culling-bench cannot be combined with --draws");
+	return config;
+}
@@ -0,0 +1,416 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include<atomic>
+#include<mutex>
+#include<vector>
+#include<cstdlib>
+#include<cstring>
+#include<cstdio>
+#include<cstdint>
+#include<algorithm>
+
+//ڴͨVkAllocationCallbacksӹʵ豸ȶCPU˵ķ䡣
+//С鰴СּӳȡʼڼĳԷŽֻarena
+//VkSystemAllocationScopeͳƵǰͷֵʱûͷŵķ
+class HostAllocator
+{
+public:
+	//ڵǰ߳ϳCOMMANDķ䶼arenaͷʱ黹destroyʱͷš
+	//ֻ߳Ч߳ͬʱķ䲻Ӱ
+	class ArenaScope
+	{
+	public:
+		explicit ArenaScope(HostAllocator& allocator) : previous(arenaTarget)
+		{
+			arenaTarget = &allocator;
+		}
+		~ArenaScope()
+		{
+			arenaTarget = previous;
+		}
+		ArenaScope(const ArenaScope&) = delete;
+		ArenaScope& operator=(const ArenaScope&) = delete;
+
+	private:
+		HostAllocator* previous;
+	};
+
+	struct ScopeStats
+	{
+		uint64_t allocations = 0;		//ۼƷ
+		uint64_t liveCount = 0;			//ûͷŵķ
+		uint64_t liveBytes = 0;
+		uint64_t peakBytes = 0;
+		uint64_t internalBytes = 0;		//Լ֪ͨڴ棨ִд룩
+		uint64_t internalPeakBytes = 0;
+	};
+
+	static constexpr uint32_t scopeCount = 5;
+
+	//enabledΪfalseʱcallbacks()nullptrԼķ
+	void init(bool enabled)
+	{
+		this->enabled = enabled;
+		for (auto& counters : scopes)
+			counters.reset();
+		for (uint32_t i = 0; i < classCount; i++)
+			pools[i].blockSize = minBlockSize << i;
+		arenaOffset = arenaChunkSize;
+		arenaUsed = 0;
+		systemAllocations.store(0, std::memory_order_relaxed);
+
+		vkCallbacks = {};
+		vkCallbacks.pUserData = this;
+		vkCallbacks.pfnAllocation = allocationCallback;
+		vkCallbacks.pfnReallocation = reallocationCallback;
+		vkCallbacks.pfnFree = freeCallback;
+		vkCallbacks.pfnInternalAllocation = internalAllocationCallback;
+		vkCallbacks.pfnInternalFree = internalFreeCallback;
+	}
+
+	//ĶԺܵãغarenaڴ黹ϵͳ
+	void destroy()
+	{
+		reportLeaks();
+		for (auto& pool : pools)
+		{
+			for (char* chunk : pool.chunks)
+				std::free(chunk);
+			pool.chunks.clear();
+			pool.freeList = nullptr;
+			pool.blocksInUse = 0;
+		}
+		for (char* chunk : arenaChunks)
+			std::free(chunk);
+		arenaChunks.clear();
+		arenaOffset = arenaChunkSize;
+	}
+
+	//vkCreate*/vkDestroy*pAllocatorͬһ󴴽ʱһ
+	const VkAllocationCallbacks* callbacks() const
+	{
+		return enabled ? &vkCallbacks : nullptr;
+	}
+
+	ScopeStats getStats(VkSystemAllocationScope scope) const
+	{
+		const ScopeCounters& counters = scopes[scope];
+		ScopeStats stats;
+		stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+		stats.liveCount = counters.liveCount.load(std::memory_order_relaxed);
+		stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+		stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+		stats.internalBytes = counters.internalBytes.load(std::memory_order_relaxed);
+		stats.internalPeakBytes = counters.internalPeakBytes.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	//ûͷŵķ0˵жû٣ʱûʱķ
+	uint64_t leakCount() const
+	{
+		uint64_t count = 0;
+		for (const auto& counters : scopes)
+			count += counters.liveCount.load(std::memory_order_relaxed);
+		return count;
+	}
+
+	void printStats() const
+	{
+		if (!enabled)
+			return;
+		printf("host allocator: %-8s %10s %12s %12s %12s\n", "scope", "allocs", "live bytes", "peak bytes", "internal pk");
+		for (uint32_t i = 0; i < scopeCount; i++)
+		{
+			ScopeStats stats = getStats(static_cast<VkSystemAllocationScope>(i));
+			printf("host allocator: %-8s %10llu %12llu %12llu %12llu\n", scopeName(i),
+				static_cast<unsigned long long>(stats.allocations), static_cast<unsigned long long>(stats.liveBytes),
+				static_cast<unsigned long long>(stats.peakBytes), static_cast<unsigned long long>(stats.internalPeakBytes));
+		}
+
+		size_t poolBytes = 0;
+		for (const auto& pool : pools)
+			poolBytes += pool.chunks.size() * poolChunkSize;
+		printf("host allocator: pools %zu KB, arena %zu KB used in %zu KB, %llu large allocations from the system\n",
+			poolBytes / 1024, arenaUsed / 1024, arenaChunks.size() * arenaChunkSize / 1024,
+			static_cast<unsigned long long>(systemAllocations.load(std::memory_order_relaxed)));
+	}
+
+private:
+	//ÿǰͷ¼СԴͷʱҪ
+	struct alignas(16) Header
+	{
+		uint64_t size;
+		uint32_t offset;	//㵽ָľ
+		uint8_t source;		//صļarenaϵͳ
+		uint8_t scope;
+	};
+	static_assert(sizeof(Header) == 16, "header must keep 16-byte alignment");
+
+	static constexpr uint8_t arenaSource = 0xFE;
+	static constexpr uint8_t systemSource = 0xFF;
+
+	//32ֽڵ4KB8ÿ64KBĿ
+	static constexpr uint32_t classCount = 8;
+	static constexpr size_t minBlockSize = 32;
+	static constexpr size_t poolChunkSize = 64 * 1024;
+	static constexpr size_t arenaChunkSize = 256 * 1024;
+
+	struct Pool
+	{
+		std::mutex mutex;
+		size_t blockSize = 0;
+		void* freeList = nullptr;		//пĿͷһп
+		std::vector<char*> chunks;
+		uint64_t blocksInUse = 0;
+	};
+
+	struct ScopeCounters
+	{
+		std::atomic<uint64_t> allocations{ 0 };
+		std::atomic<uint64_t> liveCount{ 0 };
+		std::atomic<uint64_t> liveBytes{ 0 };
+		std::atomic<uint64_t> peakBytes{ 0 };
+		std::atomic<uint64_t> internalBytes{ 0 };
+		std::atomic<uint64_t> internalPeakBytes{ 0 };
+
+		void reset()
+		{
+			allocations.store(0, std::memory_order_relaxed);
+			liveCount.store(0, std::memory_order_relaxed);
+			liveBytes.store(0, std::memory_order_relaxed);
+			peakBytes.store(0, std::memory_order_relaxed);
+			internalBytes.store(0, std::memory_order_relaxed);
+			internalPeakBytes.store(0, std::memory_order_relaxed);
+		}
+	};
+
+	static const char* scopeName(uint32_t scope)
+	{
+		static const char* names[scopeCount] = { "command", "object", "cache", "device", "instance" };
+		return scope < scopeCount ? names[scope] : "unknown";
+	}
+
+	static void updatePeak(std::atomic<uint64_t>& peak, uint64_t value)
+	{
+		uint64_t current = peak.load(std::memory_order_relaxed);
+		while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void trackAllocation(uint32_t scope, uint64_t size)
+	{
+		ScopeCounters& counters = scopes[scope];
+		counters.allocations.fetch_add(1, std::memory_order_relaxed);
+		counters.liveCount.fetch_add(1, std::memory_order_relaxed);
+		updatePeak(counters.peakBytes, counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+	}
+
+	void trackFree(uint32_t scope, uint64_t size)
+	{
+		ScopeCounters& counters = scopes[scope];
+		counters.liveCount.fetch_sub(1, std::memory_order_relaxed);
+		counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	//ҪֽͷݣҪ󳬹16ֽʱԤ
+	static size_t requiredBytes(size_t size, size_t alignment)
+	{
+		return sizeof(Header) + size + (alignment > alignof(Header) ? alignment - alignof(Header) : 0);
+	}
+
+	static uint32_t sizeClass(size_t bytes)
+	{
+		uint32_t index = 0;
+		while (index < classCount && (minBlockSize << index) < bytes)
+			index++;
+		return index;
+	}
+
+	char* poolTake(uint32_t index)
+	{
+		Pool& pool = pools[index];
+		std::lock_guard<std::mutex> lock(pool.mutex);
+		if (pool.freeList == nullptr)
+		{
+			char* chunk = static_cast<char*>(std::malloc(poolChunkSize));
+			if (chunk == nullptr)
+				return nullptr;
+			pool.chunks.push_back(chunk);
+			for (size_t offset = poolChunkSize; offset >= pool.blockSize; offset -= pool.blockSize)
+			{
+				void* block = chunk + offset - pool.blockSize;
+				*static_cast<void**>(block) = pool.freeList;
+				pool.freeList = block;
+			}
+		}
+		void* block = pool.freeList;
+		pool.freeList = *static_cast<void**>(block);
+		pool.blocksInUse++;
+		return static_cast<char*>(block);
+	}
+
+	void poolGive(uint32_t index, char* block)
+	{
+		Pool& pool = pools[index];
+		std::lock_guard<std::mutex> lock(pool.mutex);
+		*reinterpret_cast<void**>(block) = pool.freeList;
+		pool.freeList = block;
+		pool.blocksInUse--;
+	}
+
+	char* arenaTake(size_t bytes)
+	{
+		bytes = (bytes + alignof(Header) - 1) & ~(alignof(Header) - 1);
+		std::lock_guard<std::mutex> lock(arenaMutex);
+		if (arenaOffset + bytes > arenaChunkSize)
+		{
+			char* chunk = static_cast<char*>(std::malloc(arenaChunkSize));
+			if (chunk == nullptr)
+				return nullptr;
+			arenaChunks.push_back(chunk);
+			arenaOffset = 0;
+		}
+		char* base = arenaChunks.back() + arenaOffset;
+		arenaOffset += bytes;
+		arenaUsed += bytes;
+		return base;
+	}
+
+	void* allocate(size_t size, size_t alignment, VkSystemAllocationScope scope)
+	{
+		alignment = std::max(alignment, alignof(Header));
+		size_t bytes = requiredBytes(size, alignment);
+
+		char* base;
+		uint8_t source;
+		uint32_t index = sizeClass(bytes);
+		if (arenaTarget == this && scope != VK_SYSTEM_ALLOCATION_SCOPE_COMMAND && bytes <= arenaChunkSize / 4)
+		{
+			base = arenaTake(bytes);
+			source = arenaSource;
+		}
+		else if (index < classCount)
+		{
+			base = poolTake(index);
+			source = static_cast<uint8_t>(index);
+		}
+		else
+		{
+			base = static_cast<char*>(std::malloc(bytes));
+			source = systemSource;
+			systemAllocations.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (base == nullptr)
+			return nullptr;
+
+		uintptr_t address = reinterpret_cast<uintptr_t>(base) + sizeof(Header);
+		address = (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+		char* ptr = reinterpret_cast<char*>(address);
+		Header* header = reinterpret_cast<Header*>(ptr) - 1;
+		header->size = size;
+		header->offset = static_cast<uint32_t>(ptr - base);
+		header->source = source;
+		header->scope = static_cast<uint8_t>(scope);
+		trackAllocation(scope, size);
+		return ptr;
+	}
+
+	void release(void* memory)
+	{
+		if (memory == nullptr)
+			return;
+		Header* header = static_cast<Header*>(memory) - 1;
+		char* base = static_cast<char*>(memory) - header->offset;
+		trackFree(header->scope, header->size);
+
+		//arenaڴֻdestroyʱ黹
+		if (header->source == systemSource)
+			std::free(base);
+		else if (header->source != arenaSource)
+			poolGive(header->source, base);
+	}
+
+	void* reallocate(void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+	{
+		if (original == nullptr)
+			return allocate(size, alignment, scope);
+		if (size == 0)
+		{
+			release(original);
+			return nullptr;
+		}
+
+		//Ŀ黹ŵ¾ԭظĴС
+		Header* header = static_cast<Header*>(original) - 1;
+		alignment = std::max(alignment, alignof(Header));
+		if (header->source < classCount && reinterpret_cast<uintptr_t>(original) % alignment == 0 &&
+			header->offset + size <= pools[header->source].blockSize)
+		{
+			trackFree(header->scope, header->size);
+			trackAllocation(scope, size);
+			scopes[scope].allocations.fetch_sub(1, std::memory_order_relaxed);
+			header->size = size;
+			header->scope = static_cast<uint8_t>(scope);
+			return original;
+		}
+
+		void* memory = allocate(size, alignment, scope);
+		if (memory == nullptr)
+			return nullptr;
+		memcpy(memory, original, std::min<size_t>(size, header->size));
+		release(original);
+		return memory;
+	}
+
+	void reportLeaks() const
+	{
+		for (uint32_t i = 0; i < scopeCount; i++)
+		{
+			ScopeStats stats = getStats(static_cast<VkSystemAllocationScope>(i));
+			if (stats.liveCount > 0)
+				printf("host allocator: LEAK %llu allocations (%llu bytes) still live in %s scope\n",
+					static_cast<unsigned long long>(stats.liveCount), static_cast<unsigned long long>(stats.liveBytes), scopeName(i));
+		}
+	}
+
+	static VKAPI_ATTR void* VKAPI_CALL allocationCallback(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope)
+	{
+		return static_cast<HostAllocator*>(userData)->allocate(size, alignment, scope);
+	}
+
+	static VKAPI_ATTR void* VKAPI_CALL reallocationCallback(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+	{
+		return static_cast<HostAllocator*>(userData)->reallocate(original, size, alignment, scope);
+	}
+
+	static VKAPI_ATTR void VKAPI_CALL freeCallback(void* userData, void* memory)
+	{
+		static_cast<HostAllocator*>(userData)->release(memory);
+	}
+
+	static VKAPI_ATTR void VKAPI_CALL internalAllocationCallback(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope scope)
+	{
+		ScopeCounters& counters = static_cast<HostAllocator*>(userData)->scopes[scope];
+		updatePeak(counters.internalPeakBytes, counters.internalBytes.fetch_add(size, std::memory_order_relaxed) + size);
+	}
+
+	static VKAPI_ATTR void VKAPI_CALL internalFreeCallback(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope scope)
+	{
+		static_cast<HostAllocator*>(userData)->scopes[scope].internalBytes.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	bool enabled = false;
+	VkAllocationCallbacks vkCallbacks{};
+	ScopeCounters scopes[scopeCount];
+	Pool pools[classCount];
+
+	static inline thread_local HostAllocator* arenaTarget = nullptr;		//ǰ̴߳򿪵ArenaScopeĸ
+	std::mutex arenaMutex;
+	std::vector<char*> arenaChunks;
+	size_t arenaOffset = arenaChunkSize;
+	size_t arenaUsed = 0;
+	std::atomic<uint64_t> systemAllocations{ 0 };
+};
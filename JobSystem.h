@@ -0,0 +1,210 @@
+#pragma once
+
+#include<vector>
+#include<deque>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<atomic>
+#include<functional>
+#include<memory>
+#include<algorithm>
+#include<exception>
+#include<utility>
+
+//ȡ̳߳أÿ߳ԼУӶβȡԼ񣬿˾ʹӱ˵Ķ͵
+//parallelForģ߳ԼҲһ̣߳0׳쳣parallelFor׳
+class JobSystem
+{
+public:
+	using RangeFunction = std::function<void(uint32_t begin, uint32_t end, uint32_t worker)>;
+
+	~JobSystem()
+	{
+		stop();
+	}
+
+	//threadCounṭ߳Ϊ0ʱӲ߳
+	void start(uint32_t threadCount = 0)
+	{
+		stop();
+		if (threadCount == 0)
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		queues.clear();
+		for (uint32_t i = 0; i < threadCount; i++)
+			queues.push_back(std::make_unique<WorkerQueue>());
+
+		stopping = false;
+		for (uint32_t i = 1; i < threadCount; i++)
+			threads.emplace_back(&JobSystem::workerLoop, this, i);
+	}
+
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			stopping = true;
+		}
+		wakeCondition.notify_all();
+		for (auto& thread : threads)
+			thread.join();
+		threads.clear();
+	}
+
+	uint32_t workerCount() const { return static_cast<uint32_t>(queues.size()); }
+
+	//[0, count)grainгļηָͬһ̣߳ɺ󷵻
+	void parallelFor(uint32_t count, uint32_t grain, const RangeFunction& function)
+	{
+		if (count == 0)
+			return;
+		grain = std::max(grain, 1u);
+
+		uint32_t taskCount = (count + grain - 1) / grain;
+		if (queues.size() <= 1 || taskCount == 1)
+		{
+			for (uint32_t begin = 0; begin < count; begin += grain)
+				function(begin, std::min(begin + grain, count), 0);
+			return;
+		}
+
+		current = &function;
+		error = nullptr;
+		failed.store(false, std::memory_order_relaxed);
+		remaining.store(taskCount, std::memory_order_relaxed);
+
+		uint32_t workers = workerCount();
+		for (uint32_t task = 0; task < taskCount; task++)
+		{
+			uint32_t worker = static_cast<uint32_t>(static_cast<uint64_t>(task) * workers / taskCount);
+			uint32_t begin = task * grain;
+			std::lock_guard<std::mutex> lock(queues[worker]->mutex);
+			queues[worker]->tasks.push_back({ begin, std::min(begin + grain, count) });
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			generation++;
+		}
+		wakeCondition.notify_all();
+
+		runTasks(0);
+
+		//Լĺ͵ĶˣʣµǱִ߳е
+		std::unique_lock<std::mutex> lock(doneMutex);
+		doneCondition.wait(lock, [this] { return remaining.load(std::memory_order_acquire) == 0; });
+		current = nullptr;
+		if (error)
+			std::rethrow_exception(std::exchange(error, nullptr));
+	}
+
+	uint64_t stealCount() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+	struct Task
+	{
+		uint32_t begin;
+		uint32_t end;
+	};
+
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	void workerLoop(uint32_t worker)
+	{
+		uint64_t seenGeneration;
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			seenGeneration = generation;
+		}
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(wakeMutex);
+				wakeCondition.wait(lock, [&] { return stopping || generation != seenGeneration; });
+				if (stopping)
+					return;
+				seenGeneration = generation;
+			}
+			runTasks(worker);
+		}
+	}
+
+	void runTasks(uint32_t worker)
+	{
+		Task task;
+		while (popOwn(worker, task) || steal(worker, task))
+		{
+			//ʧܺʣµֻӲִУصparallelFor
+			if (!failed.load(std::memory_order_relaxed))
+			{
+				try
+				{
+					(*current)(task.begin, task.end, worker);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(doneMutex);
+					if (!error)
+						error = std::current_exception();
+					failed.store(true, std::memory_order_relaxed);
+				}
+			}
+			if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				std::lock_guard<std::mutex> lock(doneMutex);
+				doneCondition.notify_all();
+			}
+		}
+	}
+
+	bool popOwn(uint32_t worker, Task& task)
+	{
+		WorkerQueue& queue = *queues[worker];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+			return false;
+		task = queue.tasks.back();
+		queue.tasks.pop_back();
+		return true;
+	}
+
+	//һ߳̿ʼ͵öףԶ
+	bool steal(uint32_t worker, Task& task)
+	{
+		uint32_t workers = workerCount();
+		for (uint32_t i = 1; i < workers; i++)
+		{
+			WorkerQueue& victim = *queues[(worker + i) % workers];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				task = victim.tasks.front();
+				victim.tasks.pop_front();
+				steals.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::vector<std::thread> threads;
+
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+	uint64_t generation = 0;
+	bool stopping = false;
+
+	std::mutex doneMutex;
+	std::condition_variable doneCondition;
+	std::atomic<uint32_t> remaining{ 0 };
+	std::atomic<uint64_t> steals{ 0 };
+	const RangeFunction* current = nullptr;
+	std::exception_ptr error;		//һʧ쳣doneMutex
+	std::atomic<bool> failed{ false };
+};
@@ -0,0 +1,654 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDispatch.h"
+
+#include<vector>
+#include<map>
+#include<memory>
+#include<stdexcept>
+#include<algorithm>
+#include<cstdio>
+
+//ӷ
+enum class AllocationStrategy
+{
+	FreeList,	//䣬ͷʱϲڿ䣬ͨ
+	Buddy,		//㷨2ݷ䣬ͷſ죬ڲƬ
+	Linear,		//Է䣬ֻգʺÿ֡ʱ
+};
+
+//ԴͣԴ塢ͼ񣩺ͼ񲻷ͬһڴ
+//ͲbufferImageGranularityҪĳͻ
+enum class ResourceKind
+{
+	Linear,
+	OptimalImage,
+};
+
+//һηĽ
+struct Allocation
+{
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	VkDeviceSize offset = 0;
+	VkDeviceSize size = 0;
+	void* mapped = nullptr;			//ɼڴһֱӳ
+	uint32_t memoryType = 0;
+	int32_t pool = -1;				//ڵĳأ-1ʾ
+	uint32_t block = 0;				//ڵڴ
+};
+
+//һڴڲ㷨ֻƫ㣬Vulkan
+class RangeAllocator
+{
+public:
+	virtual ~RangeAllocator() = default;
+	virtual bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset) = 0;
+	virtual void free(VkDeviceSize offset, VkDeviceSize size) = 0;
+	virtual VkDeviceSize usedSize() const = 0;
+	virtual VkDeviceSize largestFreeRange() const = 0;
+	virtual bool empty() const = 0;
+};
+
+inline VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+//ƫ¼䣬
+class FreeListAllocator : public RangeAllocator
+{
+public:
+	explicit FreeListAllocator(VkDeviceSize capacity)
+	{
+		freeRanges[0] = capacity;
+	}
+
+	bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset) override
+	{
+		auto best = freeRanges.end();
+		VkDeviceSize bestOffset = 0;
+		for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it)
+		{
+			VkDeviceSize aligned = alignUp(it->first, alignment);
+			if (aligned + size > it->first + it->second)
+				continue;
+			if (best == freeRanges.end() || it->second < best->second)
+			{
+				best = it;
+				bestOffset = aligned;
+			}
+		}
+		if (best == freeRanges.end())
+			return false;
+
+		//µǰ׺ʣµĺ׺Ȼǿ
+		VkDeviceSize rangeStart = best->first;
+		VkDeviceSize rangeEnd = best->first + best->second;
+		freeRanges.erase(best);
+		if (bestOffset > rangeStart)
+			freeRanges[rangeStart] = bestOffset - rangeStart;
+		if (bestOffset + size < rangeEnd)
+			freeRanges[bestOffset + size] = rangeEnd - (bestOffset + size);
+
+		used += size;
+		offset = bestOffset;
+		return true;
+	}
+
+	void free(VkDeviceSize offset, VkDeviceSize size) override
+	{
+		used -= size;
+		auto it = freeRanges.emplace(offset, size).first;
+
+		//ͺһϲ
+		auto next = std::next(it);
+		if (next != freeRanges.end() && it->first + it->second == next->first)
+		{
+			it->second += next->second;
+			freeRanges.erase(next);
+		}
+		//ǰһϲ
+		if (it != freeRanges.begin())
+		{
+			auto prev = std::prev(it);
+			if (prev->first + prev->second == it->first)
+			{
+				prev->second += it->second;
+				freeRanges.erase(it);
+			}
+		}
+	}
+
+	VkDeviceSize usedSize() const override { return used; }
+	bool empty() const override { return used == 0; }
+
+	VkDeviceSize largestFreeRange() const override
+	{
+		VkDeviceSize largest = 0;
+		for (const auto& range : freeRanges)
+			largest = std::max(largest, range.second);
+		return largest;
+	}
+
+private:
+	VkDeviceSize used = 0;
+	std::map<VkDeviceSize, VkDeviceSize> freeRanges;	//ƫ -> С
+};
+
+//㷨2ݣÿһ׼¼пƫ
+class BuddyAllocator : public RangeAllocator
+{
+public:
+	explicit BuddyAllocator(VkDeviceSize capacity)
+	{
+		maxOrder = 0;
+		while ((minBlockSize << maxOrder) < capacity)
+			maxOrder++;
+		if ((minBlockSize << maxOrder) != capacity)
+			throw std::runtime_error("buddy allocator capacity must be a power of two!");
+		freeBlocks.resize(maxOrder + 1);
+		freeBlocks[maxOrder].push_back(0);
+	}
+
+	bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset) override
+	{
+		//ƫȻС룬ֻҪ鲻СڶҪ
+		uint32_t order = orderFor(std::max(size, alignment));
+		if (order > maxOrder)
+			return false;
+
+		uint32_t current = order;
+		while (current <= maxOrder && freeBlocks[current].empty())
+			current++;
+		if (current > maxOrder)
+			return false;
+
+		VkDeviceSize block = freeBlocks[current].back();
+		freeBlocks[current].pop_back();
+
+		//ѴһΪֱҪĴСһҵб
+		while (current > order)
+		{
+			current--;
+			freeBlocks[current].push_back(block + (minBlockSize << current));
+		}
+
+		used += minBlockSize << order;
+		allocatedOrders[block] = order;
+		offset = block;
+		return true;
+	}
+
+	void free(VkDeviceSize offset, VkDeviceSize) override
+	{
+		//ʱСܰҪŴԼ¼ĽΪ׼
+		auto allocated = allocatedOrders.find(offset);
+		if (allocated == allocatedOrders.end())
+			throw std::runtime_error("buddy allocator: freeing an offset that is not allocated!");
+		uint32_t order = allocated->second;
+		allocatedOrders.erase(allocated);
+		used -= minBlockSize << order;
+
+		//Ҳоͺϲһ׵Ŀ
+		while (order < maxOrder)
+		{
+			VkDeviceSize buddy = offset ^ (minBlockSize << order);
+			auto& list = freeBlocks[order];
+			auto it = std::find(list.begin(), list.end(), buddy);
+			if (it == list.end())
+				break;
+			list.erase(it);
+			offset = std::min(offset, buddy);
+			order++;
+		}
+		freeBlocks[order].push_back(offset);
+	}
+
+	VkDeviceSize usedSize() const override { return used; }
+	bool empty() const override { return used == 0; }
+
+	VkDeviceSize largestFreeRange() const override
+	{
+		for (uint32_t order = maxOrder + 1; order-- > 0;)
+		{
+			if (!freeBlocks[order].empty())
+				return minBlockSize << order;
+		}
+		return 0;
+	}
+
+	static constexpr VkDeviceSize minBlockSize = 256;
+
+private:
+	uint32_t orderFor(VkDeviceSize size) const
+	{
+		uint32_t order = 0;
+		while ((minBlockSize << order) < size)
+			order++;
+		return order;
+	}
+
+	uint32_t maxOrder = 0;
+	VkDeviceSize used = 0;
+	std::vector<std::vector<VkDeviceSize>> freeBlocks;
+	std::map<VkDeviceSize, uint32_t> allocatedOrders;	//ƫ -> 
+};
+
+//Է䣺ֻ䣬з䶼ͷź
+class LinearAllocator : public RangeAllocator
+{
+public:
+	explicit LinearAllocator(VkDeviceSize capacity) : capacity(capacity) {}
+
+	bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset) override
+	{
+		VkDeviceSize aligned = alignUp(head, alignment);
+		if (aligned + size > capacity)
+			return false;
+		offset = aligned;
+		head = aligned + size;
+		liveCount++;
+		return true;
+	}
+
+	void free(VkDeviceSize, VkDeviceSize) override
+	{
+		if (--liveCount == 0)
+			head = 0;
+	}
+
+	VkDeviceSize usedSize() const override { return head; }
+	VkDeviceSize largestFreeRange() const override { return capacity - head; }
+	bool empty() const override { return liveCount == 0; }
+
+private:
+	VkDeviceSize capacity;
+	VkDeviceSize head = 0;
+	uint32_t liveCount = 0;
+};
+
+//ÿڴ͵ͳ
+struct MemoryTypeStats
+{
+	uint32_t blockCount = 0;
+	uint32_t dedicatedCount = 0;
+	uint32_t allocationCount = 0;
+	VkDeviceSize reservedBytes = 0;		//ڴ
+	VkDeviceSize usedBytes = 0;			//ӷȥڴ
+	VkDeviceSize freeBytes = 0;
+	VkDeviceSize largestFreeRange = 0;
+
+	//1 - /ܿУԽӽ1ƬԽ
+	double fragmentation() const
+	{
+		return freeBytes == 0 ? 0.0 : 1.0 - static_cast<double>(largestFreeRange) / freeBytes;
+	}
+};
+
+//ԴӷÿڴͰ룬Դӿֳ
+class MemoryAllocator
+{
+public:
+	//dedicatedQueries豸1.1ʱvkGet*MemoryRequirements2ѯǷҪ
+	void init(VkPhysicalDevice physicalDevice, VkDevice device, const VulkanDispatch& dispatch, bool dedicatedQueries, VkDeviceSize blockSize = 64ull * 1024 * 1024)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+		this->dedicatedQueries = dedicatedQueries && dispatch.vkGetBufferMemoryRequirements2 != nullptr &&
+			dispatch.vkGetImageMemoryRequirements2 != nullptr;
+		this->blockSize = blockSize;
+		dispatch.vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+		VkPhysicalDeviceProperties properties;
+		dispatch.vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		maxAllocationCount = properties.limits.maxMemoryAllocationCount;
+		bufferImageGranularity = properties.limits.bufferImageGranularity;
+	}
+
+	//ѰҪڴ
+	uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+	{
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+		{
+			if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+				return i;
+		}
+
+		throw std::runtime_error("failed to find suitable memory type!");
+	}
+
+	//ڴ棬СҪʱ
+	Allocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+		ResourceKind kind, AllocationStrategy strategy = AllocationStrategy::FreeList, bool dedicated = false)
+	{
+		return allocate(requirements, properties, kind, strategy, dedicated, nullptr);
+	}
+
+	void free(Allocation& allocation)
+	{
+		if (allocation.memory == VK_NULL_HANDLE)
+			return;
+
+		if (allocation.pool < 0)
+		{
+			dispatch->vkFreeMemory(device, allocation.memory, nullptr);
+			deviceAllocationCount--;
+			auto& stats = dedicatedStats[allocation.memoryType];
+			stats.count--;
+			stats.bytes -= allocation.size;
+		}
+		else
+		{
+			Block& block = pools[allocation.pool].blocks[allocation.block];
+			block.ranges->free(allocation.offset, allocation.size);
+			block.allocationCount--;
+		}
+		allocation = Allocation{};
+	}
+
+	//岢ڴ棬Ҫʱ
+	void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+		VkBuffer& buffer, Allocation& allocation, AllocationStrategy strategy = AllocationStrategy::FreeList)
+	{
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = size;
+		bufferInfo.usage = usage;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		if (dispatch->vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
+			throw std::runtime_error("failed to create buffer!");
+
+		VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+		dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+		dedicatedInfo.buffer = buffer;
+		bool dedicated = false;
+		VkMemoryRequirements memRequirements = queryRequirements(buffer, VK_NULL_HANDLE, dedicated);
+		allocation = allocate(memRequirements, properties, ResourceKind::Linear, strategy, dedicated, &dedicatedInfo);
+		dispatch->vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset);
+	}
+
+	//ͼ񲢰ڴ棬dedicatedΪfalseʱҲҪǷ
+	void createImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags properties,
+		VkImage& image, Allocation& allocation, bool dedicated = false)
+	{
+		if (dispatch->vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS)
+			throw std::runtime_error("failed to create image!");
+
+		VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+		dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+		dedicatedInfo.image = image;
+		bool driverDedicated = false;
+		VkMemoryRequirements memRequirements = queryRequirements(VK_NULL_HANDLE, image, driverDedicated);
+		ResourceKind kind = imageInfo.tiling == VK_IMAGE_TILING_OPTIMAL ? ResourceKind::OptimalImage : ResourceKind::Linear;
+		allocation = allocate(memRequirements, properties, kind, AllocationStrategy::FreeList, dedicated || driverDedicated, &dedicatedInfo);
+		dispatch->vkBindImageMemory(device, image, allocation.memory, allocation.offset);
+	}
+
+	//Ѿ˵Ŀ黹
+	void releaseEmptyBlocks()
+	{
+		for (auto& pool : pools)
+		{
+			for (auto& block : pool.blocks)
+			{
+				if (block.memory != VK_NULL_HANDLE && block.allocationCount == 0)
+					destroyBlock(block);
+			}
+		}
+	}
+
+	void destroy()
+	{
+		for (auto& pool : pools)
+		{
+			for (auto& block : pool.blocks)
+			{
+				if (block.memory != VK_NULL_HANDLE)
+					destroyBlock(block);
+			}
+		}
+		pools.clear();
+	}
+
+	std::vector<MemoryTypeStats> getStats() const
+	{
+		std::vector<MemoryTypeStats> stats(memoryProperties.memoryTypeCount);
+		for (const auto& pool : pools)
+		{
+			MemoryTypeStats& s = stats[pool.memoryType];
+			for (const auto& block : pool.blocks)
+			{
+				if (block.memory == VK_NULL_HANDLE)
+					continue;
+				s.blockCount++;
+				s.allocationCount += block.allocationCount;
+				s.reservedBytes += block.size;
+				s.usedBytes += block.ranges->usedSize();
+				s.freeBytes += block.size - block.ranges->usedSize();
+				s.largestFreeRange = std::max(s.largestFreeRange, block.ranges->largestFreeRange());
+			}
+		}
+		for (const auto& dedicated : dedicatedStats)
+		{
+			MemoryTypeStats& s = stats[dedicated.first];
+			s.dedicatedCount += dedicated.second.count;
+			s.allocationCount += dedicated.second.count;
+			s.reservedBytes += dedicated.second.bytes;
+			s.usedBytes += dedicated.second.bytes;
+		}
+		return stats;
+	}
+
+	void printStats() const
+	{
+		auto stats = getStats();
+		printf("memory: %u device allocations (limit %u), bufferImageGranularity %llu\n",
+			deviceAllocationCount, maxAllocationCount, static_cast<unsigned long long>(bufferImageGranularity));
+		for (uint32_t i = 0; i < stats.size(); i++)
+		{
+			const MemoryTypeStats& s = stats[i];
+			if (s.blockCount == 0 && s.dedicatedCount == 0)
+				continue;
+			printf("  type %u: %u blocks, %u dedicated, %u allocations, reserved %.2f MB, used %.2f MB, fragmentation %.1f%%\n",
+				i, s.blockCount, s.dedicatedCount, s.allocationCount,
+				s.reservedBytes / (1024.0 * 1024.0), s.usedBytes / (1024.0 * 1024.0), s.fragmentation() * 100.0);
+		}
+	}
+
+private:
+	struct Block
+	{
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize size = 0;
+		void* mapped = nullptr;
+		uint32_t allocationCount = 0;
+		std::unique_ptr<RangeAllocator> ranges;
+	};
+
+	struct Pool
+	{
+		uint32_t memoryType = 0;
+		ResourceKind kind = ResourceKind::Linear;
+		AllocationStrategy strategy = AllocationStrategy::FreeList;
+		std::vector<Block> blocks;
+	};
+
+	struct DedicatedStats
+	{
+		uint32_t count = 0;
+		VkDeviceSize bytes = 0;
+	};
+
+	//dedicatedInfoǿʱVkMemoryAllocateInfo棬ڴֻһԴ
+	Allocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+		ResourceKind kind, AllocationStrategy strategy, bool dedicated, const VkMemoryDedicatedAllocateInfo* dedicatedInfo)
+	{
+		uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+
+		if (dedicated || requirements.size > blockSize / 2)
+			return allocateDedicated(requirements.size, memoryType, dedicatedQueries ? dedicatedInfo : nullptr);
+
+		Pool& pool = getPool(memoryType, kind, strategy);
+		Allocation allocation;
+		allocation.memoryType = memoryType;
+		allocation.size = requirements.size;
+		allocation.pool = static_cast<int32_t>(&pool - pools.data());
+
+		//еĿңҲ¿飬¿ȷŽѻյλ
+		uint32_t emptySlot = static_cast<uint32_t>(pool.blocks.size());
+		for (uint32_t i = 0; i < pool.blocks.size(); i++)
+		{
+			if (pool.blocks[i].memory == VK_NULL_HANDLE)
+			{
+				emptySlot = std::min(emptySlot, i);
+				continue;
+			}
+			if (pool.blocks[i].ranges->allocate(requirements.size, requirements.alignment, allocation.offset))
+			{
+				allocation.block = i;
+				return finish(allocation, pool.blocks[i]);
+			}
+		}
+
+		if (emptySlot == pool.blocks.size())
+			pool.blocks.emplace_back();
+		pool.blocks[emptySlot] = createBlock(memoryType, strategy);
+		allocation.block = emptySlot;
+		if (!pool.blocks[emptySlot].ranges->allocate(requirements.size, requirements.alignment, allocation.offset))
+			throw std::runtime_error("allocation does not fit in a new memory block!");
+		return finish(allocation, pool.blocks[emptySlot]);
+	}
+
+	Pool& getPool(uint32_t memoryType, ResourceKind kind, AllocationStrategy strategy)
+	{
+		for (auto& pool : pools)
+		{
+			if (pool.memoryType == memoryType && pool.kind == kind && pool.strategy == strategy)
+				return pool;
+		}
+		Pool pool;
+		pool.memoryType = memoryType;
+		pool.kind = kind;
+		pool.strategy = strategy;
+		pools.push_back(std::move(pool));
+		return pools.back();
+	}
+
+	//1.1ʱͬʱȡVkMemoryDedicatedRequirementsҪʱdedicatedΪtrue
+	VkMemoryRequirements queryRequirements(VkBuffer buffer, VkImage image, bool& dedicated) const
+	{
+		dedicated = false;
+		VkMemoryRequirements requirements;
+		if (!dedicatedQueries)
+		{
+			if (buffer != VK_NULL_HANDLE)
+				dispatch->vkGetBufferMemoryRequirements(device, buffer, &requirements);
+			else
+				dispatch->vkGetImageMemoryRequirements(device, image, &requirements);
+			return requirements;
+		}
+
+		VkMemoryDedicatedRequirements dedicatedRequirements{};
+		dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+		VkMemoryRequirements2 requirements2{};
+		requirements2.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+		requirements2.pNext = &dedicatedRequirements;
+		if (buffer != VK_NULL_HANDLE)
+		{
+			VkBufferMemoryRequirementsInfo2 info{};
+			info.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+			info.buffer = buffer;
+			dispatch->vkGetBufferMemoryRequirements2(device, &info, &requirements2);
+		}
+		else
+		{
+			VkImageMemoryRequirementsInfo2 info{};
+			info.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+			info.image = image;
+			dispatch->vkGetImageMemoryRequirements2(device, &info, &requirements2);
+		}
+		dedicated = dedicatedRequirements.requiresDedicatedAllocation == VK_TRUE || dedicatedRequirements.prefersDedicatedAllocation == VK_TRUE;
+		return requirements2.memoryRequirements;
+	}
+
+	VkDeviceMemory allocateDeviceMemory(VkDeviceSize size, uint32_t memoryType, void** mapped, const void* next = nullptr)
+	{
+		if (deviceAllocationCount >= maxAllocationCount)
+			throw std::runtime_error("maxMemoryAllocationCount exceeded!");
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.pNext = next;
+		allocInfo.allocationSize = size;
+		allocInfo.memoryTypeIndex = memoryType;
+
+		VkDeviceMemory memory;
+		if (dispatch->vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+			throw std::runtime_error("failed to allocate device memory!");
+		deviceAllocationCount++;
+
+		//ɼڴһֱӳţʡȥÿmap/unmap
+		*mapped = nullptr;
+		if (memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+			dispatch->vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, mapped);
+		return memory;
+	}
+
+	Allocation allocateDedicated(VkDeviceSize size, uint32_t memoryType, const VkMemoryDedicatedAllocateInfo* dedicatedInfo)
+	{
+		Allocation allocation;
+		allocation.memoryType = memoryType;
+		allocation.size = size;
+		allocation.memory = allocateDeviceMemory(size, memoryType, &allocation.mapped, dedicatedInfo);
+
+		auto& stats = dedicatedStats[memoryType];
+		stats.count++;
+		stats.bytes += size;
+		return allocation;
+	}
+
+	Block createBlock(uint32_t memoryType, AllocationStrategy strategy)
+	{
+		Block block;
+		block.size = blockSize;
+		block.memory = allocateDeviceMemory(blockSize, memoryType, &block.mapped);
+		switch (strategy)
+		{
+		case AllocationStrategy::FreeList: block.ranges = std::make_unique<FreeListAllocator>(blockSize); break;
+		case AllocationStrategy::Buddy:    block.ranges = std::make_unique<BuddyAllocator>(blockSize); break;
+		case AllocationStrategy::Linear:   block.ranges = std::make_unique<LinearAllocator>(blockSize); break;
+		}
+		return block;
+	}
+
+	void destroyBlock(Block& block)
+	{
+		dispatch->vkFreeMemory(device, block.memory, nullptr);
+		deviceAllocationCount--;
+		block.memory = VK_NULL_HANDLE;
+		block.mapped = nullptr;
+		block.ranges.reset();
+	}
+
+	Allocation finish(Allocation& allocation, Block& block)
+	{
+		allocation.memory = block.memory;
+		allocation.mapped = block.mapped ? static_cast<char*>(block.mapped) + allocation.offset : nullptr;
+		block.allocationCount++;
+		return allocation;
+	}
+
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;
+	bool dedicatedQueries = false;
+	VkPhysicalDeviceMemoryProperties memoryProperties{};
+	VkDeviceSize blockSize = 0;
+	VkDeviceSize bufferImageGranularity = 1;
+	uint32_t maxAllocationCount = 4096;
+	uint32_t deviceAllocationCount = 0;
+	std::vector<Pool> pools;
+	std::map<uint32_t, DedicatedStats> dedicatedStats;
+};
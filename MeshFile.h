@@ -0,0 +1,806 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "MemoryAllocator.h"
+#include "StagingRing.h"
+
+#include<vector>
+#include<string>
+#include<fstream>
+#include<cstdint>
+#include<cstring>
+#include<cmath>
+#include<stdexcept>
+#include<algorithm>
+#include<cstdio>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//.vkmeshתɵĶͷ+α+ݣΰ64ֽڶ룬ȫСˡ
+//ʱӳļֱӴӳڴ渴ƣѹݴ滷м䲻پĻ塣
+//ֱ˾汾ţļֱӾܾأת
+constexpr uint32_t meshFileMagic = 0x484D4B56;		//"VKMH"
+constexpr uint32_t meshFileVersion = 1;
+constexpr uint64_t meshSectionAlignment = 64;
+constexpr uint32_t meshLz4BlockSize = 256 * 1024;	//ѹΰѹÿѹݴ滷һΣ1MBĻҲŵ
+
+enum class MeshSection : uint32_t
+{
+	Vertices = 1,
+	Indices = 2,
+	Submeshes = 3,
+	Meshlets = 4,
+	MeshletVertices = 5,		//ÿmeshletõĶ
+	MeshletTriangles = 6,		//ÿ3ֽڣmeshletڵľֲ
+};
+
+enum class MeshCompression : uint32_t
+{
+	None = 0,
+	Lz4 = 1,		//LZ4ʽǿѹĴСٽӸ
+};
+
+struct MeshVertex
+{
+	float position[3];
+	float normal[3];
+	float uv[2];
+};
+
+//һӦOBJһ/glTFһͼԪ
+struct Submesh
+{
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	uint32_t firstMeshlet;
+	uint32_t meshletCount;
+	float center[3];		//Χ
+	float radius;
+};
+
+struct Meshlet
+{
+	uint32_t vertexOffset;		//MeshletVerticesʼλ
+	uint32_t triangleOffset;	//MeshletTrianglesʼֽ
+	uint32_t vertexCount;
+	uint32_t triangleCount;
+};
+
+struct MeshFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t sectionCount;
+	uint32_t vertexStride;		//sizeof(MeshVertex)ͬʱܾ
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint32_t submeshCount;
+	uint32_t meshletCount;
+	uint64_t fileSize;			//ضϵļ
+	uint64_t reserved;
+};
+
+struct MeshFileSection
+{
+	uint32_t type;				//MeshSection
+	uint32_t compression;		//MeshCompression
+	uint64_t offset;			//ļͷ㣬meshSectionAlignment
+	uint64_t storedSize;		//ļռֽ
+	uint64_t rawSize;			//ѹֽ
+};
+
+//תߺͽCPU
+struct MeshData
+{
+	std::vector<MeshVertex> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<Submesh> submeshes;
+	std::vector<Meshlet> meshlets;
+	std::vector<uint32_t> meshletVertices;
+	std::vector<uint8_t> meshletTriangles;
+};
+
+//LZ4ʽѹͽѹliblz4LZ4_compress_default/LZ4_decompress_safeͨ
+namespace lz4
+{
+	//̰ƥ䣬һϣһλãѹֻתʱٶȹþ
+	inline std::vector<uint8_t> compress(const uint8_t* src, size_t size)
+	{
+		const size_t minMatch = 4;
+		const size_t lastLiterals = 5;		//5ֽڱ
+		const size_t matchLimit = 12;		//һƥҪڿβ12ֽ֮ǰʼ
+		const size_t maxOffset = 65535;
+
+		std::vector<uint8_t> out;
+		out.reserve(size + size / 255 + 16);
+		std::vector<int64_t> table(1 << 16, -1);
+		auto hash = [src](size_t p) {
+			uint32_t v;
+			memcpy(&v, src + p, sizeof(v));
+			return (v * 2654435761u) >> 16;
+		};
+		auto writeLength = [&out](size_t length) {
+			for (; length >= 255; length -= 255)
+				out.push_back(255);
+			out.push_back(static_cast<uint8_t>(length));
+		};
+		auto writeLiterals = [&](size_t anchor, size_t literal, size_t matchCode) {
+			out.push_back(static_cast<uint8_t>((std::min<size_t>(literal, 15) << 4) | std::min<size_t>(matchCode, 15)));
+			if (literal >= 15)
+				writeLength(literal - 15);
+			out.insert(out.end(), src + anchor, src + anchor + literal);
+		};
+
+		size_t anchor = 0;
+		size_t ip = 0;
+		while (size > matchLimit && ip + matchLimit < size)
+		{
+			uint32_t h = hash(ip);
+			int64_t candidate = table[h];
+			table[h] = static_cast<int64_t>(ip);
+			if (candidate < 0 || ip - candidate > maxOffset || memcmp(src + candidate, src + ip, minMatch) != 0)
+			{
+				ip++;
+				continue;
+			}
+
+			size_t ref = static_cast<size_t>(candidate);
+			size_t matchEnd = ip + minMatch;
+			while (matchEnd < size - lastLiterals && src[matchEnd] == src[ref + (matchEnd - ip)])
+				matchEnd++;
+
+			size_t matchCode = matchEnd - ip - minMatch;
+			writeLiterals(anchor, ip - anchor, matchCode);
+			size_t offset = ip - ref;
+			out.push_back(static_cast<uint8_t>(offset & 0xFF));
+			out.push_back(static_cast<uint8_t>(offset >> 8));
+			if (matchCode >= 15)
+				writeLength(matchCode - 15);
+			ip = anchor = matchEnd;
+		}
+		//ʣµȫΪһе
+		writeLiterals(anchor, size - anchor, 0);
+		return out;
+	}
+
+	//߽飬𻵵ݷfalseԽ
+	inline bool decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+	{
+		const uint8_t* ip = src;
+		const uint8_t* end = src + srcSize;
+		uint8_t* op = dst;
+		uint8_t* outEnd = dst + dstSize;
+		auto readLength = [&ip, end](size_t& length) {
+			uint8_t byte;
+			do
+			{
+				if (ip >= end)
+					return false;
+				byte = *ip++;
+				length += byte;
+			} while (byte == 255);
+			return true;
+		};
+
+		while (ip < end)
+		{
+			uint8_t token = *ip++;
+			size_t literal = token >> 4;
+			if (literal == 15 && !readLength(literal))
+				return false;
+			if (literal > static_cast<size_t>(end - ip) || literal > static_cast<size_t>(outEnd - op))
+				return false;
+			if (literal > 0)
+				memcpy(op, ip, literal);
+			ip += literal;
+			op += literal;
+			if (ip == end)
+				break;
+
+			if (end - ip < 2)
+				return false;
+			size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+			ip += 2;
+			if (offset == 0 || offset > static_cast<size_t>(op - dst))
+				return false;
+			size_t match = token & 15;
+			if (match == 15 && !readLength(match))
+				return false;
+			match += 4;
+			if (match > static_cast<size_t>(outEnd - op))
+				return false;
+
+			//ƫСڳʱԴĿصֽڸ
+			const uint8_t* ref = op - offset;
+			if (offset >= match)
+				memcpy(op, ref, match);
+			else
+				for (size_t i = 0; i < match; i++)
+					op[i] = ref[i];
+			op += match;
+		}
+		return op == outEnd;
+	}
+}
+
+//˳̰meshletÿ64㡢124Σɫã
+inline void buildMeshlets(MeshData& mesh, uint32_t maxVertices = 64, uint32_t maxTriangles = 124)
+{
+	mesh.meshlets.clear();
+	mesh.meshletVertices.clear();
+	mesh.meshletTriangles.clear();
+
+	//ڵǰmeshletľֲţֻù
+	std::vector<uint32_t> localIndex(mesh.vertices.size(), ~0u);
+	for (auto& submesh : mesh.submeshes)
+	{
+		submesh.firstMeshlet = static_cast<uint32_t>(mesh.meshlets.size());
+		Meshlet current{ static_cast<uint32_t>(mesh.meshletVertices.size()), static_cast<uint32_t>(mesh.meshletTriangles.size()), 0, 0 };
+		auto close = [&]() {
+			if (current.triangleCount == 0)
+				return;
+			for (uint32_t i = 0; i < current.vertexCount; i++)
+				localIndex[mesh.meshletVertices[current.vertexOffset + i]] = ~0u;
+			mesh.meshlets.push_back(current);
+			current = Meshlet{ static_cast<uint32_t>(mesh.meshletVertices.size()), static_cast<uint32_t>(mesh.meshletTriangles.size()), 0, 0 };
+		};
+
+		for (uint32_t t = 0; t < submesh.indexCount; t += 3)
+		{
+			const uint32_t* triangle = &mesh.indices[submesh.firstIndex + t];
+			uint32_t newVertices = 0;
+			for (int k = 0; k < 3; k++)
+				newVertices += localIndex[triangle[k]] == ~0u ? 1 : 0;
+			if (current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles)
+				close();
+
+			for (int k = 0; k < 3; k++)
+			{
+				uint32_t vertex = triangle[k];
+				if (localIndex[vertex] == ~0u)
+				{
+					localIndex[vertex] = current.vertexCount++;
+					mesh.meshletVertices.push_back(vertex);
+				}
+				mesh.meshletTriangles.push_back(static_cast<uint8_t>(localIndex[vertex]));
+			}
+			current.triangleCount++;
+		}
+		close();
+		submesh.meshletCount = static_cast<uint32_t>(mesh.meshlets.size()) - submesh.firstMeshlet;
+	}
+}
+
+//İΧȡAABBģ뾶ǵԶľ
+inline void computeSubmeshBounds(MeshData& mesh)
+{
+	for (auto& submesh : mesh.submeshes)
+	{
+		float lo[3] = { 1e30f, 1e30f, 1e30f };
+		float hi[3] = { -1e30f, -1e30f, -1e30f };
+		for (uint32_t i = 0; i < submesh.indexCount; i++)
+		{
+			const float* p = mesh.vertices[mesh.indices[submesh.firstIndex + i]].position;
+			for (int c = 0; c < 3; c++)
+			{
+				lo[c] = std::min(lo[c], p[c]);
+				hi[c] = std::max(hi[c], p[c]);
+			}
+		}
+		float radius2 = 0.0f;
+		for (int c = 0; c < 3; c++)
+			submesh.center[c] = submesh.indexCount > 0 ? 0.5f * (lo[c] + hi[c]) : 0.0f;
+		for (uint32_t i = 0; i < submesh.indexCount; i++)
+		{
+			const float* p = mesh.vertices[mesh.indices[submesh.firstIndex + i]].position;
+			float dx = p[0] - submesh.center[0], dy = p[1] - submesh.center[1], dz = p[2] - submesh.center[2];
+			radius2 = std::max(radius2, dx * dx + dy * dy + dz * dz);
+		}
+		submesh.radius = std::sqrt(radius2);
+	}
+}
+
+//д.vkmeshļСcompressʱÿζѹѹСĿҲѹ
+inline uint64_t writeMeshFile(const MeshData& mesh, const std::string& path, bool compress)
+{
+	struct Source
+	{
+		MeshSection type;
+		const void* data;
+		uint64_t size;
+	};
+	std::vector<Source> sources = {
+		{ MeshSection::Vertices, mesh.vertices.data(), mesh.vertices.size() * sizeof(MeshVertex) },
+		{ MeshSection::Indices, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t) },
+		{ MeshSection::Submeshes, mesh.submeshes.data(), mesh.submeshes.size() * sizeof(Submesh) },
+		{ MeshSection::Meshlets, mesh.meshlets.data(), mesh.meshlets.size() * sizeof(Meshlet) },
+		{ MeshSection::MeshletVertices, mesh.meshletVertices.data(), mesh.meshletVertices.size() * sizeof(uint32_t) },
+		{ MeshSection::MeshletTriangles, mesh.meshletTriangles.data(), mesh.meshletTriangles.size() },
+	};
+
+	//ȰÿҪдֽ׼ãѹǿӸ
+	std::vector<std::vector<uint8_t>> payloads;
+	std::vector<MeshFileSection> sections;
+	uint64_t offset = sizeof(MeshFileHeader) + sources.size() * sizeof(MeshFileSection);
+	for (const auto& source : sources)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(source.data);
+		std::vector<uint8_t> payload;
+		if (compress && source.size > 0)
+		{
+			uint32_t blockCount = static_cast<uint32_t>((source.size + meshLz4BlockSize - 1) / meshLz4BlockSize);
+			payload.resize(sizeof(uint32_t) * (1 + blockCount));
+			memcpy(payload.data(), &blockCount, sizeof(uint32_t));
+			for (uint32_t b = 0; b < blockCount; b++)
+			{
+				uint64_t begin = static_cast<uint64_t>(b) * meshLz4BlockSize;
+				auto block = lz4::compress(bytes + begin, static_cast<size_t>(std::min<uint64_t>(meshLz4BlockSize, source.size - begin)));
+				uint32_t blockSize = static_cast<uint32_t>(block.size());
+				memcpy(payload.data() + sizeof(uint32_t) * (1 + b), &blockSize, sizeof(uint32_t));
+				payload.insert(payload.end(), block.begin(), block.end());
+			}
+		}
+		else if (source.size > 0)
+			payload.assign(bytes, bytes + source.size);
+
+		offset = (offset + meshSectionAlignment - 1) & ~(meshSectionAlignment - 1);
+		MeshFileSection section{};
+		section.type = static_cast<uint32_t>(source.type);
+		section.compression = static_cast<uint32_t>(compress && source.size > 0 ? MeshCompression::Lz4 : MeshCompression::None);
+		section.offset = offset;
+		section.storedSize = payload.size();
+		section.rawSize = source.size;
+		sections.push_back(section);
+		offset += payload.size();
+		payloads.push_back(std::move(payload));
+	}
+
+	MeshFileHeader header{};
+	header.magic = meshFileMagic;
+	header.version = meshFileVersion;
+	header.sectionCount = static_cast<uint32_t>(sections.size());
+	header.vertexStride = sizeof(MeshVertex);
+	header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+	header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+	header.submeshCount = static_cast<uint32_t>(mesh.submeshes.size());
+	header.meshletCount = static_cast<uint32_t>(mesh.meshlets.size());
+	header.fileSize = offset;
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+		throw std::runtime_error("failed to create mesh file " + path + "!");
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(MeshFileSection));
+	static const char padding[meshSectionAlignment] = {};
+	uint64_t written = sizeof(header) + sections.size() * sizeof(MeshFileSection);
+	for (size_t i = 0; i < sections.size(); i++)
+	{
+		file.write(padding, static_cast<std::streamsize>(sections[i].offset - written));
+		file.write(reinterpret_cast<const char*>(payloads[i].data()), payloads[i].size());
+		written = sections[i].offset + payloads[i].size();
+	}
+	if (!file)
+		throw std::runtime_error("failed to write mesh file " + path + "!");
+	return header.fileSize;
+}
+
+//ֻӳļӳںͶһ
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile() { close(); }
+
+	bool open(const std::string& path)
+	{
+		close();
+#ifdef _WIN32
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			close();
+			return false;
+		}
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr)
+		{
+			close();
+			return false;
+		}
+		bytes = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		length = static_cast<size_t>(fileSize.QuadPart);
+#else
+		fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size == 0)
+		{
+			close();
+			return false;
+		}
+		void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (address == MAP_FAILED)
+		{
+			close();
+			return false;
+		}
+		bytes = static_cast<const uint8_t*>(address);
+		length = static_cast<size_t>(info.st_size);
+		//ļҪ˳һ飬ںǰԤ
+		madvise(address, length, MADV_SEQUENTIAL | MADV_WILLNEED);
+#endif
+		if (bytes == nullptr)
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void close()
+	{
+#ifdef _WIN32
+		if (bytes != nullptr)
+			UnmapViewOfFile(bytes);
+		if (mapping != nullptr)
+			CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+		mapping = nullptr;
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (bytes != nullptr)
+			munmap(const_cast<uint8_t*>(bytes), length);
+		if (fd >= 0)
+			::close(fd);
+		fd = -1;
+#endif
+		bytes = nullptr;
+		length = 0;
+	}
+
+	const uint8_t* data() const { return bytes; }
+	size_t size() const { return length; }
+
+private:
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int fd = -1;
+#endif
+	const uint8_t* bytes = nullptr;
+	size_t length = 0;
+};
+
+//ӳ.vkmeshʱͷͶαӳﰴ
+class MeshFile
+{
+public:
+	void open(const std::string& path)
+	{
+		if (!file.open(path))
+			throw std::runtime_error("failed to open mesh file " + path + "!");
+		if (file.size() < sizeof(MeshFileHeader))
+			throw std::runtime_error(path + " is not a mesh file!");
+		memcpy(&fileHeader, file.data(), sizeof(fileHeader));
+		if (fileHeader.magic != meshFileMagic)
+			throw std::runtime_error(path + " is not a mesh file!");
+		if (fileHeader.version != meshFileVersion || fileHeader.vertexStride != sizeof(MeshVertex))
+			throw std::runtime_error("mesh file " + path + " has version " + std::to_string(fileHeader.version) +
+				", expected " + std::to_string(meshFileVersion) + "; convert it again!");
+		if (fileHeader.fileSize != file.size() ||
+			file.size() < sizeof(MeshFileHeader) + static_cast<uint64_t>(fileHeader.sectionCount) * sizeof(MeshFileSection))
+			throw std::runtime_error("mesh file " + path + " is truncated!");
+
+		sections.resize(fileHeader.sectionCount);
+		memcpy(sections.data(), file.data() + sizeof(MeshFileHeader), sections.size() * sizeof(MeshFileSection));
+		for (size_t i = 0; i < sections.size(); i++)
+		{
+			const MeshFileSection& section = sections[i];
+			if (section.offset % meshSectionAlignment != 0 || section.offset > file.size() || section.storedSize > file.size() - section.offset ||
+				(section.compression == static_cast<uint32_t>(MeshCompression::None) && section.storedSize != section.rawSize) ||
+				section.compression > static_cast<uint32_t>(MeshCompression::Lz4) || findSection(static_cast<MeshSection>(section.type)) != &section)
+				throw std::runtime_error("mesh file " + path + " has a corrupt section table!");
+		}
+		//ѹͶȡrawSizeдͷڴ棬߱һ£Խ
+		if (rawSize(MeshSection::Vertices) != static_cast<uint64_t>(fileHeader.vertexCount) * fileHeader.vertexStride ||
+			rawSize(MeshSection::Indices) != static_cast<uint64_t>(fileHeader.indexCount) * sizeof(uint32_t) ||
+			rawSize(MeshSection::Submeshes) != static_cast<uint64_t>(fileHeader.submeshCount) * sizeof(Submesh) ||
+			rawSize(MeshSection::Meshlets) != static_cast<uint64_t>(fileHeader.meshletCount) * sizeof(Meshlet) ||
+			rawSize(MeshSection::MeshletVertices) % sizeof(uint32_t) != 0 || rawSize(MeshSection::MeshletTriangles) % 3 != 0)
+			throw std::runtime_error("mesh file " + path + " has sections that do not match its header!");
+		this->path = path;
+	}
+
+	void close()
+	{
+		file.close();
+		sections.clear();
+	}
+
+	const MeshFileHeader& header() const { return fileHeader; }
+	uint64_t fileSize() const { return file.size(); }
+
+	//ûеĶηؿ
+	const MeshFileSection* findSection(MeshSection type) const
+	{
+		for (const auto& section : sections)
+		{
+			if (section.type == static_cast<uint32_t>(type))
+				return &section;
+		}
+		return nullptr;
+	}
+
+	uint64_t rawSize(MeshSection type) const
+	{
+		const MeshFileSection* section = findSection(type);
+		return section != nullptr ? section->rawSize : 0;
+	}
+
+	//ֱӴӳ临ƽݴ滷ѹÿڻԤռ͵ؽѹм仺
+	void uploadSection(MeshSection type, StagingRing& stagingRing, VkBuffer dst, VkDeviceSize dstOffset) const
+	{
+		forEachBlock(type, [&](const uint8_t* stored, uint64_t storedSize, uint64_t rawOffset, uint64_t rawSize, bool compressed) {
+			if (!compressed)
+			{
+				stagingRing.uploadBuffer(dst, dstOffset + rawOffset, stored, rawSize);
+				return;
+			}
+			void* target = stagingRing.reserveBufferUpload(dst, dstOffset + rawOffset, rawSize);
+			if (!lz4::decompress(stored, storedSize, static_cast<uint8_t*>(target), rawSize))
+				throw std::runtime_error("mesh file " + path + " has a corrupt compressed block!");
+		});
+	}
+
+	//CPUҪõСΣdstdstrawSize
+	void readSection(MeshSection type, void* dst) const
+	{
+		forEachBlock(type, [&](const uint8_t* stored, uint64_t storedSize, uint64_t rawOffset, uint64_t rawSize, bool compressed) {
+			uint8_t* target = static_cast<uint8_t*>(dst) + rawOffset;
+			if (!compressed)
+				memcpy(target, stored, rawSize);
+			else if (!lz4::decompress(stored, storedSize, target, rawSize))
+				throw std::runtime_error("mesh file " + path + " has a corrupt compressed block!");
+		});
+	}
+
+private:
+	//һΣδѹĶһ
+	template<typename Visit>
+	void forEachBlock(MeshSection type, const Visit& visit) const
+	{
+		const MeshFileSection* section = findSection(type);
+		if (section == nullptr || section->rawSize == 0)
+			return;
+		const uint8_t* data = file.data() + section->offset;
+		if (section->compression == static_cast<uint32_t>(MeshCompression::None))
+		{
+			visit(data, section->storedSize, 0, section->rawSize, false);
+			return;
+		}
+
+		uint32_t blockCount = 0;
+		if (section->storedSize >= sizeof(uint32_t))
+			memcpy(&blockCount, data, sizeof(uint32_t));
+		uint64_t tableSize = sizeof(uint32_t) * (1 + static_cast<uint64_t>(blockCount));
+		if (blockCount != (section->rawSize + meshLz4BlockSize - 1) / meshLz4BlockSize || tableSize > section->storedSize)
+			throw std::runtime_error("mesh file " + path + " has a corrupt compressed section!");
+
+		uint64_t storedOffset = tableSize;
+		for (uint32_t b = 0; b < blockCount; b++)
+		{
+			uint32_t blockSize;
+			memcpy(&blockSize, data + sizeof(uint32_t) * (1 + b), sizeof(uint32_t));
+			if (storedOffset + blockSize > section->storedSize)
+				throw std::runtime_error("mesh file " + path + " has a corrupt compressed section!");
+			uint64_t rawOffset = static_cast<uint64_t>(b) * meshLz4BlockSize;
+			visit(data + storedOffset, blockSize, rawOffset, std::min<uint64_t>(meshLz4BlockSize, section->rawSize - rawOffset), true);
+			storedOffset += blockSize;
+		}
+	}
+
+	MappedFile file;
+	MeshFileHeader fileHeader{};
+	std::vector<MeshFileSection> sections;
+	std::string path;
+};
+
+//GPU壺㡢ԼmeshletΣͬһ洢256ֽڶ룩
+//ϴֻŽݴ滷ͼζһ֡¼ʱȡȨҪþstagingRing.waitIdle()
+class MeshBuffers
+{
+public:
+	void init(VkDevice device, const VulkanDispatch& dispatch, MemoryAllocator& allocator, StagingRing& stagingRing)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+		this->allocator = &allocator;
+		this->stagingRing = &stagingRing;
+	}
+
+	void load(const MeshFile& file)
+	{
+		const MeshFileHeader& header = file.header();
+		//meshletݾGPUȽѹCPU˼鷶Χϴֻжֱӽݴ滷
+		MeshData mesh;
+		mesh.indices.resize(header.indexCount);
+		mesh.submeshes.resize(header.submeshCount);
+		mesh.meshlets.resize(header.meshletCount);
+		mesh.meshletVertices.resize(file.rawSize(MeshSection::MeshletVertices) / sizeof(uint32_t));
+		mesh.meshletTriangles.resize(file.rawSize(MeshSection::MeshletTriangles));
+		file.readSection(MeshSection::Indices, mesh.indices.data());
+		file.readSection(MeshSection::Submeshes, mesh.submeshes.data());
+		file.readSection(MeshSection::Meshlets, mesh.meshlets.data());
+		file.readSection(MeshSection::MeshletVertices, mesh.meshletVertices.data());
+		file.readSection(MeshSection::MeshletTriangles, mesh.meshletTriangles.data());
+		checkRanges(mesh, header.vertexCount);
+
+		create(file.rawSize(MeshSection::Vertices), mesh.indices.size() * sizeof(uint32_t), mesh.meshlets.size() * sizeof(Meshlet),
+			mesh.meshletVertices.size() * sizeof(uint32_t), mesh.meshletTriangles.size());
+		vertexCount = header.vertexCount;
+		file.uploadSection(MeshSection::Vertices, *stagingRing, vertexBuffer, 0);
+		upload(mesh);
+	}
+
+	//ãCPU˵ϴ
+	void load(const MeshData& mesh)
+	{
+		create(mesh.vertices.size() * sizeof(MeshVertex), mesh.indices.size() * sizeof(uint32_t), mesh.meshlets.size() * sizeof(Meshlet),
+			mesh.meshletVertices.size() * sizeof(uint32_t), mesh.meshletTriangles.size());
+		vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+		stagingRing->uploadBuffer(vertexBuffer, 0, mesh.vertices.data(), mesh.vertices.size() * sizeof(MeshVertex));
+		upload(mesh);
+	}
+
+	bool loaded() const { return vertexBuffer != VK_NULL_HANDLE; }
+
+	//ͷŻ壬֮loadǰGPUҪѾʹ
+	void release()
+	{
+		VkBuffer* buffers[] = { &vertexBuffer, &indexBuffer, &meshletBuffer };
+		Allocation* allocations[] = { &vertexAllocation, &indexAllocation, &meshletAllocation };
+		for (size_t i = 0; i < 3; i++)
+		{
+			if (*buffers[i] == VK_NULL_HANDLE)
+				continue;
+			dispatch->vkDestroyBuffer(device, *buffers[i], nullptr);
+			allocator->free(*allocations[i]);
+			*buffers[i] = VK_NULL_HANDLE;
+		}
+		submeshes.clear();
+		vertexCount = indexCount = meshletCount = 0;
+		gpuBytes = 0;
+	}
+
+	void destroy()
+	{
+		if (allocator != nullptr)
+			release();
+		allocator = nullptr;
+		stagingRing = nullptr;
+	}
+
+	void printStats() const
+	{
+		if (!loaded())
+			return;
+		printf("mesh: %u vertices, %u indices, %zu submeshes, %u meshlets, %.1f MB on the GPU\n", vertexCount, indexCount,
+			submeshes.size(), meshletCount, gpuBytes / (1024.0 * 1024.0));
+	}
+
+	VkBuffer vertexBuffer = VK_NULL_HANDLE;
+	VkBuffer indexBuffer = VK_NULL_HANDLE;
+	VkBuffer meshletBuffer = VK_NULL_HANDLE;		//ûmeshletʱΪ
+	VkDeviceSize meshletVerticesOffset = 0;
+	VkDeviceSize meshletTrianglesOffset = 0;
+	uint32_t vertexCount = 0;
+	uint32_t indexCount = 0;
+	uint32_t meshletCount = 0;
+	std::vector<Submesh> submeshes;
+
+private:
+	//Ĳ֣meshletκ
+	void upload(const MeshData& mesh)
+	{
+		indexCount = static_cast<uint32_t>(mesh.indices.size());
+		meshletCount = static_cast<uint32_t>(mesh.meshlets.size());
+		stagingRing->uploadBuffer(indexBuffer, 0, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+		if (meshletBuffer != VK_NULL_HANDLE)
+		{
+			stagingRing->uploadBuffer(meshletBuffer, 0, mesh.meshlets.data(), mesh.meshlets.size() * sizeof(Meshlet));
+			stagingRing->uploadBuffer(meshletBuffer, meshletVerticesOffset, mesh.meshletVertices.data(), mesh.meshletVertices.size() * sizeof(uint32_t));
+			stagingRing->uploadBuffer(meshletBuffer, meshletTrianglesOffset, mesh.meshletTriangles.data(), mesh.meshletTriangles.size());
+		}
+		submeshes = mesh.submeshes;
+	}
+
+	//ļͷΧţԽĻɫvkCmdDrawIndexed
+	static void checkRanges(const MeshData& mesh, uint32_t vertexCount)
+	{
+		for (uint32_t index : mesh.indices)
+		{
+			if (index >= vertexCount)
+				throw std::runtime_error("mesh file has an index past its vertices!");
+		}
+		for (const Submesh& submesh : mesh.submeshes)
+		{
+			if (static_cast<uint64_t>(submesh.firstIndex) + submesh.indexCount > mesh.indices.size() ||
+				static_cast<uint64_t>(submesh.firstMeshlet) + submesh.meshletCount > mesh.meshlets.size())
+				throw std::runtime_error("mesh file has a submesh past its indices or meshlets!");
+		}
+		for (const Meshlet& meshlet : mesh.meshlets)
+		{
+			if (static_cast<uint64_t>(meshlet.vertexOffset) + meshlet.vertexCount > mesh.meshletVertices.size() ||
+				static_cast<uint64_t>(meshlet.triangleOffset) + static_cast<uint64_t>(meshlet.triangleCount) * 3 > mesh.meshletTriangles.size())
+				throw std::runtime_error("mesh file has a meshlet past its vertex or triangle lists!");
+			const uint8_t* triangles = mesh.meshletTriangles.data() + meshlet.triangleOffset;
+			for (uint64_t i = 0; i < static_cast<uint64_t>(meshlet.triangleCount) * 3; i++)
+			{
+				if (triangles[i] >= meshlet.vertexCount)
+					throw std::runtime_error("mesh file has a meshlet triangle past its vertices!");
+			}
+		}
+		for (uint32_t vertex : mesh.meshletVertices)
+		{
+			if (vertex >= vertexCount)
+				throw std::runtime_error("mesh file has a meshlet vertex past its vertices!");
+		}
+	}
+
+	void create(VkDeviceSize vertexBytes, VkDeviceSize indexBytes, VkDeviceSize meshletBytes,
+		VkDeviceSize meshletVertexBytes, VkDeviceSize meshletTriangleBytes)
+	{
+		release();
+		if (vertexBytes == 0 || indexBytes == 0)
+			throw std::runtime_error("mesh has no vertices or indices!");
+
+		allocator->createBuffer(vertexBytes, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer, vertexAllocation);
+		allocator->createBuffer(indexBytes, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer, indexAllocation);
+		gpuBytes = vertexBytes + indexBytes;
+
+		//256ֽ豸minStorageBufferOffsetAlignment
+		auto align = [](VkDeviceSize value) { return (value + 255) & ~static_cast<VkDeviceSize>(255); };
+		meshletVerticesOffset = align(meshletBytes);
+		meshletTrianglesOffset = meshletVerticesOffset + align(meshletVertexBytes);
+		if (meshletBytes > 0)
+		{
+			VkDeviceSize meshletTotal = meshletTrianglesOffset + meshletTriangleBytes;
+			allocator->createBuffer(meshletTotal, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, meshletBuffer, meshletAllocation);
+			gpuBytes += meshletTotal;
+		}
+	}
+
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;
+	MemoryAllocator* allocator = nullptr;
+	StagingRing* stagingRing = nullptr;
+	Allocation vertexAllocation;
+	Allocation indexAllocation;
+	Allocation meshletAllocation;
+	VkDeviceSize gpuBytes = 0;
+};
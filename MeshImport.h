@@ -0,0 +1,585 @@
+#pragma once
+
+#include "MeshFile.h"
+
+#include<vector>
+#include<string>
+#include<fstream>
+#include<sstream>
+#include<unordered_map>
+#include<map>
+#include<memory>
+#include<cstdint>
+#include<cstring>
+#include<cstdlib>
+#include<cmath>
+#include<stdexcept>
+
+//תߺͻ׼ĽãOBJ/glTFMeshDatameshlet
+
+//ûзߵ淨ۼӳƽ
+inline void computeSmoothNormals(MeshData& mesh)
+{
+	for (auto& vertex : mesh.vertices)
+		vertex.normal[0] = vertex.normal[1] = vertex.normal[2] = 0.0f;
+	for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+	{
+		MeshVertex& a = mesh.vertices[mesh.indices[i]];
+		MeshVertex& b = mesh.vertices[mesh.indices[i + 1]];
+		MeshVertex& c = mesh.vertices[mesh.indices[i + 2]];
+		float e1[3], e2[3];
+		for (int k = 0; k < 3; k++)
+		{
+			e1[k] = b.position[k] - a.position[k];
+			e2[k] = c.position[k] - a.position[k];
+		}
+		//һȨش
+		float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+		for (int k = 0; k < 3; k++)
+		{
+			a.normal[k] += n[k];
+			b.normal[k] += n[k];
+			c.normal[k] += n[k];
+		}
+	}
+	for (auto& vertex : mesh.vertices)
+	{
+		float length = std::sqrt(vertex.normal[0] * vertex.normal[0] + vertex.normal[1] * vertex.normal[1] + vertex.normal[2] * vertex.normal[2]);
+		if (length > 0.0f)
+			for (int k = 0; k < 3; k++)
+				vertex.normal[k] /= length;
+		else
+			vertex.normal[1] = 1.0f;
+	}
+}
+
+//OBJ֧v/vt/vnΰβΣo/g/usemtlһ
+//ͬv/vt/vnֻһ
+inline MeshData loadObj(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		throw std::runtime_error("failed to open " + path + "!");
+	//ļһζнgetlineܶ
+	std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	std::vector<float> positions, normals, uvs;
+	MeshData mesh;
+	//v/vt/vnţûе0
+	struct VertexKey
+	{
+		uint32_t position, uv, normal;
+		bool operator==(const VertexKey& other) const { return position == other.position && uv == other.uv && normal == other.normal; }
+	};
+	struct KeyHash
+	{
+		size_t operator()(const VertexKey& key) const
+		{
+			uint64_t h = key.position;
+			h = h * 0x9E3779B97F4A7C15ull + key.uv;
+			h = h * 0x9E3779B97F4A7C15ull + key.normal;
+			return static_cast<size_t>(h ^ (h >> 32));
+		}
+	};
+	std::unordered_map<VertexKey, uint32_t, KeyHash> vertexMap;
+	bool hasNormals = false;
+	uint32_t submeshStart = 0;
+	auto closeSubmesh = [&]() {
+		uint32_t end = static_cast<uint32_t>(mesh.indices.size());
+		if (end > submeshStart)
+			mesh.submeshes.push_back({ submeshStart, end - submeshStart, 0, 0, { 0.0f, 0.0f, 0.0f }, 0.0f });
+		submeshStart = end;
+	};
+
+	const char* p = text.c_str();
+	const char* end = p + text.size();
+	std::vector<uint32_t> face;
+	size_t lineNumber = 0;
+	while (p < end)
+	{
+		lineNumber++;
+		const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+		if (lineEnd == nullptr)
+			lineEnd = end;
+		while (p < lineEnd && (*p == ' ' || *p == '\t'))
+			p++;
+
+		//ֻһУǰrequiredУȱĲ0ֻuvtģvw
+		auto readFloats = [&](std::vector<float>& out, int count, int required) {
+			const char* q = p;
+			for (int i = 0; i < count; i++)
+			{
+				while (q < lineEnd && (*q == ' ' || *q == '\t'))
+					q++;
+				if (q >= lineEnd || *q == '\r')
+				{
+					if (i < required)
+						throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": missing component!");
+					out.push_back(0.0f);
+					continue;
+				}
+				char* next;
+				out.push_back(strtof(q, &next));
+				if (next == q)
+					throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": bad number!");
+				q = next;
+			}
+		};
+
+		if (p + 2 <= lineEnd && p[0] == 'v' && p[1] == ' ')
+		{
+			p += 2;
+			readFloats(positions, 3, 3);
+		}
+		else if (p + 3 <= lineEnd && p[0] == 'v' && p[1] == 'n' && p[2] == ' ')
+		{
+			p += 3;
+			readFloats(normals, 3, 3);
+			hasNormals = true;
+		}
+		else if (p + 3 <= lineEnd && p[0] == 'v' && p[1] == 't' && p[2] == ' ')
+		{
+			p += 3;
+			readFloats(uvs, 2, 1);
+		}
+		else if (p + 2 <= lineEnd && p[0] == 'f' && p[1] == ' ')
+		{
+			p += 2;
+			face.clear();
+			const char* q = p;
+			while (q < lineEnd)
+			{
+				while (q < lineEnd && (*q == ' ' || *q == '\t' || *q == '\r'))
+					q++;
+				if (q >= lineEnd)
+					break;
+				//vv/vtv//vnv/vt/vnӵǰĩβǰ
+				long index[3] = { 0, 0, 0 };
+				size_t counts[3] = { positions.size() / 3, uvs.size() / 2, normals.size() / 3 };
+				for (int k = 0; k < 3 && q < lineEnd && *q != ' ' && *q != '\t' && *q != '\r'; k++)
+				{
+					if (*q != '/')
+					{
+						char* next;
+						long value = strtol(q, &next, 10);
+						if (next == q)
+							throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": bad face index!");
+						index[k] = value < 0 ? static_cast<long>(counts[k]) + value + 1 : value;
+						if (index[k] <= 0 || static_cast<size_t>(index[k]) > counts[k])
+							throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": face index out of range!");
+						q = next;
+					}
+					if (q < lineEnd && *q == '/')
+						q++;
+				}
+				VertexKey key{ static_cast<uint32_t>(index[0]), static_cast<uint32_t>(index[1]), static_cast<uint32_t>(index[2]) };
+				auto [it, inserted] = vertexMap.try_emplace(key, static_cast<uint32_t>(mesh.vertices.size()));
+				if (inserted)
+				{
+					MeshVertex vertex{};
+					memcpy(vertex.position, &positions[(index[0] - 1) * 3], sizeof(vertex.position));
+					if (index[1] > 0)
+						memcpy(vertex.uv, &uvs[(index[1] - 1) * 2], sizeof(vertex.uv));
+					if (index[2] > 0)
+						memcpy(vertex.normal, &normals[(index[2] - 1) * 3], sizeof(vertex.normal));
+					mesh.vertices.push_back(vertex);
+				}
+				face.push_back(it->second);
+			}
+			for (size_t i = 2; i < face.size(); i++)
+			{
+				mesh.indices.push_back(face[0]);
+				mesh.indices.push_back(face[i - 1]);
+				mesh.indices.push_back(face[i]);
+			}
+		}
+		else if (p + 2 <= lineEnd && (p[0] == 'o' || p[0] == 'g') && (p[1] == ' ' || p[1] == '\r'))
+			closeSubmesh();
+		else if (lineEnd - p >= 7 && strncmp(p, "usemtl ", 7) == 0)
+			closeSubmesh();
+		p = lineEnd + 1;
+	}
+	closeSubmesh();
+
+	if (mesh.indices.empty())
+		throw std::runtime_error(path + " has no faces!");
+	if (!hasNormals)
+		computeSmoothNormals(mesh);
+	computeSubmeshBounds(mesh);
+	return mesh;
+}
+
+//glTFֻõJSONһС֣ǹõС
+struct JsonValue
+{
+	enum class Type { Null, Bool, Number, String, Array, Object } type = Type::Null;
+	double number = 0.0;
+	std::string string;
+	std::vector<JsonValue> array;
+	std::map<std::string, JsonValue> object;
+
+	const JsonValue* find(const std::string& key) const
+	{
+		auto it = object.find(key);
+		return it != object.end() ? &it->second : nullptr;
+	}
+
+	//ȡֳԱûʱfallback
+	double numberOr(const std::string& key, double fallback) const
+	{
+		const JsonValue* value = find(key);
+		return value != nullptr && value->type == Type::Number ? value->number : fallback;
+	}
+};
+
+class JsonParser
+{
+public:
+	static JsonValue parse(const std::string& text)
+	{
+		JsonParser parser(text);
+		JsonValue value = parser.parseValue();
+		parser.skipSpace();
+		if (parser.pos != text.size())
+			throw std::runtime_error("trailing characters in JSON!");
+		return value;
+	}
+
+private:
+	explicit JsonParser(const std::string& text) : text(text) {}
+
+	void skipSpace()
+	{
+		while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+			pos++;
+	}
+
+	void expect(char c)
+	{
+		skipSpace();
+		if (pos >= text.size() || text[pos] != c)
+			throw std::runtime_error(std::string("expected '") + c + "' in JSON!");
+		pos++;
+	}
+
+	JsonValue parseValue()
+	{
+		skipSpace();
+		if (pos >= text.size())
+			throw std::runtime_error("unexpected end of JSON!");
+		JsonValue value;
+		char c = text[pos];
+		if (c == '{')
+		{
+			value.type = JsonValue::Type::Object;
+			pos++;
+			skipSpace();
+			if (pos < text.size() && text[pos] == '}')
+			{
+				pos++;
+				return value;
+			}
+			do
+			{
+				skipSpace();
+				std::string key = parseString();
+				expect(':');
+				value.object[key] = parseValue();
+				skipSpace();
+			} while (pos < text.size() && text[pos] == ',' && ++pos);
+			expect('}');
+		}
+		else if (c == '[')
+		{
+			value.type = JsonValue::Type::Array;
+			pos++;
+			skipSpace();
+			if (pos < text.size() && text[pos] == ']')
+			{
+				pos++;
+				return value;
+			}
+			do
+			{
+				value.array.push_back(parseValue());
+				skipSpace();
+			} while (pos < text.size() && text[pos] == ',' && ++pos);
+			expect(']');
+		}
+		else if (c == '"')
+		{
+			value.type = JsonValue::Type::String;
+			value.string = parseString();
+		}
+		else if (text.compare(pos, 4, "true") == 0 || text.compare(pos, 5, "false") == 0)
+		{
+			value.type = JsonValue::Type::Bool;
+			value.number = c == 't' ? 1.0 : 0.0;
+			pos += c == 't' ? 4 : 5;
+		}
+		else if (text.compare(pos, 4, "null") == 0)
+			pos += 4;
+		else
+		{
+			char* next;
+			value.type = JsonValue::Type::Number;
+			value.number = strtod(text.c_str() + pos, &next);
+			if (next == text.c_str() + pos)
+				throw std::runtime_error("bad value in JSON!");
+			pos = next - text.c_str();
+		}
+		return value;
+	}
+
+	//תֻglTFֵģ\uֻASCII
+	std::string parseString()
+	{
+		if (pos >= text.size() || text[pos] != '"')
+			throw std::runtime_error("expected a string in JSON!");
+		pos++;
+		std::string out;
+		while (pos < text.size() && text[pos] != '"')
+		{
+			char c = text[pos++];
+			if (c == '\\' && pos < text.size())
+			{
+				char e = text[pos++];
+				switch (e)
+				{
+				case 'n': out += '\n'; break;
+				case 't': out += '\t'; break;
+				case 'r': out += '\r'; break;
+				case 'b': out += '\b'; break;
+				case 'f': out += '\f'; break;
+				case 'u':
+					out += static_cast<char>(strtol(text.substr(pos, 4).c_str(), nullptr, 16) & 0x7F);
+					pos += 4;
+					break;
+				default: out += e; break;
+				}
+			}
+			else
+				out += c;
+		}
+		if (pos >= text.size())
+			throw std::runtime_error("unterminated string in JSON!");
+		pos++;
+		return out;
+	}
+
+	const std::string& text;
+	size_t pos = 0;
+};
+
+inline std::vector<uint8_t> decodeBase64(const std::string& text)
+{
+	std::vector<uint8_t> out;
+	out.reserve(text.size() * 3 / 4);
+	uint32_t bits = 0;
+	int bitCount = 0;
+	for (char c : text)
+	{
+		int value;
+		if (c >= 'A' && c <= 'Z') value = c - 'A';
+		else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+		else if (c >= '0' && c <= '9') value = c - '0' + 52;
+		else if (c == '+' || c == '-') value = 62;
+		else if (c == '/' || c == '_') value = 63;
+		else continue;
+		bits = (bits << 6) | static_cast<uint32_t>(value);
+		bitCount += 6;
+		if (bitCount >= 8)
+		{
+			bitCount -= 8;
+			out.push_back(static_cast<uint8_t>(bits >> bitCount));
+		}
+	}
+	return out;
+}
+
+inline std::vector<uint8_t> readBinaryFile(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+		throw std::runtime_error("failed to open " + path + "!");
+	std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(data.data()), data.size());
+	return data;
+}
+
+//glTF 2.0.gltfⲿbase64壬.glbÿͼԪһ
+//POSITION/NORMAL/TEXCOORD_0ڵ任ʡܣͼԪԭϲ
+inline MeshData loadGltf(const std::string& path)
+{
+	std::vector<uint8_t> fileData = readBinaryFile(path);
+	std::string json;
+	std::vector<std::vector<uint8_t>> buffers;
+	std::vector<uint8_t> glbBinary;
+	bool glb = fileData.size() >= 12 && memcmp(fileData.data(), "glTF", 4) == 0;
+	if (glb)
+	{
+		//12ֽļͷȻJSONͿѡBIN飬ÿ8ֽͷ
+		size_t offset = 12;
+		while (offset + 8 <= fileData.size())
+		{
+			uint32_t chunkLength, chunkType;
+			memcpy(&chunkLength, &fileData[offset], 4);
+			memcpy(&chunkType, &fileData[offset + 4], 4);
+			if (offset + 8 + chunkLength > fileData.size())
+				throw std::runtime_error(path + " has a truncated chunk!");
+			const char* chunk = reinterpret_cast<const char*>(&fileData[offset + 8]);
+			if (chunkType == 0x4E4F534A)		//"JSON"
+				json.assign(chunk, chunkLength);
+			else if (chunkType == 0x004E4942)	//"BIN\0"
+				glbBinary.assign(chunk, chunk + chunkLength);
+			offset += 8 + ((chunkLength + 3) & ~3u);
+		}
+	}
+	else
+		json.assign(fileData.begin(), fileData.end());
+
+	JsonValue root = JsonParser::parse(json);
+	std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+	if (const JsonValue* bufferList = root.find("buffers"))
+	{
+		for (const auto& buffer : bufferList->array)
+		{
+			const JsonValue* uri = buffer.find("uri");
+			if (uri == nullptr)
+				buffers.push_back(glbBinary);
+			else if (uri->string.compare(0, 5, "data:") == 0)
+				buffers.push_back(decodeBase64(uri->string.substr(uri->string.find(',') + 1)));
+			else
+				buffers.push_back(readBinaryFile(directory + uri->string));
+		}
+	}
+
+	auto member = [&path](const JsonValue& object, const char* key) -> const JsonValue& {
+		const JsonValue* value = object.find(key);
+		if (value == nullptr)
+			throw std::runtime_error(path + " is missing \"" + key + "\"!");
+		return *value;
+	};
+	//ѷfloatcountcomponents߰uint32
+	auto readAccessor = [&](size_t accessorIndex, uint32_t components, std::vector<float>* floats, std::vector<uint32_t>* ints) {
+		const JsonValue& accessor = member(root, "accessors").array.at(accessorIndex);
+		size_t count = static_cast<size_t>(member(accessor, "count").number);
+		uint32_t componentType = static_cast<uint32_t>(member(accessor, "componentType").number);
+		size_t componentSize = componentType == 5126 || componentType == 5125 ? 4 : componentType == 5123 || componentType == 5122 ? 2 : 1;
+		const JsonValue& view = member(root, "bufferViews").array.at(static_cast<size_t>(member(accessor, "bufferView").number));
+		const std::vector<uint8_t>& buffer = buffers.at(static_cast<size_t>(member(view, "buffer").number));
+		size_t stride = static_cast<size_t>(view.numberOr("byteStride", 0.0));
+		if (stride == 0)
+			stride = componentSize * components;
+		size_t base = static_cast<size_t>(view.numberOr("byteOffset", 0.0) + accessor.numberOr("byteOffset", 0.0));
+		if (count > 0 && base + (count - 1) * stride + componentSize * components > buffer.size())
+			throw std::runtime_error(path + " has an accessor outside its buffer!");
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const uint8_t* element = buffer.data() + base + i * stride;
+			for (uint32_t c = 0; c < components; c++)
+			{
+				const uint8_t* src = element + c * componentSize;
+				if (floats != nullptr)
+				{
+					if (componentType != 5126)
+						throw std::runtime_error(path + " has non-float vertex attributes, which are not supported!");
+					float value;
+					memcpy(&value, src, 4);
+					floats->push_back(value);
+				}
+				else if (componentType == 5125)
+				{
+					uint32_t value;
+					memcpy(&value, src, 4);
+					ints->push_back(value);
+				}
+				else if (componentType == 5123)
+				{
+					uint16_t value;
+					memcpy(&value, src, 2);
+					ints->push_back(value);
+				}
+				else
+					ints->push_back(*src);
+			}
+		}
+		return count;
+	};
+
+	MeshData mesh;
+	bool missingNormals = false;
+	const JsonValue* meshes = root.find("meshes");
+	if (meshes == nullptr)
+		throw std::runtime_error(path + " has no meshes!");
+	for (const auto& gltfMesh : meshes->array)
+	{
+		for (const auto& primitive : member(gltfMesh, "primitives").array)
+		{
+			//ֻҪбmodeȱʡ4
+			if (primitive.numberOr("mode", 4.0) != 4.0)
+				continue;
+			const JsonValue& attributes = member(primitive, "attributes");
+			std::vector<float> positions, normals, uvs;
+			size_t vertexCount = readAccessor(static_cast<size_t>(member(attributes, "POSITION").number), 3, &positions, nullptr);
+			if (const JsonValue* normal = attributes.find("NORMAL"))
+				readAccessor(static_cast<size_t>(normal->number), 3, &normals, nullptr);
+			else
+				missingNormals = true;
+			if (const JsonValue* uv = attributes.find("TEXCOORD_0"))
+				readAccessor(static_cast<size_t>(uv->number), 2, &uvs, nullptr);
+
+			uint32_t baseVertex = static_cast<uint32_t>(mesh.vertices.size());
+			for (size_t i = 0; i < vertexCount; i++)
+			{
+				MeshVertex vertex{};
+				memcpy(vertex.position, &positions[i * 3], sizeof(vertex.position));
+				if (normals.size() == vertexCount * 3)
+					memcpy(vertex.normal, &normals[i * 3], sizeof(vertex.normal));
+				if (uvs.size() == vertexCount * 2)
+					memcpy(vertex.uv, &uvs[i * 2], sizeof(vertex.uv));
+				mesh.vertices.push_back(vertex);
+			}
+
+			uint32_t firstIndex = static_cast<uint32_t>(mesh.indices.size());
+			std::vector<uint32_t> indices;
+			if (const JsonValue* indexAccessor = primitive.find("indices"))
+				readAccessor(static_cast<size_t>(indexAccessor->number), 1, nullptr, &indices);
+			else
+				for (uint32_t i = 0; i < vertexCount; i++)
+					indices.push_back(i);
+			for (uint32_t index : indices)
+			{
+				if (index >= vertexCount)
+					throw std::runtime_error(path + " has an index out of range!");
+				mesh.indices.push_back(baseVertex + index);
+			}
+			uint32_t indexCount = static_cast<uint32_t>(indices.size() / 3 * 3);
+			mesh.indices.resize(firstIndex + indexCount);
+			if (indexCount > 0)
+				mesh.submeshes.push_back({ firstIndex, indexCount, 0, 0, { 0.0f, 0.0f, 0.0f }, 0.0f });
+		}
+	}
+
+	if (mesh.indices.empty())
+		throw std::runtime_error(path + " has no triangles!");
+	if (missingNormals)
+		computeSmoothNormals(mesh);
+	computeSubmeshBounds(mesh);
+	return mesh;
+}
+
+//չѡ
+inline MeshData importMesh(const std::string& path)
+{
+	std::string extension = path.substr(path.find_last_of('.') + 1);
+	for (auto& c : extension)
+		c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+	if (extension == "obj")
+		return loadObj(path);
+	if (extension == "gltf" || extension == "glb")
+		return loadGltf(path);
+	throw std::runtime_error("unsupported mesh format: " + path + "!");
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDispatch.h"
+
+#include<vector>
+#include<string>
+#include<fstream>
+#include<filesystem>
+#include<stdexcept>
+#include<cstring>
+#include<cstdio>
+
+//ϵĹ߻棬ʱ룬˳ʱϲд
+class PipelineCache
+{
+public:
+	//ȡļͷvendorIDdeviceIDpipelineCacheUUID͵ǰ豸һ¾Ͷ
+	void create(VkDevice device, const VulkanDispatch& dispatch, const VkPhysicalDeviceProperties& properties, const std::string& path)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+		this->path = path;
+
+		std::vector<char> data = readFile(path);
+		if (!data.empty() && !isCompatible(data, properties))
+		{
+			printf("pipeline cache: %s does not match this device/driver, discarded\n", path.c_str());
+			data.clear();
+		}
+		loadedBytes = data.size();
+
+		VkPipelineCacheCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		createInfo.initialDataSize = data.size();
+		createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+		//Ҳܾܾݵݣʱ˻ؿջ
+		if (dispatch.vkCreatePipelineCache(device, &createInfo, nullptr, &cache) != VK_SUCCESS)
+		{
+			createInfo.initialDataSize = 0;
+			createInfo.pInitialData = nullptr;
+			loadedBytes = 0;
+			if (dispatch.vkCreatePipelineCache(device, &createInfo, nullptr, &cache) != VK_SUCCESS)
+				throw std::runtime_error("failed to create pipeline cache!");
+		}
+	}
+
+	//̸߳õĻϲ
+	void merge(const std::vector<VkPipelineCache>& sources)
+	{
+		if (sources.empty())
+			return;
+		if (dispatch->vkMergePipelineCaches(device, cache, static_cast<uint32_t>(sources.size()), sources.data()) != VK_SUCCESS)
+			throw std::runtime_error("failed to merge pipeline caches!");
+	}
+
+	//дʱļٸдһ˳Ҳ𻵵Ļ
+	void save()
+	{
+		if (cache == VK_NULL_HANDLE || path.empty())
+			return;
+
+		size_t dataSize = 0;
+		dispatch->vkGetPipelineCacheData(device, cache, &dataSize, nullptr);
+		std::vector<char> data(dataSize);
+		if (dataSize == 0 || dispatch->vkGetPipelineCacheData(device, cache, &dataSize, data.data()) != VK_SUCCESS)
+			return;
+
+		std::string tmpPath = path + ".tmp";
+		{
+			std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+			if (!file.write(data.data(), static_cast<std::streamsize>(dataSize)))
+			{
+				printf("pipeline cache: failed to write %s\n", tmpPath.c_str());
+				return;
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tmpPath, path, ec);
+		if (ec)
+		{
+			printf("pipeline cache: failed to replace %s: %s\n", path.c_str(), ec.message().c_str());
+			std::filesystem::remove(tmpPath, ec);
+		}
+	}
+
+	void destroy()
+	{
+		if (cache != VK_NULL_HANDLE)
+			dispatch->vkDestroyPipelineCache(device, cache, nullptr);
+		cache = VK_NULL_HANDLE;
+	}
+
+	VkPipelineCache handle() const { return cache; }
+	bool isWarm() const { return loadedBytes > 0; }
+	size_t loadedSize() const { return loadedBytes; }
+
+private:
+	static std::vector<char> readFile(const std::string& filename)
+	{
+		std::ifstream file(filename, std::ios::ate | std::ios::binary);
+		if (!file.is_open())
+			return {};
+
+		size_t fileSize = static_cast<size_t>(file.tellg());
+		std::vector<char> buffer(fileSize);
+		file.seekg(0);
+		file.read(buffer.data(), fileSize);
+		return buffer;
+	}
+
+	//VkPipelineCacheHeaderVersionOneĲּͷ
+	static bool isCompatible(const std::vector<char>& data, const VkPhysicalDeviceProperties& properties)
+	{
+		const size_t headerSize = 16 + VK_UUID_SIZE;
+		if (data.size() < headerSize)
+			return false;
+
+		uint32_t header[4];
+		memcpy(header, data.data(), sizeof(header));
+
+		return header[0] >= headerSize &&
+			header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+			header[2] == properties.vendorID &&
+			header[3] == properties.deviceID &&
+			memcmp(data.data() + 16, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+	}
+
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;
+	VkPipelineCache cache = VK_NULL_HANDLE;
+	std::string path;
+	size_t loadedBytes = 0;
+};
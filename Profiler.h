@@ -0,0 +1,476 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDispatch.h"
+
+#include<vector>
+#include<string>
+#include<map>
+#include<memory>
+#include<mutex>
+#include<atomic>
+#include<chrono>
+#include<fstream>
+#include<algorithm>
+#include<cstdio>
+
+//CMakeVULKAN_01_PROFILERѡENABLE_PROFILERĬϴ򿪣׼Ǵ򿪣
+//Ĭϸ֤һֻڵ԰汾򿪣ҲENABLE_PROFILER=0/1ǿָ
+#ifndef ENABLE_PROFILER
+#ifdef NDEBUG
+#define ENABLE_PROFILER 0
+#else
+#define ENABLE_PROFILER 1
+#endif
+#endif
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+#if ENABLE_PROFILER
+
+//CPUʱnameַָֻ룩
+#define PROFILE_SCOPE(name) ProfileScope PROFILER_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_THREAD_NAME(name) Profiler::instance().setThreadName(name)
+//GPUʱдʼͽʱ
+#define GPU_PROFILE_SCOPE(gpuProfiler, commandBuffer, name) GpuProfileScope PROFILER_CONCAT(gpuProfileScope, __LINE__)(gpuProfiler, commandBuffer, name)
+
+//һʱ¼ʱԷʱ̵
+struct ProfileEvent
+{
+	const char* name;
+	uint64_t startNs;
+	uint64_t endNs;
+};
+
+//CPUGPUʱĻܣÿ߳дԼĻλ壨дߣ
+//߳ÿ֡collectһΣ¹ͳƣҪʱChrome trace
+class Profiler
+{
+public:
+	static Profiler& instance()
+	{
+		static Profiler profiler;
+		return profiler;
+	}
+
+	uint64_t nowNs() const
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+	}
+
+	void record(const char* name, uint64_t startNs, uint64_t endNs)
+	{
+		ThreadBuffer& buffer = threadBuffer();
+		uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+		ThreadBuffer::Slot& slot = buffer.slots[index % ThreadBuffer::capacity];
+		slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.startNs.store(startNs, std::memory_order_relaxed);
+		slot.endNs.store(endNs, std::memory_order_relaxed);
+		slot.sequence.store(2 * index + 2, std::memory_order_release);
+		buffer.writeIndex.store(index + 1, std::memory_order_release);
+	}
+
+	void setThreadName(const char* name)
+	{
+		threadBuffer().name = name;
+	}
+
+	//GPUʱGpuProfiler֮ŵĹ
+	void recordGpu(const char* name, uint64_t startNs, uint64_t endNs)
+	{
+		addSample(name, startNs, endNs, gpuTrack);
+	}
+
+	//ʼ¼˳ʱдChrome trace
+	void enableCapture(size_t maxEvents = 2000000)
+	{
+		captureLimit = maxEvents;
+	}
+
+	//Ѹ̻߳µ¼ȡд׷ϸǵĲֱӶ
+	void collect()
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		for (auto& buffer : buffers)
+		{
+			uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+			uint64_t begin = std::max(buffer->readIndex, end > ThreadBuffer::capacity ? end - ThreadBuffer::capacity : 0);
+			ProfileEvent event;
+			for (uint64_t i = begin; i < end; i++)
+			{
+				if (buffer->read(i, event))
+					addSample(event.name, event.startNs, event.endNs, buffer->track);
+			}
+			buffer->readIndex = end;
+		}
+	}
+
+	//ÿһʱС/ƽ/p99
+	void printSummary()
+	{
+		collect();
+		for (auto& [name, window] : windows)
+		{
+			if (window.samples.empty())
+				continue;
+			std::vector<double> sorted = window.samples;
+			std::sort(sorted.begin(), sorted.end());
+			double sum = 0.0;
+			for (double ms : sorted)
+				sum += ms;
+			printf("profile %-28s %s n=%-6zu min %.3f ms, avg %.3f ms, p99 %.3f ms\n",
+				name.c_str(), window.gpu ? "GPU" : "CPU", sorted.size(), sorted.front(), sum / sorted.size(),
+				sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)]);
+		}
+	}
+
+	//chrome://tracingPerfettoܴ򿪵trace-event JSON
+	bool writeChromeTrace(const std::string& path)
+	{
+		collect();
+		std::ofstream file(path, std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool first = true;
+		auto separator = [&]() -> std::ofstream& {
+			if (!first)
+				file << ",\n";
+			first = false;
+			return file;
+		};
+
+		{
+			std::lock_guard<std::mutex> lock(buffersMutex);
+			for (auto& buffer : buffers)
+			{
+				std::string name = buffer->name ? buffer->name : "thread " + std::to_string(buffer->track);
+				separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->track
+					<< ",\"args\":{\"name\":\"" << name << "\"}}";
+			}
+		}
+		separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << gpuTrack << ",\"args\":{\"name\":\"GPU\"}}";
+
+		char line[256];
+		for (const auto& event : captured)
+		{
+			snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				event.name, event.track, event.startNs / 1000.0, (event.endNs - event.startNs) / 1000.0);
+			separator() << line;
+		}
+		file << "\n]}\n";
+		return static_cast<bool>(file);
+	}
+
+private:
+	struct ThreadBuffer
+	{
+		//ÿλһţseqlockдi¼ǰŸĳ2i+1дĳ2i+2
+		//߸ǰŶ2i+2ĵi¼ڼ䱻дƻǵľͶ
+		struct Slot
+		{
+			std::atomic<uint64_t> sequence{ 0 };
+			std::atomic<const char*> name{ nullptr };
+			std::atomic<uint64_t> startNs{ 0 };
+			std::atomic<uint64_t> endNs{ 0 };
+		};
+
+		bool read(uint64_t index, ProfileEvent& event) const
+		{
+			const Slot& slot = slots[index % capacity];
+			uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+			if (sequence != 2 * index + 2)
+				return false;
+			event.name = slot.name.load(std::memory_order_relaxed);
+			event.startNs = slot.startNs.load(std::memory_order_relaxed);
+			event.endNs = slot.endNs.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return slot.sequence.load(std::memory_order_relaxed) == sequence;
+		}
+
+		static constexpr uint64_t capacity = 1 << 14;
+		Slot slots[capacity];
+		std::atomic<uint64_t> writeIndex{ 0 };
+		uint64_t readIndex = 0;		//ֻcollect
+		uint32_t track = 0;
+		const char* name = nullptr;
+		bool inUse = false;			//߳˳󻺳̸߳ã¼ƲԻᷴ߳
+	};
+
+	//߳˳ʱ黹
+	struct ThreadBufferOwner
+	{
+		ThreadBuffer* buffer = nullptr;
+		~ThreadBufferOwner()
+		{
+			if (buffer != nullptr)
+				Profiler::instance().releaseBuffer(buffer);
+		}
+	};
+
+	struct CapturedEvent
+	{
+		const char* name;
+		uint64_t startNs;
+		uint64_t endNs;
+		uint32_t track;
+	};
+
+	struct Window
+	{
+		std::vector<double> samples;	//ΣwindowSize
+		size_t next = 0;
+		bool gpu = false;
+	};
+
+	Profiler() : epoch(std::chrono::steady_clock::now()) {}
+
+	//ÿ̵߳һμ¼ʱעԼĻ壬֮ټ
+	ThreadBuffer& threadBuffer()
+	{
+		thread_local ThreadBufferOwner owner;
+		if (owner.buffer == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(buffersMutex);
+			for (auto& buffer : buffers)
+			{
+				if (!buffer->inUse)
+				{
+					owner.buffer = buffer.get();
+					break;
+				}
+			}
+			if (owner.buffer == nullptr)
+			{
+				buffers.push_back(std::make_unique<ThreadBuffer>());
+				owner.buffer = buffers.back().get();
+				owner.buffer->track = static_cast<uint32_t>(buffers.size());
+			}
+			owner.buffer->inUse = true;
+			owner.buffer->name = nullptr;
+		}
+		return *owner.buffer;
+	}
+
+	void releaseBuffer(ThreadBuffer* buffer)
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		buffer->inUse = false;
+	}
+
+	void addSample(const char* name, uint64_t startNs, uint64_t endNs, uint32_t track)
+	{
+		Window& window = windows[name];
+		window.gpu = track == gpuTrack;
+		double ms = (endNs - startNs) / 1e6;
+		if (window.samples.size() < windowSize)
+			window.samples.push_back(ms);
+		else
+			window.samples[window.next] = ms;
+		window.next = (window.next + 1) % windowSize;
+
+		if (captured.size() < captureLimit)
+			captured.push_back({ name, startNs, endNs, track });
+	}
+
+	static constexpr size_t windowSize = 1024;
+	static constexpr uint32_t gpuTrack = 1000;
+
+	std::chrono::steady_clock::time_point epoch;
+	std::mutex buffersMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	std::map<std::string, Window> windows;
+	std::vector<CapturedEvent> captured;
+	size_t captureLimit = 0;
+};
+
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char* name) : name(name), startNs(Profiler::instance().nowNs()) {}
+	~ProfileScope() { Profiler::instance().record(name, startNs, Profiler::instance().nowNs()); }
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char* name;
+	uint64_t startNs;
+};
+
+//GPUʱÿ֡һѯأ´õʱդѾȹһֵĽ
+class GpuProfiler
+{
+public:
+	void init(VkPhysicalDevice physicalDevice, VkDevice device, const VulkanDispatch& dispatch, uint32_t queueFamily, uint32_t framesInFlight)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+
+		VkPhysicalDeviceProperties properties;
+		dispatch.vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		timestampPeriod = properties.limits.timestampPeriod;
+
+		uint32_t queueFamilyCount = 0;
+		dispatch.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		dispatch.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+		uint32_t validBits = queueFamilies[queueFamily].timestampValidBits;
+		if (validBits == 0 || timestampPeriod == 0.0f)
+		{
+			printf("profiler: queue family %u does not support timestamps, GPU scopes disabled\n", queueFamily);
+			return;
+		}
+		timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+		frames.resize(framesInFlight);
+		for (auto& frame : frames)
+		{
+			VkQueryPoolCreateInfo poolInfo{};
+			poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+			poolInfo.queryCount = maxQueries;
+			if (dispatch.vkCreateQueryPool(device, &poolInfo, nullptr, &frame.queryPool) != VK_SUCCESS)
+				throw std::runtime_error("failed to create timestamp query pool!");
+		}
+	}
+
+	//¼һ֮֡ǰãһֵĽòѯ
+	void beginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+	{
+		if (frames.empty())
+			return;
+		current = &frames[frameIndex];
+		readBack(*current);
+
+		dispatch->vkCmdResetQueryPool(commandBuffer, current->queryPool, 0, maxQueries);
+		current->scopes.clear();
+		current->queryCount = 0;
+		current->cpuRecordNs = Profiler::instance().nowNs();
+	}
+
+	//ֻ߳¼Ƶãѯŵķûм
+	uint32_t beginScope(VkCommandBuffer commandBuffer, const char* name)
+	{
+		if (current == nullptr || current->queryCount + 2 > maxQueries)
+			return UINT32_MAX;
+		uint32_t query = current->queryCount;
+		current->queryCount += 2;
+		current->scopes.push_back({ name, query });
+		dispatch->vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, current->queryPool, query);
+		return query;
+	}
+
+	void endScope(VkCommandBuffer commandBuffer, uint32_t query)
+	{
+		if (query == UINT32_MAX)
+			return;
+		dispatch->vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, current->queryPool, query + 1);
+	}
+
+	void destroy()
+	{
+		for (auto& frame : frames)
+			dispatch->vkDestroyQueryPool(device, frame.queryPool, nullptr);
+		frames.clear();
+		current = nullptr;
+	}
+
+private:
+	struct Scope
+	{
+		const char* name;
+		uint32_t query;
+	};
+
+	struct FrameQueries
+	{
+		VkQueryPool queryPool = VK_NULL_HANDLE;
+		std::vector<Scope> scopes;
+		uint32_t queryCount = 0;
+		uint64_t cpuRecordNs = 0;
+	};
+
+	//GPUʱӺCPUʱӲͬԴtraceÿ֡һʱ뵽¼һ֡CPUʱ
+	void readBack(FrameQueries& frame)
+	{
+		if (frame.queryCount == 0)
+			return;
+
+		std::vector<uint64_t> timestamps(frame.queryCount);
+		if (dispatch->vkGetQueryPoolResults(device, frame.queryPool, 0, frame.queryCount, timestamps.size() * sizeof(uint64_t),
+			timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+			return;
+
+		uint64_t base = timestamps[0] & timestampMask;
+		for (const auto& scope : frame.scopes)
+		{
+			uint64_t begin = (timestamps[scope.query] & timestampMask) - base;
+			uint64_t end = (timestamps[scope.query + 1] & timestampMask) - base;
+			uint64_t startNs = frame.cpuRecordNs + static_cast<uint64_t>(begin * static_cast<double>(timestampPeriod));
+			uint64_t endNs = frame.cpuRecordNs + static_cast<uint64_t>(end * static_cast<double>(timestampPeriod));
+			Profiler::instance().recordGpu(scope.name, startNs, std::max(startNs, endNs));
+		}
+	}
+
+	static constexpr uint32_t maxQueries = 128;
+
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;
+	float timestampPeriod = 0.0f;	//ÿʱ̶ȵ
+	uint64_t timestampMask = ~0ull;
+	std::vector<FrameQueries> frames;
+	FrameQueries* current = nullptr;
+};
+
+class GpuProfileScope
+{
+public:
+	GpuProfileScope(GpuProfiler& profiler, VkCommandBuffer commandBuffer, const char* name)
+		: profiler(profiler), commandBuffer(commandBuffer), query(profiler.beginScope(commandBuffer, name)) {}
+	~GpuProfileScope() { profiler.endScope(commandBuffer, query); }
+
+	GpuProfileScope(const GpuProfileScope&) = delete;
+	GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+	GpuProfiler& profiler;
+	VkCommandBuffer commandBuffer;
+	uint32_t query;
+};
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#define GPU_PROFILE_SCOPE(gpuProfiler, commandBuffer, name) ((void)0)
+
+//رʱͬĽӿڣȫǿյ
+class Profiler
+{
+public:
+	static Profiler& instance()
+	{
+		static Profiler profiler;
+		return profiler;
+	}
+	void enableCapture(size_t = 0) {}
+	void collect() {}
+	void printSummary() {}
+	bool writeChromeTrace(const std::string&) { return false; }
+};
+
+class GpuProfiler
+{
+public:
+	void init(VkPhysicalDevice, VkDevice, const VulkanDispatch&, uint32_t, uint32_t) {}
+	void beginFrame(VkCommandBuffer, uint32_t) {}
+	void destroy() {}
+};
+
+#endif
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDispatch.h"
+
+#include<vector>
+#include<string>
+#include<fstream>
+#include<algorithm>
+#include<stdexcept>
+#include<cstdio>
+#include<cstdlib>
+
+//عԣ̶ȾN֡һ֡ضͽ׼ͼȽϣͬʱÿ֡CPU/GPUʱǷ񳬳Ԥ㡣
+//ҪںGPUlavapipeϾܡԤ㰴lavapipeͨCIϵıGPUϻɺܶ
+struct RegressionScene
+{
+	const char* name;
+	uint32_t drawCount;		//0ʾֻ
+	uint32_t frames;
+	double cpuBudgetMs;		//ÿ֡CPUʱp95
+	double gpuBudgetMs;		//ÿ֡GPUʱp95
+};
+
+inline const std::vector<RegressionScene>& regressionScenes()
+{
+	static const std::vector<RegressionScene> scenes = {
+		{ "clear", 0, 120, 2.0, 4.0 },
+		{ "draws-1k", 1000, 120, 8.0, 20.0 },
+		{ "draws-10k", 10000, 60, 40.0, 120.0 },
+	};
+	return scenes;
+}
+
+inline const RegressionScene* findRegressionScene(const std::string& name)
+{
+	for (const auto& scene : regressionScenes())
+	{
+		if (name == scene.name)
+			return &scene;
+	}
+	return nullptr;
+}
+
+//ÿ֡ʱס壻GpuProfilerͬ汾Ҳ
+class FrameTimestamps
+{
+public:
+	void init(VkPhysicalDevice physicalDevice, VkDevice device, const VulkanDispatch& dispatch, uint32_t queueFamily, uint32_t framesInFlight)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+
+		VkPhysicalDeviceProperties properties;
+		dispatch.vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		timestampPeriod = properties.limits.timestampPeriod;
+
+		uint32_t queueFamilyCount = 0;
+		dispatch.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		dispatch.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+		uint32_t validBits = queueFamilies[queueFamily].timestampValidBits;
+		if (validBits == 0 || timestampPeriod == 0.0f)
+		{
+			printf("regression: queue family %u does not support timestamps, GPU budget not checked\n", queueFamily);
+			return;
+		}
+		timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+		VkQueryPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		poolInfo.queryCount = framesInFlight * 2;
+		if (dispatch.vkCreateQueryPool(device, &poolInfo, nullptr, &queryPool) != VK_SUCCESS)
+			throw std::runtime_error("failed to create frame timestamp query pool!");
+		written.assign(framesInFlight, false);
+	}
+
+	bool supported() const { return queryPool != VK_NULL_HANDLE; }
+
+	//ȹ֡դԺãһֵGPUʱ䣬ûнʱظ
+	double collect(uint32_t frameIndex)
+	{
+		if (!supported() || !written[frameIndex])
+			return -1.0;
+		written[frameIndex] = false;
+
+		uint64_t timestamps[2];
+		if (dispatch->vkGetQueryPoolResults(device, queryPool, frameIndex * 2, 2, sizeof(timestamps), timestamps, sizeof(uint64_t),
+			VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+			return -1.0;
+		uint64_t ticks = ((timestamps[1] & timestampMask) - (timestamps[0] & timestampMask)) & timestampMask;
+		return ticks * static_cast<double>(timestampPeriod) / 1e6;
+	}
+
+	//忪ͷãȾ
+	void begin(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+	{
+		if (!supported())
+			return;
+		dispatch->vkCmdResetQueryPool(commandBuffer, queryPool, frameIndex * 2, 2);
+		dispatch->vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, frameIndex * 2);
+	}
+
+	void end(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+	{
+		if (!supported())
+			return;
+		dispatch->vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, frameIndex * 2 + 1);
+		written[frameIndex] = true;
+	}
+
+	void destroy()
+	{
+		if (queryPool != VK_NULL_HANDLE)
+			dispatch->vkDestroyQueryPool(device, queryPool, nullptr);
+		queryPool = VK_NULL_HANDLE;
+		written.clear();
+	}
+
+private:
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;
+	VkQueryPool queryPool = VK_NULL_HANDLE;
+	float timestampPeriod = 0.0f;
+	uint64_t timestampMask = ~0ull;
+	std::vector<bool> written;		//֡ʱѾ¼ơû
+};
+
+//RGBA8ͼ񣬽׼öPPMP6棬ֻRGB
+struct RegressionImage
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<uint8_t> rgba;
+
+	bool writePpm(const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return false;
+		file << "P6\n" << width << " " << height << "\n255\n";
+		std::vector<uint8_t> rgb(static_cast<size_t>(width) * height * 3);
+		for (size_t i = 0; i < static_cast<size_t>(width) * height; i++)
+		{
+			rgb[i * 3 + 0] = rgba[i * 4 + 0];
+			rgb[i * 3 + 1] = rgba[i * 4 + 1];
+			rgb[i * 3 + 2] = rgba[i * 4 + 2];
+		}
+		file.write(reinterpret_cast<const char*>(rgb.data()), rgb.size());
+		return static_cast<bool>(file);
+	}
+
+	bool readPpm(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		std::string magic;
+		uint32_t maxValue = 0;
+		if (!(file >> magic >> width >> height >> maxValue) || magic != "P6" || maxValue != 255)
+			return false;
+		file.get();
+
+		std::vector<uint8_t> rgb(static_cast<size_t>(width) * height * 3);
+		if (!file.read(reinterpret_cast<char*>(rgb.data()), rgb.size()))
+			return false;
+		rgba.resize(static_cast<size_t>(width) * height * 4);
+		for (size_t i = 0; i < static_cast<size_t>(width) * height; i++)
+		{
+			rgba[i * 4 + 0] = rgb[i * 3 + 0];
+			rgba[i * 4 + 1] = rgb[i * 3 + 1];
+			rgba[i * 4 + 2] = rgb[i * 3 + 2];
+			rgba[i * 4 + 3] = 255;
+		}
+		return true;
+	}
+};
+
+struct ImageDiff
+{
+	bool sizeMatches = false;
+	uint32_t maxChannelDiff = 0;
+	uint64_t mismatchedPixels = 0;	//ͨݲ
+};
+
+//ֻȽRGB֮ͻϵܲ1ÿͨһݲ
+inline ImageDiff compareImages(const RegressionImage& actual, const RegressionImage& golden, uint32_t tolerance)
+{
+	ImageDiff diff;
+	if (actual.width != golden.width || actual.height != golden.height)
+		return diff;
+	diff.sizeMatches = true;
+	for (size_t i = 0; i < static_cast<size_t>(actual.width) * actual.height; i++)
+	{
+		uint32_t pixelDiff = 0;
+		for (size_t c = 0; c < 3; c++)
+			pixelDiff = std::max<uint32_t>(pixelDiff, std::abs(actual.rgba[i * 4 + c] - golden.rgba[i * 4 + c]));
+		diff.maxChannelDiff = std::max(diff.maxChannelDiff, pixelDiff);
+		if (pixelDiff > tolerance)
+			diff.mismatchedPixels++;
+	}
+	return diff;
+}
+
+//ÿ֡ʱp95ԤȽϣ֡Ķʧ
+class FrameBudget
+{
+public:
+	void add(double ms)
+	{
+		samples.push_back(ms);
+	}
+
+	size_t count() const { return samples.size(); }
+
+	double percentile(double p) const
+	{
+		if (samples.empty())
+			return 0.0;
+		std::vector<double> sorted = samples;
+		std::sort(sorted.begin(), sorted.end());
+		return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * (sorted.size() - 1) + 0.5))];
+	}
+
+	//ӡһУԤʱfalseûʱ
+	bool check(const char* label, double budgetMs) const
+	{
+		if (samples.empty())
+		{
+			printf("regression: %s time not measured\n", label);
+			return true;
+		}
+		double p95 = percentile(0.95);
+		bool pass = budgetMs <= 0.0 || p95 <= budgetMs;
+		printf("regression: %s time p50 %.3f ms, p95 %.3f ms, max %.3f ms, budget %.3f ms -> %s\n", label,
+			percentile(0.5), p95, percentile(1.0), budgetMs, pass ? "ok" : "OVER BUDGET");
+		return pass;
+	}
+
+private:
+	std::vector<double> samples;
+};
@@ -0,0 +1,664 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDispatch.h"
+#include "MemoryAllocator.h"
+
+#include<vector>
+#include<string>
+#include<functional>
+#include<stdexcept>
+#include<algorithm>
+#include<cstdio>
+#include<cstdint>
+
+//ȾͼһԴĳͨе÷֡ͬ׶Ρͺͼusage
+enum class GraphAccess
+{
+	ColorAttachmentWrite,
+	TransferRead,
+	TransferWrite,
+	SampledRead,		//Ƭλɫ
+	StorageRead,		//ɫ洢ͼ
+	StorageWrite,
+};
+
+struct GraphAccessInfo
+{
+	VkImageLayout layout;
+	VkPipelineStageFlags2 stage;
+	VkAccessFlags2 access;
+	VkImageUsageFlags usage;
+	bool write;
+};
+
+inline GraphAccessInfo graphAccessInfo(GraphAccess access)
+{
+	switch (access)
+	{
+	case GraphAccess::ColorAttachmentWrite:
+		return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+			VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, true };
+	case GraphAccess::TransferRead:
+		return { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_USAGE_TRANSFER_SRC_BIT, false };
+	case GraphAccess::TransferWrite:
+		return { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_USAGE_TRANSFER_DST_BIT, true };
+	case GraphAccess::SampledRead:
+		return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_USAGE_SAMPLED_BIT, false };
+	case GraphAccess::StorageRead:
+		return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_USAGE_STORAGE_BIT, false };
+	case GraphAccess::StorageWrite:
+		return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT, VK_IMAGE_USAGE_STORAGE_BIT, true };
+	}
+	return {};
+}
+
+//ȾͼͨдЩͼcompile()޳ûõͨ
+//ڰѲصʱͼŵͬһԴϣÿͨǰҪϺϳһεá
+//ÿԴһͨддԺֻͨ԰˳
+//ͼ񣨱罻ͼͼдǵͨͨŻᱣ
+class RenderGraph
+{
+public:
+	using ExecuteFunction = std::function<void(VkCommandBuffer commandBuffer, const RenderGraph& graph)>;
+
+	struct ResourceUse
+	{
+		uint32_t resource;
+		GraphAccess access;
+	};
+
+	struct ImageDesc
+	{
+		uint32_t width;
+		uint32_t height;
+		VkFormat format;
+	};
+
+	//ͼִһεͳƣcompile̶
+	struct Stats
+	{
+		uint32_t passes = 0;
+		uint32_t culledPasses = 0;
+		uint32_t transientImages = 0;		//ʵʴģ޳ͨռĲ
+		uint32_t barriers = 0;				//ÿ֡ͼ
+		uint32_t barrierCalls = 0;			//ÿ֡vkCmdPipelineBarrier(2)
+		VkDeviceSize peakWithoutAliasing = 0;	//ÿʱͼ񵥶һԴʱ
+		VkDeviceSize peakWithAliasing = 0;		//ʵʷԴ
+	};
+
+	//cmdPipelineBarrier2ΪʱvkCmdPipelineBarrierõĽ׶κͷλöֵͬ
+	void init(VkDevice device, const VulkanDispatch& dispatch, MemoryAllocator& allocator, PFN_vkCmdPipelineBarrier2 cmdPipelineBarrier2)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+		this->allocator = &allocator;
+		this->cmdPipelineBarrier2 = cmdPipelineBarrier2;
+	}
+
+	//ʱͼֻһ֡ãԴͼ䣬ܺʱͼ
+	uint32_t createImage(const std::string& name, const ImageDesc& desc)
+	{
+		Resource resource;
+		resource.name = name;
+		resource.desc = desc;
+		resources.push_back(resource);
+		return static_cast<uint32_t>(resources.size() - 1);
+	}
+
+	//ⲿͼÿִ֡ǰsetImportedImageʼʱinitialLayout
+	//һʹinitialStageȴȡͼźĽ׶ΣͼִתfinalLayout
+	uint32_t importImage(const std::string& name, const ImageDesc& desc, VkImageLayout initialLayout, VkPipelineStageFlags2 initialStage,
+		VkImageLayout finalLayout, VkPipelineStageFlags2 finalStage, VkAccessFlags2 finalAccess)
+	{
+		Resource resource;
+		resource.name = name;
+		resource.desc = desc;
+		resource.imported = true;
+		resource.initialLayout = initialLayout;
+		resource.initialStage = initialStage;
+		resource.finalLayout = finalLayout;
+		resource.finalStage = finalStage;
+		resource.finalAccess = finalAccess;
+		resources.push_back(resource);
+		return static_cast<uint32_t>(resources.size() - 1);
+	}
+
+	void setImportedImage(uint32_t resource, VkImage image, VkImageView view)
+	{
+		resources[resource].image = image;
+		resources[resource].view = view;
+	}
+
+	uint32_t addPass(const std::string& name, std::vector<ResourceUse> uses, ExecuteFunction execute)
+	{
+		Pass pass;
+		pass.name = name;
+		pass.uses = std::move(uses);
+		pass.execute = std::move(execute);
+		passes.push_back(std::move(pass));
+		return static_cast<uint32_t>(passes.size() - 1);
+	}
+
+	//޳ʱͼϣ֮ټͨԴ
+	void compile()
+	{
+		findWriters();
+		cullPasses();
+		sortPasses();
+		computeLifetimes();
+		createTransientImages();
+		planBarriers();
+		compiled = true;
+	}
+
+	//źõ˳¼ͨÿͨǰһϵãѵͼתղ
+	void execute(VkCommandBuffer commandBuffer) const
+	{
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			recordBarriers(commandBuffer, barrierBatches[i]);
+			passes[order[i]].execute(commandBuffer, *this);
+		}
+		recordBarriers(commandBuffer, barrierBatches.back());
+	}
+
+	VkImage image(uint32_t resource) const { return resources[resource].image; }
+	VkImageView view(uint32_t resource) const { return resources[resource].view; }
+	const ImageDesc& desc(uint32_t resource) const { return resources[resource].desc; }
+	const Stats& getStats() const { return stats; }
+
+	void destroy()
+	{
+		for (auto& resource : resources)
+		{
+			if (resource.imported)
+				continue;
+			if (resource.view != VK_NULL_HANDLE)
+				dispatch->vkDestroyImageView(device, resource.view, nullptr);
+			if (resource.image != VK_NULL_HANDLE)
+				dispatch->vkDestroyImage(device, resource.image, nullptr);
+		}
+		for (auto& heap : heaps)
+			allocator->free(heap.allocation);
+		resources.clear();
+		passes.clear();
+		order.clear();
+		barrierBatches.clear();
+		heaps.clear();
+		stats = Stats{};
+		compiled = false;
+	}
+
+	//ִ˳ÿͨǰԼʱͼںԴλ
+	void printStats(bool detailed) const
+	{
+		if (!compiled)
+			return;
+		printf("render graph: %u passes (%u culled), %u transient images, %u barriers in %u calls per frame, "
+			"transient memory %.2f MB without aliasing, %.2f MB with aliasing\n",
+			stats.passes, stats.culledPasses, stats.transientImages, stats.barriers, stats.barrierCalls,
+			stats.peakWithoutAliasing / (1024.0 * 1024.0), stats.peakWithAliasing / (1024.0 * 1024.0));
+		if (!detailed)
+			return;
+		for (size_t i = 0; i < order.size(); i++)
+			printf("render graph:   %zu %-12s %zu barriers\n", i, passes[order[i]].name.c_str(), barrierBatches[i].size());
+		for (size_t i = 0; i < passes.size(); i++)
+		{
+			if (!passes[i].live)
+				printf("render graph:   culled %s\n", passes[i].name.c_str());
+		}
+		for (const auto& resource : resources)
+		{
+			if (resource.imported || resource.image == VK_NULL_HANDLE)
+				continue;
+			printf("render graph:   %-14s passes %u-%u, heap %u offset %8.2f MB, size %6.2f MB\n", resource.name.c_str(),
+				resource.firstUse, resource.lastUse, resource.heap, resource.offset / (1024.0 * 1024.0), resource.size / (1024.0 * 1024.0));
+		}
+	}
+
+private:
+	struct Resource
+	{
+		std::string name;
+		ImageDesc desc{};
+		bool imported = false;
+		VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VkPipelineStageFlags2 initialStage = VK_PIPELINE_STAGE_2_NONE;
+		VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VkPipelineStageFlags2 finalStage = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 finalAccess = VK_ACCESS_2_NONE;
+
+		int32_t writer = -1;			//дͨ
+		uint32_t firstUse = ~0u;		//źõ˳һκһõ
+		uint32_t lastUse = 0;
+		VkPipelineStageFlags2 lastStage = VK_PIPELINE_STAGE_2_NONE;	//һʹõĽ׶ΣһҪ
+		VkAccessFlags2 lastWriteAccess = VK_ACCESS_2_NONE;
+
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+		VkImageUsageFlags usage = 0;
+		VkDeviceSize size = 0;
+		VkDeviceSize offset = 0;		//Դλ
+		uint32_t heap = 0;
+	};
+
+	struct Pass
+	{
+		std::string name;
+		std::vector<ResourceUse> uses;
+		ExecuteFunction execute;
+		bool live = false;
+	};
+
+	//һϣresourceĲֺͬsrcתdst
+	struct Barrier
+	{
+		uint32_t resource;
+		VkImageLayout oldLayout;
+		VkImageLayout newLayout;
+		VkPipelineStageFlags2 srcStage;
+		VkAccessFlags2 srcAccess;
+		VkPipelineStageFlags2 dstStage;
+		VkAccessFlags2 dstAccess;
+	};
+
+	//ͬһڴ͵ʱͼһԴ
+	struct Heap
+	{
+		uint32_t memoryTypeBits;
+		VkDeviceSize alignment;
+		VkDeviceSize size;
+		Allocation allocation;
+	};
+
+	void findWriters()
+	{
+		for (size_t p = 0; p < passes.size(); p++)
+		{
+			std::vector<uint32_t> seen;
+			for (const auto& use : passes[p].uses)
+			{
+				if (std::find(seen.begin(), seen.end(), use.resource) != seen.end())
+					throw std::runtime_error("render graph pass " + passes[p].name + " uses " + resources[use.resource].name + " twice!");
+				seen.push_back(use.resource);
+				if (!graphAccessInfo(use.access).write)
+					continue;
+				Resource& resource = resources[use.resource];
+				if (resource.writer >= 0)
+					throw std::runtime_error("render graph resource " + resource.name + " is written by both " +
+						passes[resource.writer].name + " and " + passes[p].name + "!");
+				resource.writer = static_cast<int32_t>(p);
+			}
+		}
+	}
+
+	//дͼͨǶԴдߣҲͨǽûõ
+	void cullPasses()
+	{
+		std::vector<uint32_t> stack;
+		for (const auto& resource : resources)
+		{
+			if (resource.imported && resource.writer >= 0)
+				stack.push_back(static_cast<uint32_t>(resource.writer));
+		}
+		while (!stack.empty())
+		{
+			uint32_t p = stack.back();
+			stack.pop_back();
+			if (passes[p].live)
+				continue;
+			passes[p].live = true;
+			for (const auto& use : passes[p].uses)
+			{
+				const Resource& resource = resources[use.resource];
+				if (graphAccessInfo(use.access).write)
+					continue;
+				if (resource.writer >= 0)
+					stack.push_back(static_cast<uint32_t>(resource.writer));
+				else if (!resource.imported)
+					throw std::runtime_error("render graph pass " + passes[p].name + " reads " + resource.name + ", which nothing writes!");
+			}
+		}
+		stats.passes = static_cast<uint32_t>(passes.size());
+		stats.culledPasses = static_cast<uint32_t>(std::count_if(passes.begin(), passes.end(), [](const Pass& pass) { return !pass.live; }));
+	}
+
+	//Kahn㷨д->ߣͬʱİ˳򣬽ȶ
+	void sortPasses()
+	{
+		std::vector<uint32_t> pending(passes.size(), 0);
+		std::vector<std::vector<uint32_t>> readers(passes.size());
+		for (size_t p = 0; p < passes.size(); p++)
+		{
+			if (!passes[p].live)
+				continue;
+			for (const auto& use : passes[p].uses)
+			{
+				int32_t writer = resources[use.resource].writer;
+				if (graphAccessInfo(use.access).write || writer < 0)
+					continue;
+				readers[writer].push_back(static_cast<uint32_t>(p));
+				pending[p]++;
+			}
+		}
+
+		order.clear();
+		std::vector<bool> done(passes.size(), false);
+		for (;;)
+		{
+			uint32_t next = ~0u;
+			for (size_t p = 0; p < passes.size(); p++)
+			{
+				if (passes[p].live && !done[p] && pending[p] == 0)
+				{
+					next = static_cast<uint32_t>(p);
+					break;
+				}
+			}
+			if (next == ~0u)
+				break;
+			done[next] = true;
+			order.push_back(next);
+			for (uint32_t reader : readers[next])
+				pending[reader]--;
+		}
+		if (order.size() != passes.size() - stats.culledPasses)
+			throw std::runtime_error("render graph has a dependency cycle!");
+	}
+
+	void computeLifetimes()
+	{
+		for (uint32_t i = 0; i < order.size(); i++)
+		{
+			for (const auto& use : passes[order[i]].uses)
+			{
+				Resource& resource = resources[use.resource];
+				GraphAccessInfo info = graphAccessInfo(use.access);
+				resource.firstUse = std::min(resource.firstUse, i);
+				resource.lastUse = i;
+				resource.lastStage = info.stage;
+				resource.lastWriteAccess = info.write ? info.access : VK_ACCESS_2_NONE;
+				resource.usage |= info.usage;
+			}
+		}
+	}
+
+	static bool lifetimesOverlap(const Resource& a, const Resource& b)
+	{
+		return !(a.lastUse < b.firstUse || b.lastUse < a.firstUse);
+	}
+
+	//ȰСӴСţÿͼŵصͼ֮һŵµĿ϶
+	void createTransientImages()
+	{
+		std::vector<uint32_t> transients;
+		std::vector<VkMemoryRequirements> requirements(resources.size());
+		for (uint32_t r = 0; r < resources.size(); r++)
+		{
+			Resource& resource = resources[r];
+			if (resource.imported || resource.firstUse == ~0u)
+				continue;
+
+			VkImageCreateInfo imageInfo{};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.format = resource.desc.format;
+			imageInfo.extent = { resource.desc.width, resource.desc.height, 1 };
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.usage = resource.usage;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			if (dispatch->vkCreateImage(device, &imageInfo, nullptr, &resource.image) != VK_SUCCESS)
+				throw std::runtime_error("failed to create render graph image " + resource.name + "!");
+			dispatch->vkGetImageMemoryRequirements(device, resource.image, &requirements[r]);
+			resource.size = requirements[r].size;
+			stats.peakWithoutAliasing += requirements[r].size;
+			transients.push_back(r);
+		}
+		stats.transientImages = static_cast<uint32_t>(transients.size());
+
+		std::sort(transients.begin(), transients.end(), [this](uint32_t a, uint32_t b) {
+			return resources[a].size != resources[b].size ? resources[a].size > resources[b].size : a < b;
+		});
+		std::vector<uint32_t> placed;
+		for (uint32_t r : transients)
+		{
+			Resource& resource = resources[r];
+			const VkMemoryRequirements& req = requirements[r];
+			uint32_t heapIndex = 0;
+			while (heapIndex < heaps.size() && (heaps[heapIndex].memoryTypeBits & req.memoryTypeBits) == 0)
+				heapIndex++;
+			if (heapIndex == heaps.size())
+				heaps.push_back({ req.memoryTypeBits, req.alignment, 0, {} });
+			Heap& heap = heaps[heapIndex];
+			heap.memoryTypeBits &= req.memoryTypeBits;
+			heap.alignment = std::max(heap.alignment, req.alignment);
+
+			//ͬһԴصͼռ䣬ҵһ϶
+			std::vector<std::pair<VkDeviceSize, VkDeviceSize>> busy;
+			for (uint32_t other : placed)
+			{
+				if (resources[other].heap == heapIndex && lifetimesOverlap(resource, resources[other]))
+					busy.push_back({ resources[other].offset, resources[other].offset + resources[other].size });
+			}
+			std::sort(busy.begin(), busy.end());
+			VkDeviceSize offset = 0;
+			for (const auto& [begin, end] : busy)
+			{
+				if (offset + resource.size <= begin)
+					break;
+				offset = std::max(offset, (end + req.alignment - 1) / req.alignment * req.alignment);
+			}
+			resource.heap = heapIndex;
+			resource.offset = offset;
+			heap.size = std::max(heap.size, offset + resource.size);
+			placed.push_back(r);
+		}
+
+		for (auto& heap : heaps)
+		{
+			VkMemoryRequirements heapRequirements{ heap.size, heap.alignment, heap.memoryTypeBits };
+			heap.allocation = allocator->allocate(heapRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::OptimalImage,
+				AllocationStrategy::FreeList, true);
+			stats.peakWithAliasing += heap.size;
+		}
+		for (uint32_t r : transients)
+		{
+			Resource& resource = resources[r];
+			const Heap& heap = heaps[resource.heap];
+			if (dispatch->vkBindImageMemory(device, resource.image, heap.allocation.memory, heap.allocation.offset + resource.offset) != VK_SUCCESS)
+				throw std::runtime_error("failed to bind render graph image " + resource.name + "!");
+			if ((resource.usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT)) == 0)
+				continue;
+
+			VkImageViewCreateInfo viewInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = resource.image;
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = resource.desc.format;
+			viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			if (dispatch->vkCreateImageView(device, &viewInfo, nullptr, &resource.view) != VK_SUCCESS)
+				throw std::runtime_error("failed to create render graph image view " + resource.name + "!");
+		}
+	}
+
+	//ʱͼһʱϣUNDEFINEDתҪȹԴͼһ꣺
+	//һ֡ǰıһ֡ںģԼ
+	void aliasSource(const Resource& resource, VkPipelineStageFlags2& stage, VkAccessFlags2& access) const
+	{
+		stage = VK_PIPELINE_STAGE_2_NONE;
+		access = VK_ACCESS_2_NONE;
+		for (const auto& other : resources)
+		{
+			if (other.imported || other.image == VK_NULL_HANDLE || other.heap != resource.heap ||
+				other.offset >= resource.offset + resource.size || resource.offset >= other.offset + other.size)
+				continue;
+			stage |= other.lastStage;
+			access |= other.lastWriteAccess;
+		}
+	}
+
+	//ģһ֡ÿԴ״ֻ̬Ҫʱϣֱˡǰдддд
+	//ҪдǰждֻҪֲִͬ
+	void planBarriers()
+	{
+		struct State
+		{
+			VkImageLayout layout;
+			VkPipelineStageFlags2 writeStage;
+			VkAccessFlags2 writeAccess;
+			VkPipelineStageFlags2 readStages;
+			bool touched;
+		};
+		std::vector<State> states(resources.size());
+		for (size_t r = 0; r < resources.size(); r++)
+		{
+			const Resource& resource = resources[r];
+			states[r] = { resource.initialLayout, resource.initialStage, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_NONE, false };
+		}
+
+		barrierBatches.assign(order.size() + 1, {});
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			for (const auto& use : passes[order[i]].uses)
+			{
+				const Resource& resource = resources[use.resource];
+				State& state = states[use.resource];
+				GraphAccessInfo info = graphAccessInfo(use.access);
+				Barrier barrier{ use.resource, state.layout, info.layout, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, info.stage, info.access };
+
+				if (!state.touched && !resource.imported)
+				{
+					barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+					aliasSource(resource, barrier.srcStage, barrier.srcAccess);
+					barrierBatches[i].push_back(barrier);
+				}
+				else if (state.layout != info.layout || state.writeAccess != VK_ACCESS_2_NONE || (info.write && state.readStages != 0) ||
+					(!state.touched && state.writeStage != VK_PIPELINE_STAGE_2_NONE))
+				{
+					barrier.srcStage = state.writeStage | state.readStages;
+					barrier.srcAccess = state.writeAccess;
+					barrierBatches[i].push_back(barrier);
+				}
+				else
+				{
+					//Ѿǰдɼˣֻ¶Ľ׶
+					state.readStages |= info.stage;
+					continue;
+				}
+
+				state.touched = true;
+				state.layout = info.layout;
+				if (info.write)
+				{
+					state.writeStage = info.stage;
+					state.writeAccess = info.access;
+					state.readStages = VK_PIPELINE_STAGE_2_NONE;
+				}
+				else
+				{
+					//תһд֮Ķٵǰд
+					state.writeStage = VK_PIPELINE_STAGE_2_NONE;
+					state.writeAccess = VK_ACCESS_2_NONE;
+					state.readStages = info.stage;
+				}
+			}
+		}
+
+		//ͼתⲿҪĲֻ֣߻ض
+		for (uint32_t r = 0; r < resources.size(); r++)
+		{
+			const Resource& resource = resources[r];
+			const State& state = states[r];
+			if (!resource.imported || (state.layout == resource.finalLayout && state.writeAccess == VK_ACCESS_2_NONE))
+				continue;
+			barrierBatches.back().push_back({ r, state.layout, resource.finalLayout, state.writeStage | state.readStages, state.writeAccess,
+				resource.finalStage, resource.finalAccess });
+		}
+
+		for (const auto& batch : barrierBatches)
+		{
+			stats.barriers += static_cast<uint32_t>(batch.size());
+			stats.barrierCalls += batch.empty() ? 0 : 1;
+		}
+	}
+
+	void recordBarriers(VkCommandBuffer commandBuffer, const std::vector<Barrier>& batch) const
+	{
+		if (batch.empty())
+			return;
+
+		if (cmdPipelineBarrier2 != nullptr)
+		{
+			std::vector<VkImageMemoryBarrier2> barriers(batch.size());
+			for (size_t i = 0; i < batch.size(); i++)
+			{
+				VkImageMemoryBarrier2& barrier = barriers[i];
+				barrier = {};
+				barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+				barrier.srcStageMask = batch[i].srcStage;
+				barrier.srcAccessMask = batch[i].srcAccess;
+				barrier.dstStageMask = batch[i].dstStage;
+				barrier.dstAccessMask = batch[i].dstAccess;
+				barrier.oldLayout = batch[i].oldLayout;
+				barrier.newLayout = batch[i].newLayout;
+				barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.image = resources[batch[i].resource].image;
+				barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			}
+			VkDependencyInfo dependency{};
+			dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+			dependency.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+			dependency.pImageMemoryBarriers = barriers.data();
+			cmdPipelineBarrier2(commandBuffer, &dependency);
+			return;
+		}
+
+		//ϽӿֻһԽ׶룬ϲϵĽ׶Σ׶ΪʱTOP/BOTTOM
+		std::vector<VkImageMemoryBarrier> barriers(batch.size());
+		VkPipelineStageFlags srcStages = 0;
+		VkPipelineStageFlags dstStages = 0;
+		for (size_t i = 0; i < batch.size(); i++)
+		{
+			VkImageMemoryBarrier& barrier = barriers[i];
+			barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = static_cast<VkAccessFlags>(batch[i].srcAccess);
+			barrier.dstAccessMask = static_cast<VkAccessFlags>(batch[i].dstAccess);
+			barrier.oldLayout = batch[i].oldLayout;
+			barrier.newLayout = batch[i].newLayout;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = resources[batch[i].resource].image;
+			barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			srcStages |= static_cast<VkPipelineStageFlags>(batch[i].srcStage);
+			dstStages |= static_cast<VkPipelineStageFlags>(batch[i].dstStage);
+		}
+		if (srcStages == 0)
+			srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		if (dstStages == 0)
+			dstStages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		dispatch->vkCmdPipelineBarrier(commandBuffer, srcStages, dstStages, 0, 0, nullptr, 0, nullptr,
+			static_cast<uint32_t>(barriers.size()), barriers.data());
+	}
+
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;
+	MemoryAllocator* allocator = nullptr;
+	PFN_vkCmdPipelineBarrier2 cmdPipelineBarrier2 = nullptr;		//DeviceFeaturesvkGetDeviceProcAddrȡģͬ
+
+	std::vector<Resource> resources;
+	std::vector<Pass> passes;
+	std::vector<uint32_t> order;						//źĻͨ
+	std::vector<std::vector<Barrier>> barrierBatches;	//orderÿͨǰһһǵͼת
+	std::vector<Heap> heaps;
+	Stats stats;
+	bool compiled = false;
+};
@@ -0,0 +1,440 @@
+#pragma once
+
+#include<vector>
+#include<string>
+#include<new>
+#include<cmath>
+#include<cstdint>
+#include<cstring>
+#include<algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SCENE_STORE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+//MSVCҪѡAVX2ڽ
+#define SCENE_STORE_TARGET_SSE2
+#define SCENE_STORE_TARGET_AVX2
+#else
+#define SCENE_STORE_TARGET_SSE2 __attribute__((target("sse2")))
+#define SCENE_STORE_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+#endif
+
+//׶ƽ棬߳ڲλֱӴɫ
+struct Frustum
+{
+	float planes[6][4];
+
+	//viewProjȡGribb-Hartmannüռ䰴Vulkan0<=z<=w
+	static Frustum fromMatrix(const float m[16])
+	{
+		auto row = [m](int r, float out[4]) {
+			for (int c = 0; c < 4; c++)
+				out[c] = m[c * 4 + r];
+		};
+		float r0[4], r1[4], r2[4], r3[4];
+		row(0, r0);
+		row(1, r1);
+		row(2, r2);
+		row(3, r3);
+
+		Frustum frustum;
+		for (int c = 0; c < 4; c++)
+		{
+			frustum.planes[0][c] = r3[c] + r0[c];
+			frustum.planes[1][c] = r3[c] - r0[c];
+			frustum.planes[2][c] = r3[c] + r1[c];
+			frustum.planes[3][c] = r3[c] - r1[c];
+			frustum.planes[4][c] = r2[c];
+			frustum.planes[5][c] = r3[c] - r2[c];
+		}
+		for (auto& plane : frustum.planes)
+		{
+			float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+			for (float& value : plane)
+				value /= length;
+		}
+		return frustum;
+	}
+
+	//cull.compжȫһ֤CPUGPU޳ͬһ
+	bool intersectsSphere(const float center[3], float radius) const
+	{
+		for (const auto& plane : planes)
+		{
+			if (plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3] <= -radius)
+				return false;
+		}
+		return true;
+	}
+};
+
+//޳ںˣʱCPUֵָ֧ѡģпǿָ
+enum class CullKernel
+{
+	Scalar,
+	Sse,		//SSE2һ48ѹʽAVX2ͬ
+	Avx2,		//һ8òѿɼıѹ
+};
+
+inline const char* cullKernelName(CullKernel kernel)
+{
+	switch (kernel)
+	{
+	case CullKernel::Scalar: return "scalar";
+	case CullKernel::Sse: return "sse";
+	case CullKernel::Avx2: return "avx2";
+	}
+	return "unknown";
+}
+
+inline bool parseCullKernel(const std::string& name, CullKernel& kernel)
+{
+	if (name == "scalar")
+		kernel = CullKernel::Scalar;
+	else if (name == "sse")
+		kernel = CullKernel::Sse;
+	else if (name == "avx2")
+		kernel = CullKernel::Avx2;
+	else
+		return false;
+	return true;
+}
+
+inline bool cullKernelSupported(CullKernel kernel)
+{
+	switch (kernel)
+	{
+	case CullKernel::Scalar:
+		return true;
+#ifdef SCENE_STORE_X86
+	case CullKernel::Sse:
+#if defined(_M_X64) || defined(__x86_64__)
+		return true;
+#elif defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		return (info[3] & (1 << 26)) != 0;
+#else
+		return __builtin_cpu_supports("sse2");
+#endif
+	case CullKernel::Avx2:
+	{
+#if defined(_MSC_VER)
+		//CPUIDAVX2λҪȷϲϵͳYMMĴ
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+			return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+	default:
+		return false;
+	}
+}
+
+inline CullKernel bestCullKernel()
+{
+	if (cullKernelSupported(CullKernel::Avx2))
+		return CullKernel::Avx2;
+	if (cullKernelSupported(CullKernel::Sse))
+		return CullKernel::Sse;
+	return CullKernel::Scalar;
+}
+
+//64ֽڶ飬һ16floatAVX2ز
+template<typename T>
+class AlignedArray
+{
+public:
+	static constexpr size_t alignment = 64;
+
+	AlignedArray() = default;
+	AlignedArray(const AlignedArray&) = delete;
+	AlignedArray& operator=(const AlignedArray&) = delete;
+	AlignedArray(AlignedArray&& other) noexcept
+		: items(other.items), count(other.count), capacity(other.capacity)
+	{
+		other.items = nullptr;
+		other.count = other.capacity = 0;
+	}
+	AlignedArray& operator=(AlignedArray&& other) noexcept
+	{
+		std::swap(items, other.items);
+		std::swap(count, other.count);
+		std::swap(capacity, other.capacity);
+		return *this;
+	}
+	~AlignedArray() { release(); }
+
+	//ֻƽͣʱֱӰֽڸ
+	void reserve(size_t newCapacity)
+	{
+		if (newCapacity <= capacity)
+			return;
+		T* newItems = static_cast<T*>(::operator new(newCapacity * sizeof(T), std::align_val_t(alignment)));
+		if (count > 0)
+			memcpy(newItems, items, count * sizeof(T));
+		release();
+		items = newItems;
+		capacity = newCapacity;
+	}
+
+	void resize(size_t newCount)
+	{
+		reserve(newCount);
+		count = newCount;
+	}
+
+	void push_back(const T& value)
+	{
+		if (count == capacity)
+			reserve(std::max<size_t>(64, capacity * 2));
+		items[count++] = value;
+	}
+
+	void clear() { count = 0; }
+	size_t size() const { return count; }
+	T* data() { return items; }
+	const T* data() const { return items; }
+	T& operator[](size_t i) { return items[i]; }
+	const T& operator[](size_t i) const { return items[i]; }
+
+private:
+	void release()
+	{
+		if (items != nullptr)
+			::operator delete(items, std::align_val_t(alignment));
+		items = nullptr;
+	}
+
+	T* items = nullptr;
+	size_t count = 0;
+	size_t capacity = 0;
+};
+
+//尴SoA棺޳ֻɨΧĸ飬¼ƻʱȥ任ͻƲ
+class SceneStore
+{
+public:
+	struct Object
+	{
+		float position[3];
+		float scale;			//ͳһ
+		float localRadius;		//ϵİΧ뾶ԭ
+		uint32_t firstIndex;
+		uint32_t indexCount;
+	};
+
+	void reserve(size_t count)
+	{
+		for (auto* array : { &centerX, &centerY, &centerZ, &radius, &positionX, &positionY, &positionZ, &scale })
+			array->reserve(count);
+		firstIndex.reserve(count);
+		indexCount.reserve(count);
+	}
+
+	//ţGPU˳һ
+	uint32_t add(const Object& object)
+	{
+		positionX.push_back(object.position[0]);
+		positionY.push_back(object.position[1]);
+		positionZ.push_back(object.position[2]);
+		scale.push_back(object.scale);
+		firstIndex.push_back(object.firstIndex);
+		indexCount.push_back(object.indexCount);
+
+		//ռİΧ򣬱任Ҫ
+		centerX.push_back(object.position[0]);
+		centerY.push_back(object.position[1]);
+		centerZ.push_back(object.position[2]);
+		radius.push_back(object.localRadius * object.scale);
+		return static_cast<uint32_t>(radius.size() - 1);
+	}
+
+	void clear()
+	{
+		for (auto* array : { &centerX, &centerY, &centerZ, &radius, &positionX, &positionY, &positionZ, &scale })
+			array->clear();
+		firstIndex.clear();
+		indexCount.clear();
+		visibleCount = 0;
+	}
+
+	uint32_t size() const { return static_cast<uint32_t>(radius.size()); }
+
+	//ɼıŰдvisibleIndices()ظ
+	uint32_t cull(const Frustum& frustum, CullKernel kernel)
+	{
+		uint32_t count = size();
+		//AVX2ѹʱÿд8ţĩβһ
+		visible.resize(count + 8);
+		uint32_t* out = visible.data();
+		uint32_t simdEnd = count & ~7u;
+		uint32_t n = 0;
+		switch (kernel)
+		{
+#ifdef SCENE_STORE_X86
+		case CullKernel::Avx2:
+			n = cullAvx2(frustum, simdEnd, out);
+			break;
+		case CullKernel::Sse:
+			n = cullSse(frustum, simdEnd, out);
+			break;
+#endif
+		default:
+			simdEnd = 0;
+			break;
+		}
+		visibleCount = n + cullScalar(frustum, simdEnd, count, out + n);
+		return visibleCount;
+	}
+
+	const uint32_t* visibleIndices() const { return visible.data(); }
+	uint32_t visibleSize() const { return visibleCount; }
+
+	//Χ
+	AlignedArray<float> centerX, centerY, centerZ, radius;
+	//任
+	AlignedArray<float> positionX, positionY, positionZ, scale;
+	//Ʋ
+	AlignedArray<uint32_t> firstIndex, indexCount;
+
+private:
+	//Frustum::intersectsSphere˳һ£ں˵Ľͬ
+	uint32_t cullScalar(const Frustum& frustum, uint32_t begin, uint32_t end, uint32_t* out) const
+	{
+		uint32_t n = 0;
+		for (uint32_t i = begin; i < end; i++)
+		{
+			float negRadius = -radius[i];
+			bool inside = true;
+			for (const auto& plane : frustum.planes)
+				inside &= plane[0] * centerX[i] + plane[1] * centerY[i] + plane[2] * centerZ[i] + plane[3] > negRadius;
+			//޷֧дٰǷǰ
+			out[n] = i;
+			n += inside ? 1 : 0;
+		}
+		return n;
+	}
+
+#ifdef SCENE_STORE_X86
+	//ÿδ4ƴɺAVX2һ8λ룬ͬһѹ
+	SCENE_STORE_TARGET_SSE2 uint32_t cullSse(const Frustum& frustum, uint32_t end, uint32_t* out) const
+	{
+		__m128 planes[6][4];
+		for (int p = 0; p < 6; p++)
+			for (int c = 0; c < 4; c++)
+				planes[p][c] = _mm_set1_ps(frustum.planes[p][c]);
+		const __m128 signBit = _mm_set1_ps(-0.0f);
+		const __m128i zero = _mm_setzero_si128();
+		const uint64_t* table = compressTable();
+
+		uint32_t n = 0;
+		for (uint32_t i = 0; i < end; i += 8)
+		{
+			int mask = 0;
+			for (uint32_t half = 0; half < 2; half++)
+			{
+				uint32_t base = i + half * 4;
+				__m128 x = _mm_load_ps(centerX.data() + base);
+				__m128 y = _mm_load_ps(centerY.data() + base);
+				__m128 z = _mm_load_ps(centerZ.data() + base);
+				__m128 negRadius = _mm_xor_ps(_mm_load_ps(radius.data() + base), signBit);
+				__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				for (int p = 0; p < 6; p++)
+				{
+					__m128 d = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(planes[p][0], x), _mm_mul_ps(planes[p][1], y)),
+						_mm_mul_ps(planes[p][2], z)), planes[p][3]);
+					inside = _mm_and_ps(inside, _mm_cmpgt_ps(d, negRadius));
+				}
+				mask |= _mm_movemask_ps(inside) << (half * 4);
+			}
+			//SSE2ûpmovzxκ㽻8ֽչ32λ
+			__m128i bytes = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(table + mask)), zero);
+			__m128i offset = _mm_set1_epi32(static_cast<int>(i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + n), _mm_add_epi32(_mm_unpacklo_epi16(bytes, zero), offset));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + n + 4), _mm_add_epi32(_mm_unpackhi_epi16(bytes, zero), offset));
+			n += bitCount8(static_cast<uint32_t>(mask));
+		}
+		return n;
+	}
+
+	SCENE_STORE_TARGET_AVX2 uint32_t cullAvx2(const Frustum& frustum, uint32_t end, uint32_t* out) const
+	{
+		__m256 planes[6][4];
+		for (int p = 0; p < 6; p++)
+			for (int c = 0; c < 4; c++)
+				planes[p][c] = _mm256_set1_ps(frustum.planes[p][c]);
+		const __m256 signBit = _mm256_set1_ps(-0.0f);
+		const uint64_t* table = compressTable();
+
+		uint32_t n = 0;
+		for (uint32_t i = 0; i < end; i += 8)
+		{
+			__m256 x = _mm256_load_ps(centerX.data() + i);
+			__m256 y = _mm256_load_ps(centerY.data() + i);
+			__m256 z = _mm256_load_ps(centerZ.data() + i);
+			__m256 negRadius = _mm256_xor_ps(_mm256_load_ps(radius.data() + i), signBit);
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (int p = 0; p < 6; p++)
+			{
+				//FMAͱ汾һ
+				__m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planes[p][0], x), _mm256_mul_ps(planes[p][1], y)),
+					_mm256_mul_ps(planes[p][2], z)), planes[p][3]);
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negRadius, _CMP_GT_OQ));
+			}
+			//8λɼͨţһд8ֻǰɼĸ
+			int mask = _mm256_movemask_ps(inside);
+			__m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(table + mask)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + n), _mm256_add_epi32(lanes, _mm256_set1_epi32(static_cast<int>(i))));
+			n += static_cast<uint32_t>(_mm_popcnt_u32(static_cast<unsigned>(mask)));
+		}
+		return n;
+	}
+
+	//256Ӧһͨţÿռһֽ
+	static const uint64_t* compressTable()
+	{
+		static const std::vector<uint64_t> table = [] {
+			std::vector<uint64_t> entries(256);
+			for (uint32_t mask = 0; mask < 256; mask++)
+			{
+				uint64_t packed = 0;
+				uint32_t slot = 0;
+				for (uint32_t lane = 0; lane < 8; lane++)
+				{
+					if (mask & (1u << lane))
+						packed |= static_cast<uint64_t>(lane) << (8 * slot++);
+				}
+				entries[mask] = packed;
+			}
+			return entries;
+		}();
+		return table.data();
+	}
+
+	//SSE2·ܼٶpopcnt
+	static uint32_t bitCount8(uint32_t v)
+	{
+		v = v - ((v >> 1) & 0x55);
+		v = (v & 0x33) + ((v >> 2) & 0x33);
+		return (v + (v >> 4)) & 0x0F;
+	}
+#endif
+
+	AlignedArray<uint32_t> visible;
+	uint32_t visibleCount = 0;
+};
@@ -0,0 +1,567 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDispatch.h"
+#include "Profiler.h"
+
+#include<vector>
+#include<string>
+#include<map>
+#include<set>
+#include<deque>
+#include<fstream>
+#include<sstream>
+#include<filesystem>
+#include<functional>
+#include<thread>
+#include<mutex>
+#include<atomic>
+#include<chrono>
+#include<stdexcept>
+#include<algorithm>
+#include<cstdio>
+#include<cstdint>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#define SHADER_MANAGER_INOTIFY 1
+#endif
+
+#ifdef _WIN32
+#define SHADER_POPEN _popen
+#define SHADER_PCLOSE _pclose
+#else
+#define SHADER_POPEN popen
+#define SHADER_PCLOSE pclose
+#endif
+
+//·CMakeҵglslcʱPATH
+#ifndef VULKAN_01_GLSLC
+#define VULKAN_01_GLSLC "glslc"
+#endif
+
+//ɫԴĿ¼CMakebuildĿ¼ʱԴ벻./shadersCMake·
+#ifndef VULKAN_01_SHADER_SOURCE_DIR
+#define VULKAN_01_SHADER_SOURCE_DIR "shaders"
+#endif
+
+//ɫģԴ+׶+궨塱ݹϣڴϻõSPIR-V
+//ԴûͲٵñģһõʱŴͬһ干һģ顣
+//غ󣬺̨߳inotifyԴĿ¼Ķɫ±룬ֻؽĹߣ
+//¹ں̨ã֮߳֡任ϣɹߵȷ֡
+class ShaderManager
+{
+public:
+	struct Stats
+	{
+		uint64_t memoryHits = 0;		//ģѾ
+		uint64_t diskHits = 0;			//̻ϣSPIR-V
+		uint64_t misses = 0;			//˱
+		uint64_t prebuilt = 0;			//ûԴʧܣshaderDirԤ.spv
+		uint64_t failures = 0;			//ʧܵĴ
+		uint64_t reloads = 0;			//ػϵɫ
+		uint64_t pipelineRebuilds = 0;	//ؽĹ
+		double compileMs = 0.0;			//ʱ
+		double maxCompileMs = 0.0;
+	};
+
+	//sourceDirGLSLԴ룬prebuiltDirǹʱõname.spvcacheDirѰַĻ
+	void init(VkDevice device, const VulkanDispatch& dispatch, const std::string& sourceDir, const std::string& prebuiltDir, const std::string& cacheDir,
+		const std::string& compiler, uint32_t framesInFlight)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+		this->sourceDir = sourceDir;
+		this->prebuiltDir = prebuiltDir;
+		this->cacheDir = cacheDir;
+		this->compiler = compiler;
+		this->framesInFlight = framesInFlight;
+		stats = Stats{};
+		frameCounter = 0;
+
+		std::error_code ec;
+		std::filesystem::create_directories(cacheDir, ec);
+		if (ec)
+			printf("shaders: cannot create cache directory %s: %s\n", cacheDir.c_str(), ec.message().c_str());
+	}
+
+	//ȡɫģ飬nameԴļcull.comp׶ΰչdefines"NAME""NAME=VALUE"
+	//̵߳ãģУ÷Ҫ
+	VkShaderModule get(const std::string& name, const std::vector<std::string>& defines = {})
+	{
+		std::string key = variantKey(name, defines);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			auto it = variants.find(key);
+			if (it != variants.end())
+			{
+				stats.memoryHits++;
+				return it->second.module;
+			}
+		}
+
+		Variant variant;
+		variant.name = name;
+		variant.defines = defines;
+		std::vector<uint32_t> code = loadCode(variant, true);
+		VkShaderModule module = createModule(code, name);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		auto [it, inserted] = variants.try_emplace(key, variant);
+		if (!inserted)
+		{
+			//һ߳Ƚˣ
+			dispatch->vkDestroyShaderModule(device, module, nullptr);
+			return it->second.module;
+		}
+		it->second.module = module;
+		return module;
+	}
+
+	//ǼĳЩɫһߣʱں̵̨߳rebuild¹ߣʧܷfalseɵģ
+	//֮߳update()swapϡصıٹǰremoveDependent
+	uint32_t addDependent(const std::vector<std::string>& shaders, std::function<bool()> rebuild, std::function<void()> swap)
+	{
+		std::lock_guard<std::mutex> lock(dependentMutex);
+		uint32_t id = nextDependentId++;
+		dependents[id] = Dependent{ std::set<std::string>(shaders.begin(), shaders.end()), std::move(rebuild), std::move(swap) };
+		return id;
+	}
+
+	//̨߳ؽһʱꣻ֮󲻻ٵrebuildswap
+	void removeDependent(uint32_t id)
+	{
+		std::lock_guard<std::mutex> lock(dependentMutex);
+		dependents.erase(id);
+		std::lock_guard<std::mutex> swapLock(mutex);
+		pendingSwaps.erase(std::remove(pendingSwaps.begin(), pendingSwaps.end(), id), pendingSwaps.end());
+	}
+
+	//Ĺߵз֡Ժ
+	void retire(std::function<void()> destroy)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		retired.push_back({ frameCounter + framesInFlight, std::move(destroy) });
+	}
+
+	//ÿ֡ȹդԺ̵߳ãϺ̨õĹߣѾûõľɶ
+	void update()
+	{
+		std::vector<uint32_t> swaps;
+		std::vector<std::function<void()>> expired;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			swaps.swap(pendingSwaps);
+			frameCounter++;
+			while (!retired.empty() && retired.front().frame <= frameCounter)
+			{
+				expired.push_back(std::move(retired.front().destroy));
+				retired.pop_front();
+			}
+		}
+		for (auto& destroy : expired)
+			destroy();
+		if (swaps.empty())
+			return;
+
+		//̨̻߳ؽĹʱһ֡ٻ
+		std::unique_lock<std::mutex> lock(dependentMutex, std::try_to_lock);
+		if (!lock.owns_lock())
+		{
+			std::lock_guard<std::mutex> swapLock(mutex);
+			pendingSwaps.insert(pendingSwaps.begin(), swaps.begin(), swaps.end());
+			return;
+		}
+		for (uint32_t id : swaps)
+		{
+			auto it = dependents.find(id);
+			if (it != dependents.end())
+				it->second.swap();
+		}
+	}
+
+	//ʼԴĿ¼ֻLinuxinotify֧
+	void startWatching()
+	{
+#ifdef SHADER_MANAGER_INOTIFY
+		if (watcher.joinable())
+			return;
+		inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		//༭ʱеֱдедʱļٸֶҪ
+		if (inotifyFd < 0 || inotify_add_watch(inotifyFd, sourceDir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+		{
+			printf("shaders: cannot watch %s, hot reload disabled\n", sourceDir.c_str());
+			if (inotifyFd >= 0)
+				close(inotifyFd);
+			inotifyFd = -1;
+			return;
+		}
+		stopping = false;
+		watcher = std::thread(&ShaderManager::watchLoop, this);
+		printf("shaders: watching %s for changes\n", sourceDir.c_str());
+#else
+		printf("shaders: hot reload needs inotify and is only available on Linux\n");
+#endif
+	}
+
+	//ǰ豸ҪУݶĶȫ
+	void destroy()
+	{
+		stopWatching();
+		for (auto& entry : retired)
+			entry.destroy();
+		retired.clear();
+		for (auto& [key, variant] : variants)
+			dispatch->vkDestroyShaderModule(device, variant.module, nullptr);
+		variants.clear();
+		dependents.clear();
+		pendingSwaps.clear();
+	}
+
+	Stats getStats() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return stats;
+	}
+
+	void printStats() const
+	{
+		//̻߳ͬʱvariantsstatsһȡ
+		Stats s;
+		size_t moduleCount;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			s = stats;
+			moduleCount = variants.size();
+		}
+		if (s.memoryHits + s.diskHits + s.misses + s.prebuilt == 0)
+			return;
+		printf("shaders: %zu modules, %llu memory hits, %llu disk cache hits, %llu misses (compile %.1f ms total, %.1f ms max), %llu prebuilt, %llu failed\n",
+			moduleCount, static_cast<unsigned long long>(s.memoryHits), static_cast<unsigned long long>(s.diskHits),
+			static_cast<unsigned long long>(s.misses), s.compileMs, s.maxCompileMs, static_cast<unsigned long long>(s.prebuilt),
+			static_cast<unsigned long long>(s.failures));
+		if (s.reloads > 0)
+			printf("shaders: %llu hot reloads, %llu pipeline rebuilds\n", static_cast<unsigned long long>(s.reloads),
+				static_cast<unsigned long long>(s.pipelineRebuilds));
+	}
+
+private:
+	struct Variant
+	{
+		std::string name;
+		std::vector<std::string> defines;
+		uint64_t hash = 0;						//ϴμʱԴݹϣ0ʾõԤļ
+		VkShaderModule module = VK_NULL_HANDLE;
+	};
+
+	struct Dependent
+	{
+		std::set<std::string> shaders;
+		std::function<bool()> rebuild;
+		std::function<void()> swap;
+	};
+
+	struct Retired
+	{
+		uint64_t frame;							//frameCounterֵʱ
+		std::function<void()> destroy;
+	};
+
+	static std::string variantKey(const std::string& name, const std::vector<std::string>& defines)
+	{
+		std::string key = name;
+		for (const auto& define : defines)
+			key += "|" + define;
+		return key;
+	}
+
+	//FNV-1a 64λ#includeõincludeɫͷļҪ建
+	static uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	uint64_t contentHash(const Variant& variant, const std::string& source) const
+	{
+		uint64_t hash = 14695981039346656037ull;
+		//ѡҲҪ±
+		std::string header = compiler + "|-O|" + variantKey(variant.name, variant.defines);
+		hash = hashBytes(hash, header.data(), header.size() + 1);
+		hash = hashBytes(hash, source.data(), source.size());
+		return hash == 0 ? 1 : hash;
+	}
+
+	static bool readText(const std::string& path, std::string& text)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			return false;
+		std::ostringstream stream;
+		stream << file.rdbuf();
+		text = stream.str();
+		return true;
+	}
+
+	static bool readCode(const std::string& path, std::vector<uint32_t>& code)
+	{
+		std::ifstream file(path, std::ios::ate | std::ios::binary);
+		if (!file)
+			return false;
+		size_t size = static_cast<size_t>(file.tellg());
+		if (size == 0 || size % sizeof(uint32_t) != 0)
+			return false;
+		code.resize(size / sizeof(uint32_t));
+		file.seekg(0);
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(code.data()), size));
+	}
+
+	std::string cachePath(uint64_t hash) const
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.spv", static_cast<unsigned long long>(hash));
+		return (std::filesystem::path(cacheDir) / name).string();
+	}
+
+	//Դ->->ʱ˻ԤļallowPrebuiltΪfalseأʱʧܷؿ
+	std::vector<uint32_t> loadCode(Variant& variant, bool allowPrebuilt)
+	{
+		std::vector<uint32_t> code;
+		std::string source;
+		std::string sourcePath = (std::filesystem::path(sourceDir) / variant.name).string();
+		if (readText(sourcePath, source))
+		{
+			uint64_t hash = contentHash(variant, source);
+			if (readCode(cachePath(hash), code))
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stats.diskHits++;
+				variant.hash = hash;
+				return code;
+			}
+			if (compile(variant, sourcePath, cachePath(hash)) && readCode(cachePath(hash), code))
+			{
+				variant.hash = hash;
+				return code;
+			}
+		}
+		if (!allowPrebuilt)
+			return {};
+
+		//ûԴ߱ʧܣùʱõģ궨ֻԴʱЧ
+		std::string prebuiltPath = (std::filesystem::path(prebuiltDir) / (variant.name + ".spv")).string();
+		if (!variant.defines.empty() || !readCode(prebuiltPath, code))
+			throw std::runtime_error("failed to load shader " + variant.name + ": no source in " + sourceDir + " and no " + prebuiltPath + "!");
+		std::lock_guard<std::mutex> lock(mutex);
+		stats.prebuilt++;
+		variant.hash = 0;
+		return code;
+	}
+
+	//ñдʱļɹ棬߳ͬʱͬһϣҲļ
+	bool compile(const Variant& variant, const std::string& sourcePath, const std::string& outputPath)
+	{
+		std::string tmpPath = outputPath + "." + std::to_string(tmpCounter++) + ".tmp";
+		std::string command = "\"" + compiler + "\" -O";
+		for (const auto& define : variant.defines)
+			command += " -D" + define;
+		command += " -o \"" + tmpPath + "\" \"" + sourcePath + "\" 2>&1";
+
+		auto start = std::chrono::steady_clock::now();
+		std::string output;
+		int status = -1;
+		if (FILE* pipe = SHADER_POPEN(command.c_str(), "r"))
+		{
+			char buffer[256];
+			while (fgets(buffer, sizeof(buffer), pipe) != nullptr)
+				output += buffer;
+			status = SHADER_PCLOSE(pipe);
+		}
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::error_code ec;
+		bool ok = status == 0 && std::filesystem::exists(tmpPath, ec);
+		if (ok)
+		{
+			std::filesystem::rename(tmpPath, outputPath, ec);
+			ok = !ec;
+		}
+		std::filesystem::remove(tmpPath, ec);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stats.misses++;
+			stats.compileMs += ms;
+			stats.maxCompileMs = std::max(stats.maxCompileMs, ms);
+			if (!ok)
+				stats.failures++;
+		}
+		if (!ok)
+			printf("shaders: failed to compile %s (%s):\n%s", variant.name.c_str(), compiler.c_str(), output.c_str());
+		return ok;
+	}
+
+	VkShaderModule createModule(const std::vector<uint32_t>& code, const std::string& name)
+	{
+		VkShaderModuleCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		createInfo.codeSize = code.size() * sizeof(uint32_t);
+		createInfo.pCode = code.data();
+		VkShaderModule module;
+		if (dispatch->vkCreateShaderModule(device, &createInfo, nullptr, &module) != VK_SUCCESS)
+			throw std::runtime_error("failed to create shader module " + name + "!");
+		return module;
+	}
+
+	//̨̣߳±ĶԴӦб壬ݹϣû䣨ֻǱһ£
+	//ģؽǵĹߣ̵߳update()
+	void reload(const std::set<std::string>& changedFiles)
+	{
+		std::vector<std::pair<std::string, Variant>> candidates;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (const auto& [key, variant] : variants)
+			{
+				if (changedFiles.count(variant.name) != 0)
+					candidates.push_back({ key, variant });
+			}
+		}
+
+		std::set<std::string> reloaded;
+		for (auto& [key, variant] : candidates)
+		{
+			std::string source;
+			if (!readText((std::filesystem::path(sourceDir) / variant.name).string(), source) || contentHash(variant, source) == variant.hash)
+				continue;
+			std::vector<uint32_t> code = loadCode(variant, false);
+			if (code.empty())
+				continue;
+
+			VkShaderModule module = createModule(code, variant.name);
+			std::lock_guard<std::mutex> lock(mutex);
+			auto it = variants.find(key);
+			//ģ߳ȥߣһӺ
+			VkShaderModule old = it->second.module;
+			VkDevice device = this->device;
+			PFN_vkDestroyShaderModule destroyShaderModule = dispatch->vkDestroyShaderModule;
+			retired.push_back({ frameCounter + framesInFlight, [device, destroyShaderModule, old] { destroyShaderModule(device, old, nullptr); } });
+			it->second.module = module;
+			it->second.hash = variant.hash;
+			stats.reloads++;
+			reloaded.insert(variant.name);
+		}
+		if (reloaded.empty())
+			return;
+
+		auto start = std::chrono::steady_clock::now();
+		uint32_t rebuilt = 0;
+		{
+			std::lock_guard<std::mutex> lock(dependentMutex);
+			for (auto& [id, dependent] : dependents)
+			{
+				bool affected = std::any_of(reloaded.begin(), reloaded.end(),
+					[&dependent](const std::string& name) { return dependent.shaders.count(name) != 0; });
+				if (!affected || !dependent.rebuild())
+					continue;
+				std::lock_guard<std::mutex> swapLock(mutex);
+				pendingSwaps.push_back(id);
+				stats.pipelineRebuilds++;
+				rebuilt++;
+			}
+		}
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::string names;
+		for (const auto& name : reloaded)
+			names += (names.empty() ? "" : ", ") + name;
+		printf("shaders: reloaded %s, rebuilt %u pipeline groups in %.1f ms\n", names.c_str(), rebuilt, ms);
+	}
+
+#ifdef SHADER_MANAGER_INOTIFY
+	void watchLoop()
+	{
+		PROFILE_THREAD_NAME("shader watcher");
+		alignas(struct inotify_event) char buffer[4096];
+		std::set<std::string> changed;
+		while (!stopping)
+		{
+			//ʱstoppingҲһαĶ¼
+			pollfd descriptor{ inotifyFd, POLLIN, 0 };
+			int ready = poll(&descriptor, 1, changed.empty() ? 100 : 50);
+			if (ready > 0)
+			{
+				ssize_t length;
+				while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0)
+				{
+					for (char* p = buffer; p < buffer + length;)
+					{
+						const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+						if (event->len > 0)
+							changed.insert(event->name);
+						p += sizeof(inotify_event) + event->len;
+					}
+				}
+				continue;
+			}
+			if (changed.empty())
+				continue;
+
+			try
+			{
+				reload(changed);
+			}
+			catch (const std::exception& e)
+			{
+				printf("shaders: hot reload failed: %s\n", e.what());
+			}
+			changed.clear();
+		}
+	}
+#endif
+
+	void stopWatching()
+	{
+#ifdef SHADER_MANAGER_INOTIFY
+		if (watcher.joinable())
+		{
+			stopping = true;
+			watcher.join();
+		}
+		if (inotifyFd >= 0)
+			close(inotifyFd);
+		inotifyFd = -1;
+#endif
+	}
+
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;
+	std::string sourceDir;
+	std::string prebuiltDir;
+	std::string cacheDir;
+	std::string compiler;
+	uint32_t framesInFlight = 2;
+
+	mutable std::mutex mutex;					//variantsstatspendingSwapsretired
+	std::map<std::string, Variant> variants;	//ּӺ궨
+	Stats stats;
+	std::vector<uint32_t> pendingSwaps;			//̨á̻߳ϵ
+	std::deque<Retired> retired;
+	uint64_t frameCounter = 0;
+	std::atomic<uint32_t> tmpCounter{ 0 };
+
+	std::mutex dependentMutex;					//ؽڼһֱУremoveDependentؽ
+	std::map<uint32_t, Dependent> dependents;
+	uint32_t nextDependentId = 1;
+
+	std::thread watcher;
+	std::atomic<bool> stopping{ false };
+#ifdef SHADER_MANAGER_INOTIFY
+	int inotifyFd = -1;
+#endif
+};
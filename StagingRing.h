@@ -0,0 +1,463 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDispatch.h"
+#include "MemoryAllocator.h"
+
+#include<vector>
+#include<deque>
+#include<map>
+#include<chrono>
+#include<stdexcept>
+#include<algorithm>
+#include<cstring>
+#include<cstdio>
+
+//ݴ滷λ壺дһֱӳŵɼ壬ڴƵ豸Դ
+//ÿύһդGPUύ˳ջĿռ
+class StagingRing
+{
+public:
+	//dstQueueFamilyʹЩԴĶ壨ͼΣʹ岻ͬʱҪȨת
+	void init(VkDevice device, const VulkanDispatch& dispatch, MemoryAllocator& allocator, VkQueue queue, uint32_t queueFamily,
+		uint32_t dstQueueFamily, VkDeviceSize size)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+		this->allocator = &allocator;
+		this->queue = queue;
+		this->queueFamily = queueFamily;
+		this->dstQueueFamily = dstQueueFamily;
+		capacity = size;
+
+		allocator.createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffer, allocation);
+		mapped = static_cast<char*>(allocation.mapped);
+		if (mapped == nullptr)
+			throw std::runtime_error("staging buffer is not host visible!");
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = queueFamily;
+		if (dispatch.vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+			throw std::runtime_error("failed to create staging command pool!");
+	}
+
+	//ϴ壬Сķ֮һݲɶΣһεı
+	uint64_t uploadBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size)
+	{
+		const char* src = static_cast<const char*>(data);
+		VkDeviceSize maxChunk = capacity / 4;
+		while (size > 0)
+		{
+			VkDeviceSize chunk = std::min(size, maxChunk);
+			VkDeviceSize offset = reserve(chunk, copyAlignment);
+			memcpy(mapped + offset, src, chunk);
+
+			current.bufferCopies[dst].push_back({ offset, dstOffset, chunk });
+			current.bytes += chunk;
+
+			src += chunk;
+			dstOffset += chunk;
+			size -= chunk;
+		}
+		return nextBatchId;
+	}
+
+	//ڻԤsizeֽڲźøƵdstӳַ÷һεû֮ǰдꣻ
+	//ڽѹֱɵݴڴݣʡһmemcpy
+	void* reserveBufferUpload(VkBuffer dst, VkDeviceSize dstOffset, VkDeviceSize size)
+	{
+		if (size > capacity / 2)
+			throw std::runtime_error("buffer upload is too large for the staging ring!");
+
+		VkDeviceSize offset = reserve(size, copyAlignment);
+		current.bufferCopies[dst].push_back({ offset, dstOffset, size });
+		current.bytes += size;
+		return mapped + offset;
+	}
+
+	//ϴͼĵ0ͼҪŽתfinalLayout
+	uint64_t uploadImage(VkImage dst, VkExtent3D extent, const void* data, VkDeviceSize size,
+		VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+	{
+		if (size > capacity / 2)
+			throw std::runtime_error("image is too large for the staging ring!");
+
+		VkDeviceSize offset = reserve(size, copyAlignment);
+		memcpy(mapped + offset, data, size);
+
+		ImageCopy copy{};
+		copy.image = dst;
+		copy.finalLayout = finalLayout;
+		copy.region.bufferOffset = offset;
+		copy.region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copy.region.imageSubresource.layerCount = 1;
+		copy.region.imageExtent = extent;
+		current.imageCopies.push_back(copy);
+		current.bytes += size;
+		return nextBatchId;
+	}
+
+	//ѵǰεĸ¼ƲύУûдʱʲôҲ
+	void flush()
+	{
+		reclaim();
+		if (current.empty())
+			return;
+
+		Batch& batch = current;
+		acquireSubmitObjects(batch);
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		dispatch->vkBeginCommandBuffer(batch.commandBuffer, &beginInfo);
+
+		recordCopies(batch);
+
+		if (dispatch->vkEndCommandBuffer(batch.commandBuffer) != VK_SUCCESS)
+			throw std::runtime_error("failed to record staging command buffer!");
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &batch.commandBuffer;
+		if (dispatch->vkQueueSubmit(queue, 1, &submitInfo, batch.fence) != VK_SUCCESS)
+			throw std::runtime_error("failed to submit staging copies!");
+
+		stats.batches++;
+		stats.bytes += batch.bytes;
+		batch.id = nextBatchId++;
+		inFlight.push_back(std::move(batch));
+		current = Batch{};
+	}
+
+	//Ѿɵ
+	void reclaim()
+	{
+		while (!inFlight.empty() && dispatch->vkGetFenceStatus(device, inFlight.front().fence) == VK_SUCCESS)
+			retire();
+	}
+
+	bool isComplete(uint64_t batchId) const
+	{
+		return batchId < nextBatchId && (inFlight.empty() || inFlight.front().id > batchId);
+	}
+
+	//ȵĳɣûύλύ
+	void wait(uint64_t batchId)
+	{
+		if (batchId >= nextBatchId)
+			flush();
+		while (!isComplete(batchId))
+		{
+			dispatch->vkWaitForFences(device, 1, &inFlight.front().fence, VK_TRUE, UINT64_MAX);
+			retire();
+		}
+	}
+
+	void waitIdle()
+	{
+		flush();
+		while (!inFlight.empty())
+		{
+			dispatch->vkWaitForFences(device, 1, &inFlight.front().fence, VK_TRUE, UINT64_MAX);
+			retire();
+		}
+	}
+
+	//ͼζе¼ȨȡϣӦεͷ
+	void recordAcquireBarriers(VkCommandBuffer commandBuffer)
+	{
+		if (pendingBufferAcquires.empty() && pendingImageAcquires.empty())
+			return;
+
+		dispatch->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+			0, nullptr,
+			static_cast<uint32_t>(pendingBufferAcquires.size()), pendingBufferAcquires.data(),
+			static_cast<uint32_t>(pendingImageAcquires.size()), pendingImageAcquires.data());
+		pendingBufferAcquires.clear();
+		pendingImageAcquires.clear();
+	}
+
+	//ĿԴͼζлȡ֮ǰͱʱû¼ƵĻȡ
+	void discardAcquireBarriers()
+	{
+		pendingBufferAcquires.clear();
+		pendingImageAcquires.clear();
+	}
+
+	void destroy()
+	{
+		if (device == VK_NULL_HANDLE)
+			return;
+
+		waitIdle();
+		for (auto fence : freeFences)
+			dispatch->vkDestroyFence(device, fence, nullptr);
+		freeFences.clear();
+		freeCommandBuffers.clear();
+		dispatch->vkDestroyCommandPool(device, commandPool, nullptr);
+		dispatch->vkDestroyBuffer(device, buffer, nullptr);
+		allocator->free(allocation);
+		device = VK_NULL_HANDLE;
+	}
+
+	void printStats() const
+	{
+		printf("staging ring: %.1f MB ring, %.1f MB uploaded in %llu batches (%llu copy regions), peak use %.1f MB, %llu stalls (%.3f ms)\n",
+			capacity / (1024.0 * 1024.0), stats.bytes / (1024.0 * 1024.0),
+			static_cast<unsigned long long>(stats.batches), static_cast<unsigned long long>(stats.regions),
+			stats.peakUsed / (1024.0 * 1024.0), static_cast<unsigned long long>(stats.stalls), stats.stallMs);
+	}
+
+	VkDeviceSize size() const { return capacity; }
+	uint64_t stallCount() const { return stats.stalls; }
+
+private:
+	struct ImageCopy
+	{
+		VkImage image;
+		VkImageLayout finalLayout;
+		VkBufferImageCopy region;
+	};
+
+	//һύ¼ռõĻռ䣬ɺһ
+	struct Batch
+	{
+		uint64_t id = 0;
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		VkFence fence = VK_NULL_HANDLE;
+		VkDeviceSize consumed = 0;		//ƻ˷ѵֽ
+		VkDeviceSize bytes = 0;
+		std::map<VkBuffer, std::vector<VkBufferCopy>> bufferCopies;
+		std::vector<ImageCopy> imageCopies;
+		std::vector<VkBufferMemoryBarrier> bufferAcquires;
+		std::vector<VkImageMemoryBarrier> imageAcquires;
+
+		bool empty() const { return bufferCopies.empty() && imageCopies.empty(); }
+	};
+
+	struct Stats
+	{
+		uint64_t batches = 0;
+		uint64_t regions = 0;
+		uint64_t bytes = 0;
+		uint64_t stalls = 0;
+		double stallMs = 0.0;
+		VkDeviceSize peakUsed = 0;
+	};
+
+	//ڻԤһοռ䣬ռ䲻ʱȻգ͵ΣΪһͣ٣
+	VkDeviceSize reserve(VkDeviceSize size, VkDeviceSize alignment)
+	{
+		VkDeviceSize offset = 0;
+		VkDeviceSize needed = 0;
+		bool reclaimed = false;
+		bool stalled = false;
+		auto stallStart = std::chrono::steady_clock::now();
+		for (;;)
+		{
+			//Ų¾βʣĿռ䣬ͷʼ
+			offset = alignUp(head, alignment);
+			if (offset + size > capacity)
+				offset = 0;
+			needed = (offset >= head ? offset - head : capacity - head) + size;
+			if (used + needed <= capacity)
+				break;
+
+			if (!reclaimed)
+			{
+				reclaim();
+				reclaimed = true;
+				continue;
+			}
+			if (!stalled)
+			{
+				stalled = true;
+				stallStart = std::chrono::steady_clock::now();
+			}
+			if (inFlight.empty())
+				flush();
+			dispatch->vkWaitForFences(device, 1, &inFlight.front().fence, VK_TRUE, UINT64_MAX);
+			retire();
+		}
+		if (stalled)
+		{
+			stats.stalls++;
+			stats.stallMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stallStart).count();
+		}
+
+		head = offset + size;
+		if (head == capacity)
+			head = 0;
+		used += needed;
+		current.consumed += needed;
+		stats.peakUsed = std::max(stats.peakUsed, used);
+		return offset;
+	}
+
+	void acquireSubmitObjects(Batch& batch)
+	{
+		if (freeCommandBuffers.empty())
+		{
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = commandPool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+			VkCommandBuffer commandBuffer;
+			if (dispatch->vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+				throw std::runtime_error("failed to allocate staging command buffer!");
+			freeCommandBuffers.push_back(commandBuffer);
+		}
+		if (freeFences.empty())
+		{
+			VkFenceCreateInfo fenceInfo{};
+			fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+			VkFence fence;
+			if (dispatch->vkCreateFence(device, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+				throw std::runtime_error("failed to create staging fence!");
+			freeFences.push_back(fence);
+		}
+
+		batch.commandBuffer = freeCommandBuffers.back();
+		freeCommandBuffers.pop_back();
+		batch.fence = freeFences.back();
+		freeFences.pop_back();
+		dispatch->vkResetCommandBuffer(batch.commandBuffer, 0);
+	}
+
+	//ͼתTRANSFER_DSTиưĿϲɾٵһͷ/ת
+	void recordCopies(Batch& batch)
+	{
+		bool transferOwnership = queueFamily != dstQueueFamily;
+		uint32_t srcFamily = transferOwnership ? queueFamily : VK_QUEUE_FAMILY_IGNORED;
+		uint32_t dstFamily = transferOwnership ? dstQueueFamily : VK_QUEUE_FAMILY_IGNORED;
+
+		std::vector<VkImageMemoryBarrier> toTransfer;
+		for (auto& copy : batch.imageCopies)
+		{
+			VkImageMemoryBarrier barrier = imageBarrier(copy.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			toTransfer.push_back(barrier);
+		}
+		if (!toTransfer.empty())
+			dispatch->vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+				0, nullptr, 0, nullptr, static_cast<uint32_t>(toTransfer.size()), toTransfer.data());
+
+		for (auto& copy : batch.imageCopies)
+		{
+			dispatch->vkCmdCopyBufferToImage(batch.commandBuffer, buffer, copy.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.region);
+			stats.regions++;
+		}
+		for (auto& [dst, regions] : batch.bufferCopies)
+		{
+			dispatch->vkCmdCopyBuffer(batch.commandBuffer, buffer, dst, static_cast<uint32_t>(regions.size()), regions.data());
+			stats.regions += regions.size();
+		}
+
+		//ͷϣͬʱͨĿɼϣȡͼζ¼
+		std::vector<VkBufferMemoryBarrier> bufferReleases;
+		std::vector<VkImageMemoryBarrier> imageReleases;
+		for (auto& entry : batch.bufferCopies)
+		{
+			VkBufferMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = transferOwnership ? 0 : VK_ACCESS_MEMORY_READ_BIT;
+			barrier.srcQueueFamilyIndex = srcFamily;
+			barrier.dstQueueFamilyIndex = dstFamily;
+			barrier.buffer = entry.first;
+			barrier.offset = 0;
+			barrier.size = VK_WHOLE_SIZE;
+			bufferReleases.push_back(barrier);
+
+			if (transferOwnership)
+			{
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+				batch.bufferAcquires.push_back(barrier);
+			}
+		}
+		for (auto& copy : batch.imageCopies)
+		{
+			VkImageMemoryBarrier barrier = imageBarrier(copy.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, copy.finalLayout);
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = transferOwnership ? 0 : VK_ACCESS_MEMORY_READ_BIT;
+			barrier.srcQueueFamilyIndex = srcFamily;
+			barrier.dstQueueFamilyIndex = dstFamily;
+			imageReleases.push_back(barrier);
+
+			if (transferOwnership)
+			{
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+				batch.imageAcquires.push_back(barrier);
+			}
+		}
+		dispatch->vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			transferOwnership ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+			0, nullptr,
+			static_cast<uint32_t>(bufferReleases.size()), bufferReleases.data(),
+			static_cast<uint32_t>(imageReleases.size()), imageReleases.data());
+	}
+
+	static VkImageMemoryBarrier imageBarrier(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout)
+	{
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		return barrier;
+	}
+
+	//ɣ黹ռ䡢դ壬ȡϽͼζ
+	void retire()
+	{
+		Batch& batch = inFlight.front();
+		used -= batch.consumed;
+		dispatch->vkResetFences(device, 1, &batch.fence);
+		freeFences.push_back(batch.fence);
+		freeCommandBuffers.push_back(batch.commandBuffer);
+		pendingBufferAcquires.insert(pendingBufferAcquires.end(), batch.bufferAcquires.begin(), batch.bufferAcquires.end());
+		pendingImageAcquires.insert(pendingImageAcquires.end(), batch.imageAcquires.begin(), batch.imageAcquires.end());
+		inFlight.pop_front();
+		if (inFlight.empty() && current.empty())
+			head = used = 0;
+	}
+
+	//嵽ͼĸƫҪشСı16ֽڶгøʽ
+	static constexpr VkDeviceSize copyAlignment = 16;
+
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;
+	MemoryAllocator* allocator = nullptr;
+	VkQueue queue = VK_NULL_HANDLE;
+	uint32_t queueFamily = 0;
+	uint32_t dstQueueFamily = 0;
+	VkCommandPool commandPool = VK_NULL_HANDLE;
+
+	VkBuffer buffer = VK_NULL_HANDLE;
+	Allocation allocation;
+	char* mapped = nullptr;
+	VkDeviceSize capacity = 0;
+	VkDeviceSize head = 0;		//һдλ
+	VkDeviceSize used = 0;		//ûGPUֽ
+
+	Batch current;
+	uint64_t nextBatchId = 0;
+	std::deque<Batch> inFlight;
+	std::vector<VkFence> freeFences;
+	std::vector<VkCommandBuffer> freeCommandBuffers;
+	std::vector<VkBufferMemoryBarrier> pendingBufferAcquires;
+	std::vector<VkImageMemoryBarrier> pendingImageAcquires;
+	Stats stats;
+};
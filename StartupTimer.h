@@ -0,0 +1,122 @@
+#pragma once
+
+#include<vector>
+#include<string>
+#include<map>
+#include<chrono>
+#include<fstream>
+#include<algorithm>
+#include<cstdio>
+
+//˳׶εĺʱõʱ
+class StartupTimer
+{
+public:
+	struct Phase
+	{
+		const char* name;
+		double ms;
+	};
+
+	template<typename Function>
+	void time(const char* name, Function&& function)
+	{
+		auto start = std::chrono::steady_clock::now();
+		function();
+		phases.push_back({ name, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() });
+	}
+
+	const std::vector<Phase>& getPhases() const { return phases; }
+
+	double total() const
+	{
+		double sum = 0.0;
+		for (const auto& phase : phases)
+			sum += phase.ms;
+		return sum;
+	}
+
+	//һJSONűռextraǶֶΣѾʽõ"key":value
+	std::string toJson(const std::string& extra = "") const
+	{
+		std::string json = "{\"phases_ms\":{";
+		char number[64];
+		for (size_t i = 0; i < phases.size(); i++)
+		{
+			snprintf(number, sizeof(number), "%.3f", phases[i].ms);
+			json += (i ? ",\"" : "\"") + std::string(phases[i].name) + "\":" + number;
+		}
+		snprintf(number, sizeof(number), "%.3f", total());
+		json += std::string("},\"total_ms\":") + number;
+		if (!extra.empty())
+			json += "," + extra;
+		return json + "}";
+	}
+
+private:
+	std::vector<Phase> phases;
+};
+
+///˳ѭͳƣÿ׶εСp50p90p99
+class StartupBenchmark
+{
+public:
+	void add(const StartupTimer& timer)
+	{
+		for (const auto& phase : timer.getPhases())
+		{
+			if (samples.find(phase.name) == samples.end())
+				order.push_back(phase.name);
+			samples[phase.name].push_back(phase.ms);
+		}
+		totals.push_back(timer.total());
+	}
+
+	void print() const
+	{
+		printf("startup bench: %zu runs (first run %.3f ms includes loader/driver cold start)\n",
+			totals.size(), totals.empty() ? 0.0 : totals.front());
+		for (const auto& name : order)
+			printRow(name, samples.at(name));
+		printRow("total", totals);
+	}
+
+	bool writeJson(const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		file << "{\"runs\":" << totals.size() << ",\"phases\":{";
+		for (size_t i = 0; i < order.size(); i++)
+			file << (i ? "," : "") << "\"" << order[i] << "\":" << percentilesJson(samples.at(order[i]));
+		file << "},\"total\":" << percentilesJson(totals) << "}\n";
+		return static_cast<bool>(file);
+	}
+
+private:
+	static double percentile(const std::vector<double>& sorted, double p)
+	{
+		return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+	}
+
+	static void printRow(const std::string& name, std::vector<double> values)
+	{
+		std::sort(values.begin(), values.end());
+		printf("  %-22s min %8.3f  p50 %8.3f  p90 %8.3f  p99 %8.3f  max %8.3f ms\n", name.c_str(),
+			values.front(), percentile(values, 0.5), percentile(values, 0.9), percentile(values, 0.99), values.back());
+	}
+
+	static std::string percentilesJson(std::vector<double> values)
+	{
+		std::sort(values.begin(), values.end());
+		char json[256];
+		snprintf(json, sizeof(json), "{\"min\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"max\":%.3f}",
+			values.front(), percentile(values, 0.5), percentile(values, 0.9), percentile(values, 0.99), values.back());
+		return json;
+	}
+
+	std::vector<std::string> order;		//׶ΰһγֵ˳
+	std::map<std::string, std::vector<double>> samples;
+	std::vector<double> totals;
+};
@@ -0,0 +1,704 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDispatch.h"
+
+#include<vector>
+#include<deque>
+#include<string>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<functional>
+#include<exception>
+#include<stdexcept>
+#include<algorithm>
+#include<chrono>
+#include<fstream>
+#include<cstdio>
+#include<cstdint>
+
+enum class QueueType
+{
+	Graphics,
+	Compute,
+	Transfer,
+};
+
+//CPUͼ//ϵύһͼÿڵĽڵʱֵ
+//vkQueueWaitIdle/vkDeviceWaitIdleÿУͬĶͺϳһCPU̳߳ظһʱź
+//ڵ㰴˳ֵֵԼ˳˳flushʱÿֻһvkQueueSubmit
+//һȴͬĽڵϳһVkSubmitInfo
+//򿪸ʱÿGPUڵǰдһʱwaitIdleͳƸæʱصʱ䣬ԵChrome trace
+//addXTaskflushwaitӵЩе߳ϵ
+class TimelineScheduler
+{
+public:
+	using TaskId = uint32_t;
+
+	struct QueueInfo
+	{
+		VkQueue queue;
+		uint32_t family;
+	};
+
+	//ۼͳƣæµصʱֻڴ򿪸ʱ
+	struct Stats
+	{
+		uint64_t flushes = 0;
+		uint64_t cpuTasks = 0;
+		uint64_t gpuTasks = 0;
+		uint64_t queueSubmits = 0;		//vkQueueSubmit
+		uint64_t submitInfos = 0;		//ϲVkSubmitInfo
+		double spanMs = 0.0;			//ÿٴһڵ㿪ʼһڵ
+		double overlapMs = 0.0;			//ͬʱæ
+		double gpuOverlapMs = 0.0;		//ͬʱæ
+		double busyMs = 0.0;			//æµʱ֮ͣspanMsƽ
+	};
+
+	//waitSemaphores/signalSemaphore1.2ĺĺKHRչİ汾cpuThreadsCPU߳
+	void init(VkPhysicalDevice physicalDevice, VkDevice device, const VulkanDispatch& dispatch, PFN_vkWaitSemaphores waitSemaphores, PFN_vkSignalSemaphore signalSemaphore,
+		const QueueInfo& graphics, const QueueInfo& compute, const QueueInfo& transfer, uint32_t cpuThreads, bool trace)
+	{
+		this->device = device;
+		this->dispatch = &dispatch;
+		this->waitSemaphores = waitSemaphores;
+		this->signalSemaphore = signalSemaphore;
+		tracing = trace;
+		stats = Stats{};
+		epoch = std::chrono::steady_clock::now();
+
+		VkPhysicalDeviceProperties properties;
+		dispatch.vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		timestampPeriod = properties.limits.timestampPeriod;
+		uint32_t queueFamilyCount = 0;
+		dispatch.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		dispatch.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+		//ʹûжʱͼͬһϳһߣύ˳֤߱
+		const QueueInfo infos[] = { graphics, compute, transfer };
+		const char* names[] = { "graphics", "compute", "transfer" };
+		for (uint32_t type = 0; type < 3; type++)
+		{
+			uint32_t lane = 0;
+			while (lane < lanes.size() && lanes[lane].queue != infos[type].queue)
+				lane++;
+			if (lane == lanes.size())
+			{
+				Lane newLane;
+				newLane.queue = infos[type].queue;
+				newLane.family = infos[type].family;
+				newLane.timeline = createTimeline();
+				uint32_t validBits = queueFamilies[newLane.family].timestampValidBits;
+				newLane.timestamps = trace && validBits > 0 && timestampPeriod > 0.0f;
+				newLane.timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+				lanes.push_back(newLane);
+			}
+			else
+				lanes[lane].name += "+";
+			lanes[lane].name += names[type];
+			laneOfType[type] = lane;
+		}
+		cpuTimeline = createTimeline();
+
+		for (auto& lane : lanes)
+		{
+			if (!lane.timestamps)
+			{
+				if (trace)
+					printf("scheduler: %s queue family %u has no timestamps, its tasks are missing from the trace\n", lane.name.c_str(), lane.family);
+				continue;
+			}
+			VkCommandPoolCreateInfo poolInfo{};
+			poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+			poolInfo.queueFamilyIndex = lane.family;
+			if (dispatch.vkCreateCommandPool(device, &poolInfo, nullptr, &lane.commandPool) != VK_SUCCESS)
+				throw std::runtime_error("failed to create scheduler command pool!");
+
+			VkQueryPoolCreateInfo queryInfo{};
+			queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+			queryInfo.queryCount = maxQueries;
+			if (dispatch.vkCreateQueryPool(device, &queryInfo, nullptr, &lane.queryPool) != VK_SUCCESS)
+				throw std::runtime_error("failed to create scheduler query pool!");
+		}
+
+		stopping = false;
+		for (uint32_t i = 0; i < std::max(cpuThreads, 1u); i++)
+			workers.emplace_back(&TimelineScheduler::workerLoop, this, i);
+	}
+
+	//dependenciesȼ루Բл
+	TaskId addCpuTask(const char* name, std::function<void()> function, const std::vector<TaskId>& dependencies = {})
+	{
+		Task& task = addTask(name, dependencies);
+		task.cpu = true;
+		task.function = std::move(function);
+		return static_cast<TaskId>(tasks.size() - 1);
+	}
+
+	//ɵ¼ƣwaitStageǵĽ׶ΣĬ߶
+	TaskId addGpuTask(const char* name, QueueType queue, VkCommandBuffer commandBuffer, const std::vector<TaskId>& dependencies = {},
+		VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT)
+	{
+		Task& task = addTask(name, dependencies);
+		task.lane = laneOfType[static_cast<uint32_t>(queue)];
+		task.commandBuffer = commandBuffer;
+		task.waitStage = waitStage;
+		return static_cast<TaskId>(tasks.size() - 1);
+	}
+
+	//¼ʱֵÿһvkQueueSubmitCPU񽻸̳߳أȴ
+	void flush()
+	{
+		if (flushed == tasks.size())
+			return;
+		if (windowStartNs == 0)
+			windowStartNs = nowNs();
+
+		std::vector<std::vector<Batch>> batches(lanes.size());
+		std::vector<Task*> cpuReady;
+		for (size_t i = flushed; i < tasks.size(); i++)
+		{
+			//ʱֵͬһźֻ
+			Task& task = tasks[i];
+			std::vector<Wait> waits;
+			for (TaskId dependency : task.dependencies)
+			{
+				const Task& other = tasks[dependency];
+				VkSemaphore semaphore = other.cpu ? cpuTimeline : lanes[other.lane].timeline;
+				auto found = std::find_if(waits.begin(), waits.end(), [semaphore](const Wait& wait) { return wait.semaphore == semaphore; });
+				if (found == waits.end())
+					waits.push_back({ semaphore, other.value, task.waitStage });
+				else
+					found->value = std::max(found->value, other.value);
+			}
+
+			if (task.cpu)
+			{
+				task.value = ++cpuValue;
+				task.waits = std::move(waits);
+				cpuReady.push_back(&task);
+				stats.cpuTasks++;
+				continue;
+			}
+
+			//ȴһVkSubmitInfoȫͬʱȥȲ˭ȣҲ˵Ľڵ
+			//ĻҪԼʱߵֵһܵԼ
+			Lane& lane = lanes[task.lane];
+			std::vector<Batch>& laneBatches = batches[task.lane];
+			bool join = !laneBatches.empty() && laneBatches.back().waits.size() == waits.size();
+			if (join)
+			{
+				const std::vector<Wait>& batchWaits = laneBatches.back().waits;
+				for (const Wait& wait : waits)
+				{
+					join = join && std::any_of(batchWaits.begin(), batchWaits.end(), [&wait](const Wait& other) {
+						return other.semaphore == wait.semaphore && other.value == wait.value && other.stage == wait.stage;
+					});
+				}
+			}
+			if (!join)
+			{
+				Batch batch;
+				batch.waits = std::move(waits);
+				batch.signalValue = ++lane.value;
+				laneBatches.push_back(std::move(batch));
+			}
+			Batch& batch = laneBatches.back();
+			task.value = batch.signalValue;
+			appendCommandBuffers(lane, task, batch.commandBuffers);
+			stats.gpuTasks++;
+		}
+		flushed = tasks.size();
+
+		for (size_t l = 0; l < lanes.size(); l++)
+			submit(lanes[l], batches[l]);
+
+		{
+			std::lock_guard<std::mutex> lock(workMutex);
+			for (Task* task : cpuReady)
+				pending.push_back(task);
+		}
+		workCondition.notify_all();
+		stats.flushes++;
+	}
+
+	//ֻһ
+	void wait(TaskId id)
+	{
+		const Task& task = tasks[id];
+		waitValue(task.cpu ? cpuTimeline : lanes[task.lane].timeline, task.value);
+	}
+
+	//ύɣͳһֵصͼ֮ǰTaskIdϣ
+	void waitIdle()
+	{
+		flush();
+		for (const auto& lane : lanes)
+			waitValue(lane.timeline, lane.value);
+		waitValue(cpuTimeline, cpuValue);
+
+		//߳ƽCPUʱߵɣһ֤õдʱʹ
+		std::exception_ptr error;
+		{
+			std::lock_guard<std::mutex> lock(completionMutex);
+			std::swap(error, taskError);
+		}
+		if (tracing)
+			collectTrace();
+		for (auto& lane : lanes)
+		{
+			if (lane.commandPool != VK_NULL_HANDLE)
+				dispatch->vkResetCommandPool(device, lane.commandPool, 0);
+			lane.freeCommandBuffer = 0;
+			lane.queryCount = 0;
+		}
+		tasks.clear();
+		flushed = 0;
+		windowStartNs = 0;
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	const Stats& getStats() const { return stats; }
+
+	void printStats() const
+	{
+		printf("scheduler: %llu flushes, %llu cpu tasks, %llu gpu tasks in %llu vkQueueSubmit calls (%llu submit infos)\n",
+			static_cast<unsigned long long>(stats.flushes), static_cast<unsigned long long>(stats.cpuTasks), static_cast<unsigned long long>(stats.gpuTasks),
+			static_cast<unsigned long long>(stats.queueSubmits), static_cast<unsigned long long>(stats.submitInfos));
+		if (!tracing || stats.spanMs <= 0.0)
+			return;
+		printf("scheduler: span %.2f ms", stats.spanMs);
+		for (size_t l = 0; l <= lanes.size(); l++)
+			printf(", %s busy %.2f ms", l < lanes.size() ? lanes[l].name.c_str() : "cpu", l < lanes.size() ? lanes[l].busyMs : cpuBusyMs);
+		printf("\nscheduler: >=2 lanes busy %.2f ms (%.1f%%), >=2 queues busy %.2f ms (%.1f%%), average concurrency %.2f\n",
+			stats.overlapMs, stats.overlapMs / stats.spanMs * 100.0, stats.gpuOverlapMs, stats.gpuOverlapMs / stats.spanMs * 100.0,
+			stats.busyMs / stats.spanMs);
+	}
+
+	//ÿһеChrome traceGPUʱ䰴һύCPUʱ̶루֮ͬǾȷģCPU֮ǽƵģ
+	bool writeTrace(const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file.is_open())
+			return false;
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		for (size_t l = 0; l < lanes.size(); l++)
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":" << l << ",\"args\":{\"name\":\"" << lanes[l].name << " queue\"}},\n";
+		for (size_t w = 0; w < workers.size(); w++)
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":" << lanes.size() + w << ",\"args\":{\"name\":\"cpu " << w << "\"}},\n";
+		char line[256];
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			const TraceEvent& event = events[i];
+			snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":2,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n", event.name, event.track,
+				event.startNs / 1000.0, (event.endNs - event.startNs) / 1000.0, i + 1 < events.size() ? "," : "");
+			file << line;
+		}
+		file << "]}\n";
+		return static_cast<bool>(file);
+	}
+
+	void destroy()
+	{
+		{
+			std::lock_guard<std::mutex> lock(workMutex);
+			stopping = true;
+		}
+		workCondition.notify_all();
+		for (auto& worker : workers)
+			worker.join();
+		workers.clear();
+
+		for (auto& lane : lanes)
+		{
+			if (lane.commandPool != VK_NULL_HANDLE)
+				dispatch->vkDestroyCommandPool(device, lane.commandPool, nullptr);
+			if (lane.queryPool != VK_NULL_HANDLE)
+				dispatch->vkDestroyQueryPool(device, lane.queryPool, nullptr);
+			dispatch->vkDestroySemaphore(device, lane.timeline, nullptr);
+		}
+		lanes.clear();
+		if (cpuTimeline != VK_NULL_HANDLE)
+			dispatch->vkDestroySemaphore(device, cpuTimeline, nullptr);
+		cpuTimeline = VK_NULL_HANDLE;
+		tasks.clear();
+		events.clear();
+		flushed = 0;
+		cpuValue = 0;
+		cpuSignaled = 0;
+		cpuDone.clear();
+	}
+
+private:
+	struct Wait
+	{
+		VkSemaphore semaphore;
+		uint64_t value;
+		VkPipelineStageFlags stage;
+	};
+
+	struct Task
+	{
+		const char* name;
+		std::vector<TaskId> dependencies;
+		bool cpu = false;
+		std::function<void()> function;
+		uint32_t lane = 0;
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		VkPipelineStageFlags waitStage = 0;
+		uint64_t value = 0;				//ʱʱߴﵽֵ
+		std::vector<Wait> waits;		//CPUϵȵֵflushʱã̲߳tasks
+		uint32_t query = ~0u;			//ʼͽʱĲѯţûиʱΪ~0u
+		uint32_t worker = 0;
+		uint64_t startNs = 0;
+		uint64_t endNs = 0;
+	};
+
+	//һVkSubmitInfowaitsִcommandBuffersڶеʱƵsignalValue
+	struct Batch
+	{
+		std::vector<Wait> waits;
+		std::vector<VkCommandBuffer> commandBuffers;
+		uint64_t signalValue = 0;
+	};
+
+	struct Lane
+	{
+		std::string name;
+		VkQueue queue = VK_NULL_HANDLE;
+		uint32_t family = 0;
+		VkSemaphore timeline = VK_NULL_HANDLE;
+		uint64_t value = 0;				//ȥֵ
+		bool timestamps = false;
+		uint64_t timestampMask = ~0ull;
+		VkCommandPool commandPool = VK_NULL_HANDLE;		//дʱС
+		std::vector<VkCommandBuffer> commandBuffers;
+		uint32_t freeCommandBuffer = 0;
+		VkQueryPool queryPool = VK_NULL_HANDLE;
+		uint32_t queryCount = 0;
+		double busyMs = 0.0;
+	};
+
+	struct TraceEvent
+	{
+		const char* name;
+		uint32_t track;
+		uint64_t startNs;
+		uint64_t endNs;
+	};
+
+	Task& addTask(const char* name, const std::vector<TaskId>& dependencies)
+	{
+		for (TaskId dependency : dependencies)
+		{
+			if (dependency >= tasks.size())
+				throw std::runtime_error(std::string("scheduler task ") + name + " depends on a task added after it!");
+		}
+		tasks.emplace_back();
+		Task& task = tasks.back();
+		task.name = name;
+		task.dependencies = dependencies;
+		return task;
+	}
+
+	VkSemaphore createTimeline()
+	{
+		VkSemaphoreTypeCreateInfo typeInfo{};
+		typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeInfo.initialValue = 0;
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &typeInfo;
+		VkSemaphore semaphore;
+		if (dispatch->vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS)
+			throw std::runtime_error("failed to create timeline semaphore!");
+		return semaphore;
+	}
+
+	void waitValue(VkSemaphore semaphore, uint64_t value) const
+	{
+		if (value == 0)
+			return;
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &semaphore;
+		waitInfo.pValues = &value;
+		if (waitSemaphores(device, &waitInfo, UINT64_MAX) != VK_SUCCESS)
+			throw std::runtime_error("failed to wait for timeline semaphore!");
+	}
+
+	uint64_t nowNs() const
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+	}
+
+	//ʱڽڵǰһдʱ壬ʱBOTTOM_OF_PIPEҪǰִ
+	void appendCommandBuffers(Lane& lane, Task& task, std::vector<VkCommandBuffer>& commandBuffers)
+	{
+		if (!lane.timestamps || lane.queryCount + 2 > maxQueries)
+		{
+			commandBuffers.push_back(task.commandBuffer);
+			return;
+		}
+		task.query = lane.queryCount;
+		lane.queryCount += 2;
+		commandBuffers.push_back(recordTimestamp(lane, task.query, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, true));
+		commandBuffers.push_back(task.commandBuffer);
+		commandBuffers.push_back(recordTimestamp(lane, task.query + 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, false));
+	}
+
+	VkCommandBuffer recordTimestamp(Lane& lane, uint32_t query, VkPipelineStageFlagBits stage, bool reset)
+	{
+		if (lane.freeCommandBuffer == lane.commandBuffers.size())
+		{
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = lane.commandPool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+			VkCommandBuffer commandBuffer;
+			if (dispatch->vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+				throw std::runtime_error("failed to allocate scheduler command buffer!");
+			lane.commandBuffers.push_back(commandBuffer);
+		}
+		VkCommandBuffer commandBuffer = lane.commandBuffers[lane.freeCommandBuffer++];
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		dispatch->vkBeginCommandBuffer(commandBuffer, &beginInfo);
+		if (reset)
+			dispatch->vkCmdResetQueryPool(commandBuffer, lane.queryPool, query, 2);
+		dispatch->vkCmdWriteTimestamp(commandBuffer, stage, lane.queryPool, query);
+		if (dispatch->vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+			throw std::runtime_error("failed to record scheduler command buffer!");
+		return commandBuffer;
+	}
+
+	//һflushηŽһvkQueueSubmitȴźţʱź
+	//ԵCPUĶеĽڵ㲻Ƴύ
+	void submit(Lane& lane, const std::vector<Batch>& batches)
+	{
+		if (batches.empty())
+			return;
+
+		std::vector<VkSubmitInfo> submits(batches.size());
+		std::vector<VkTimelineSemaphoreSubmitInfo> timelineInfos(batches.size());
+		std::vector<std::vector<VkSemaphore>> waitSemaphoreLists(batches.size());
+		std::vector<std::vector<uint64_t>> waitValueLists(batches.size());
+		std::vector<std::vector<VkPipelineStageFlags>> waitStageLists(batches.size());
+		for (size_t i = 0; i < batches.size(); i++)
+		{
+			const Batch& batch = batches[i];
+			for (const Wait& wait : batch.waits)
+			{
+				waitSemaphoreLists[i].push_back(wait.semaphore);
+				waitValueLists[i].push_back(wait.value);
+				waitStageLists[i].push_back(wait.stage);
+			}
+
+			VkTimelineSemaphoreSubmitInfo& timelineInfo = timelineInfos[i];
+			timelineInfo = {};
+			timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+			timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValueLists[i].size());
+			timelineInfo.pWaitSemaphoreValues = waitValueLists[i].data();
+			timelineInfo.signalSemaphoreValueCount = 1;
+			timelineInfo.pSignalSemaphoreValues = &batch.signalValue;
+
+			VkSubmitInfo& submitInfo = submits[i];
+			submitInfo = {};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.pNext = &timelineInfo;
+			submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphoreLists[i].size());
+			submitInfo.pWaitSemaphores = waitSemaphoreLists[i].data();
+			submitInfo.pWaitDstStageMask = waitStageLists[i].data();
+			submitInfo.commandBufferCount = static_cast<uint32_t>(batch.commandBuffers.size());
+			submitInfo.pCommandBuffers = batch.commandBuffers.data();
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &lane.timeline;
+		}
+		if (dispatch->vkQueueSubmit(lane.queue, static_cast<uint32_t>(submits.size()), submits.data(), VK_NULL_HANDLE) != VK_SUCCESS)
+			throw std::runtime_error("failed to submit to " + lane.name + " queue!");
+		stats.queueSubmits++;
+		stats.submitInfos += submits.size();
+	}
+
+	//CPUֵ˳ȡϵʱִֵУ
+	//CPUʱֻܵƽƵɵֵʱҪǰģ
+	void workerLoop(uint32_t worker)
+	{
+		for (;;)
+		{
+			Task* task = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(workMutex);
+				workCondition.wait(lock, [this] { return stopping || !pending.empty(); });
+				if (pending.empty())
+					return;
+				task = pending.front();
+				pending.pop_front();
+			}
+
+			task->worker = worker;
+			try
+			{
+				for (const Wait& wait : task->waits)
+					waitValue(wait.semaphore, wait.value);
+				task->startNs = nowNs();
+				task->function();
+			}
+			catch (...)
+			{
+				//ƽʱߣĶк̻߳Զȥ
+				std::lock_guard<std::mutex> lock(completionMutex);
+				if (!taskError)
+					taskError = std::current_exception();
+			}
+			task->endNs = nowNs();
+			task->startNs = std::min(task->startNs != 0 ? task->startNs : task->endNs, task->endNs);
+			complete(task->value);
+		}
+	}
+
+	void complete(uint64_t value)
+	{
+		std::lock_guard<std::mutex> lock(completionMutex);
+		if (cpuDone.size() < value - cpuSignaled)
+			cpuDone.resize(value - cpuSignaled, false);
+		cpuDone[value - cpuSignaled - 1] = true;
+		uint64_t done = 0;
+		while (done < cpuDone.size() && cpuDone[done])
+			done++;
+		if (done == 0)
+			return;
+		cpuDone.erase(cpuDone.begin(), cpuDone.begin() + done);
+		cpuSignaled += done;
+
+		VkSemaphoreSignalInfo signalInfo{};
+		signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+		signalInfo.semaphore = cpuTimeline;
+		signalInfo.value = cpuSignaled;
+		signalSemaphore(device, &signalInfo);
+	}
+
+	//ʱ㵽CPUʱ䣬ɨ䣺ÿߵæµʱ䡢ͬʱæʱ
+	void collectTrace()
+	{
+		std::vector<TraceEvent> window;
+		uint64_t gpuBase = ~0ull;
+		std::vector<std::vector<uint64_t>> timestamps(lanes.size());
+		for (size_t l = 0; l < lanes.size(); l++)
+		{
+			Lane& lane = lanes[l];
+			if (lane.queryCount == 0)
+				continue;
+			timestamps[l].resize(lane.queryCount);
+			if (dispatch->vkGetQueryPoolResults(device, lane.queryPool, 0, lane.queryCount, timestamps[l].size() * sizeof(uint64_t),
+				timestamps[l].data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+			{
+				timestamps[l].clear();
+				continue;
+			}
+			for (uint64_t& timestamp : timestamps[l])
+			{
+				timestamp &= lane.timestampMask;
+				gpuBase = std::min(gpuBase, timestamp);
+			}
+		}
+		for (const Task& task : tasks)
+		{
+			if (task.cpu)
+			{
+				window.push_back({ task.name, static_cast<uint32_t>(lanes.size() + task.worker), task.startNs, task.endNs });
+				continue;
+			}
+			if (task.query == ~0u || timestamps[task.lane].empty())
+				continue;
+			uint64_t start = windowStartNs + static_cast<uint64_t>((timestamps[task.lane][task.query] - gpuBase) * static_cast<double>(timestampPeriod));
+			uint64_t end = windowStartNs + static_cast<uint64_t>((timestamps[task.lane][task.query + 1] - gpuBase) * static_cast<double>(timestampPeriod));
+			window.push_back({ task.name, task.lane, start, std::max(start, end) });
+		}
+		if (window.empty())
+			return;
+
+		//CPU̺߳ϳһߣÿʱһмæ
+		uint32_t cpuLane = static_cast<uint32_t>(lanes.size());
+		std::vector<std::pair<uint64_t, int32_t>> edges;
+		for (const TraceEvent& event : window)
+		{
+			uint32_t lane = std::min(event.track, cpuLane);
+			edges.push_back({ event.startNs, static_cast<int32_t>(lane + 1) });
+			edges.push_back({ event.endNs, -static_cast<int32_t>(lane + 1) });
+		}
+		std::sort(edges.begin(), edges.end());
+		std::vector<uint32_t> active(cpuLane + 1, 0);
+		uint64_t previous = edges.front().first;
+		for (const auto& [time, edge] : edges)
+		{
+			double ms = (time - previous) / 1e6;
+			uint32_t busyLanes = 0, busyQueues = 0;
+			for (uint32_t l = 0; l <= cpuLane; l++)
+			{
+				if (active[l] == 0)
+					continue;
+				busyLanes++;
+				busyQueues += l < cpuLane ? 1 : 0;
+				if (l < cpuLane)
+					lanes[l].busyMs += ms;
+				else
+					cpuBusyMs += ms;
+			}
+			stats.busyMs += busyLanes * ms;
+			stats.overlapMs += busyLanes >= 2 ? ms : 0.0;
+			stats.gpuOverlapMs += busyQueues >= 2 ? ms : 0.0;
+			if (edge > 0)
+				active[edge - 1]++;
+			else
+				active[-edge - 1]--;
+			previous = time;
+		}
+		stats.spanMs += (edges.back().first - edges.front().first) / 1e6;
+		events.insert(events.end(), window.begin(), window.end());
+	}
+
+	static constexpr uint32_t maxQueries = 1024;	//ÿÿٵGPUڵ
+
+	VkDevice device = VK_NULL_HANDLE;
+	const VulkanDispatch* dispatch = nullptr;
+	PFN_vkWaitSemaphores waitSemaphores = nullptr;
+	PFN_vkSignalSemaphore signalSemaphore = nullptr;
+	bool tracing = false;
+	float timestampPeriod = 0.0f;
+	std::chrono::steady_clock::time_point epoch;
+
+	std::vector<Lane> lanes;
+	uint32_t laneOfType[3] = {};
+	VkSemaphore cpuTimeline = VK_NULL_HANDLE;
+	uint64_t cpuValue = 0;			//ȥCPUʱֵ
+	uint64_t cpuSignaled = 0;		//Ѿƽֵ
+	std::vector<bool> cpuDone;		//cpuSignaledֵ֮Ƿ
+
+	std::deque<Task> tasks;			//dequeԪʱƶԪأָ߳
+	size_t flushed = 0;
+	uint64_t windowStartNs = 0;		//һֵһflushʱ̣GPUʱ뵽
+
+	std::vector<std::thread> workers;
+	std::mutex workMutex;
+	std::condition_variable workCondition;
+	std::deque<Task*> pending;
+	bool stopping = false;
+	std::mutex completionMutex;
+	std::exception_ptr taskError;
+
+	Stats stats;
+	double cpuBusyMs = 0.0;
+	std::vector<TraceEvent> events;
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include<vector>
+#include<string>
+#include<cstdlib>
+#include<iterator>
+
+//֤λOff֤㣻Perfֻbest practicesܾ棬ļ鶼صС
+//stagingrelease汾ﳣFull֤Ĭȫ
+enum class ValidationProfile
+{
+	Off,
+	Perf,
+	Full,
+};
+
+inline const char* validationProfileName(ValidationProfile profile)
+{
+	switch (profile)
+	{
+	case ValidationProfile::Off: return "off";
+	case ValidationProfile::Perf: return "perf";
+	case ValidationProfile::Full: return "full";
+	}
+	return "unknown";
+}
+
+inline bool parseValidationProfile(const std::string& name, ValidationProfile& profile)
+{
+	if (name == "off")
+		profile = ValidationProfile::Off;
+	else if (name == "perf")
+		profile = ValidationProfile::Perf;
+	else if (name == "full")
+		profile = ValidationProfile::Full;
+	else
+		return false;
+	return true;
+}
+
+//VULKAN_01_VALIDATIONȣûʱdebug汾ĬFullrelease汾ĬOff
+inline ValidationProfile defaultValidationProfile()
+{
+	ValidationProfile profile;
+	const char* env = getenv("VULKAN_01_VALIDATION");
+	if (env != nullptr && parseValidationProfile(env, profile))
+		return profile;
+#ifdef NDEBUG
+	return ValidationProfile::Off;
+#else
+	return ValidationProfile::Full;
+#endif
+}
+
+//λvkCreateInstancepNext֤֧VK_EXT_layer_settingsʱòã
+//VK_EXT_validation_featuresһЩSDKֻ
+class ValidationSettings
+{
+public:
+	static constexpr const char* layerName = "VK_LAYER_KHRONOS_validation";
+
+	//layerExtensions֤Լṩʵչ
+	void select(ValidationProfile profile, const std::vector<VkExtensionProperties>& layerExtensions)
+	{
+		this->profile = profile;
+		useLayerSettings = false;
+		useValidationFeatures = false;
+		if (profile != ValidationProfile::Perf)
+			return;
+
+#ifdef VK_EXT_layer_settings
+		useLayerSettings = hasExtension(layerExtensions, VK_EXT_LAYER_SETTINGS_EXTENSION_NAME);
+#endif
+		if (!useLayerSettings)
+			useValidationFeatures = hasExtension(layerExtensions, VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME);
+	}
+
+	//PerfλҪչ֮һûصļ
+	bool supported() const
+	{
+		return profile != ValidationProfile::Perf || useLayerSettings || useValidationFeatures;
+	}
+
+	//Ҫõʵչ
+	void addExtensions(std::vector<const char*>& extensions) const
+	{
+#ifdef VK_EXT_layer_settings
+		if (useLayerSettings)
+			extensions.push_back(VK_EXT_LAYER_SETTINGS_EXTENSION_NAME);
+#endif
+		if (useValidationFeatures)
+			extensions.push_back(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME);
+	}
+
+	//Perfλֻbest practicesϢ
+	VkDebugUtilsMessageTypeFlagsEXT messageTypes() const
+	{
+		if (profile == ValidationProfile::Perf)
+			return VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+		return VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+	}
+
+	const char* mechanism() const
+	{
+#ifdef VK_EXT_layer_settings
+		if (useLayerSettings)
+			return VK_EXT_LAYER_SETTINGS_EXTENSION_NAME;
+#endif
+		if (useValidationFeatures)
+			return VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME;
+		return "layer defaults";
+	}
+
+	//ýṹnextǰ棬µͷṹvkCreateInstanceǰ
+	const void* chain(const void* next)
+	{
+#ifdef VK_EXT_layer_settings
+		if (useLayerSettings)
+		{
+			static const VkBool32 on = VK_TRUE;
+			static const VkBool32 off = VK_FALSE;
+			static const char* disabledSettings[] = { "validate_core", "validate_sync", "thread_safety",
+				"stateless_param", "object_lifetime", "unique_handles", "check_shaders" };
+
+			settings.clear();
+			settings.push_back({ layerName, "validate_best_practices", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &on });
+			for (const char* name : disabledSettings)
+				settings.push_back({ layerName, name, VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &off });
+
+			layerSettingsInfo = {};
+			layerSettingsInfo.sType = VK_STRUCTURE_TYPE_LAYER_SETTINGS_CREATE_INFO_EXT;
+			layerSettingsInfo.pNext = next;
+			layerSettingsInfo.settingCount = static_cast<uint32_t>(settings.size());
+			layerSettingsInfo.pSettings = settings.data();
+			return &layerSettingsInfo;
+		}
+#endif
+		if (useValidationFeatures)
+		{
+			static const VkValidationFeatureEnableEXT enables[] = { VK_VALIDATION_FEATURE_ENABLE_BEST_PRACTICES_EXT };
+			static const VkValidationFeatureDisableEXT disables[] = {
+				VK_VALIDATION_FEATURE_DISABLE_CORE_CHECKS_EXT,
+				VK_VALIDATION_FEATURE_DISABLE_THREAD_SAFETY_EXT,
+				VK_VALIDATION_FEATURE_DISABLE_API_PARAMETERS_EXT,
+				VK_VALIDATION_FEATURE_DISABLE_OBJECT_LIFETIMES_EXT,
+				VK_VALIDATION_FEATURE_DISABLE_UNIQUE_HANDLES_EXT,
+				VK_VALIDATION_FEATURE_DISABLE_SHADERS_EXT,
+			};
+
+			validationFeatures = {};
+			validationFeatures.sType = VK_STRUCTURE_TYPE_VALIDATION_FEATURES_EXT;
+			validationFeatures.pNext = next;
+			validationFeatures.enabledValidationFeatureCount = static_cast<uint32_t>(std::size(enables));
+			validationFeatures.pEnabledValidationFeatures = enables;
+			validationFeatures.disabledValidationFeatureCount = static_cast<uint32_t>(std::size(disables));
+			validationFeatures.pDisabledValidationFeatures = disables;
+			return &validationFeatures;
+		}
+		return next;
+	}
+
+private:
+	static bool hasExtension(const std::vector<VkExtensionProperties>& extensions, const char* name)
+	{
+		for (const auto& extension : extensions)
+		{
+			if (std::string(extension.extensionName) == name)
+				return true;
+		}
+		return false;
+	}
+
+	ValidationProfile profile = ValidationProfile::Off;
+	bool useLayerSettings = false;
+	bool useValidationFeatures = false;
+
+	VkValidationFeaturesEXT validationFeatures{};
+#ifdef VK_EXT_layer_settings
+	std::vector<VkLayerSettingEXT> settings;
+	VkLayerSettingsCreateInfoEXT layerSettingsInfo{};
+#endif
+};
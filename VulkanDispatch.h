@@ -0,0 +1,162 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include<stdexcept>
+#include<string>
+
+//ֱӵvk*Ҫ壨һηַתչÿλҪԼvkGetInstanceProcAddr
+//ڴʵ߼豸ȡһκָ룬豸vkGetDeviceProcAddrȡֱӽ֤㣩
+//ʱѺӽӦб
+
+//ʵ
+#define VULKAN_INSTANCE_FUNCTIONS(X) \
+	X(vkDestroyInstance) \
+	X(vkEnumeratePhysicalDevices) \
+	X(vkGetPhysicalDeviceProperties) \
+	X(vkGetPhysicalDeviceMemoryProperties) \
+	X(vkGetPhysicalDeviceFormatProperties) \
+	X(vkGetPhysicalDeviceQueueFamilyProperties) \
+	X(vkEnumerateDeviceExtensionProperties) \
+	X(vkCreateDevice) \
+	X(vkGetDeviceProcAddr)
+
+//ʵչ߰汾ṩĺûʱΪ
+#define VULKAN_INSTANCE_OPTIONAL_FUNCTIONS(X) \
+	X(vkGetPhysicalDeviceProperties2) \
+	X(vkDestroySurfaceKHR) \
+	X(vkGetPhysicalDeviceSurfaceSupportKHR) \
+	X(vkGetPhysicalDeviceSurfaceCapabilitiesKHR) \
+	X(vkGetPhysicalDeviceSurfaceFormatsKHR) \
+	X(vkGetPhysicalDeviceSurfacePresentModesKHR) \
+	X(vkCreateHeadlessSurfaceEXT) \
+	X(vkCreateDebugUtilsMessengerEXT) \
+	X(vkDestroyDebugUtilsMessengerEXT)
+
+//豸
+#define VULKAN_DEVICE_FUNCTIONS(X) \
+	X(vkDestroyDevice) \
+	X(vkGetDeviceQueue) \
+	X(vkDeviceWaitIdle) \
+	X(vkQueueSubmit) \
+	X(vkQueueWaitIdle) \
+	X(vkCreateSemaphore) \
+	X(vkDestroySemaphore) \
+	X(vkCreateFence) \
+	X(vkDestroyFence) \
+	X(vkWaitForFences) \
+	X(vkResetFences) \
+	X(vkGetFenceStatus) \
+	X(vkCreateQueryPool) \
+	X(vkDestroyQueryPool) \
+	X(vkGetQueryPoolResults) \
+	X(vkCreateCommandPool) \
+	X(vkDestroyCommandPool) \
+	X(vkResetCommandPool) \
+	X(vkAllocateCommandBuffers) \
+	X(vkBeginCommandBuffer) \
+	X(vkEndCommandBuffer) \
+	X(vkResetCommandBuffer) \
+	X(vkAllocateMemory) \
+	X(vkFreeMemory) \
+	X(vkMapMemory) \
+	X(vkCreateBuffer) \
+	X(vkGetBufferMemoryRequirements) \
+	X(vkBindBufferMemory) \
+	X(vkDestroyBuffer) \
+	X(vkCreateImage) \
+	X(vkDestroyImage) \
+	X(vkGetImageMemoryRequirements) \
+	X(vkBindImageMemory) \
+	X(vkCreateImageView) \
+	X(vkDestroyImageView) \
+	X(vkCreateRenderPass) \
+	X(vkDestroyRenderPass) \
+	X(vkCreateFramebuffer) \
+	X(vkDestroyFramebuffer) \
+	X(vkCreateDescriptorSetLayout) \
+	X(vkDestroyDescriptorSetLayout) \
+	X(vkCreateDescriptorPool) \
+	X(vkDestroyDescriptorPool) \
+	X(vkAllocateDescriptorSets) \
+	X(vkUpdateDescriptorSets) \
+	X(vkCreatePipelineLayout) \
+	X(vkDestroyPipelineLayout) \
+	X(vkCreateShaderModule) \
+	X(vkDestroyShaderModule) \
+	X(vkCreateGraphicsPipelines) \
+	X(vkCreateComputePipelines) \
+	X(vkDestroyPipeline) \
+	X(vkCreatePipelineCache) \
+	X(vkDestroyPipelineCache) \
+	X(vkMergePipelineCaches) \
+	X(vkGetPipelineCacheData) \
+	X(vkCmdBeginRenderPass) \
+	X(vkCmdEndRenderPass) \
+	X(vkCmdExecuteCommands) \
+	X(vkCmdPipelineBarrier) \
+	X(vkCmdResetQueryPool) \
+	X(vkCmdWriteTimestamp) \
+	X(vkCmdBlitImage) \
+	X(vkCmdCopyBuffer) \
+	X(vkCmdCopyBufferToImage) \
+	X(vkCmdFillBuffer) \
+	X(vkCmdCopyImageToBuffer) \
+	X(vkCmdClearAttachments) \
+	X(vkCmdPushConstants) \
+	X(vkCmdBindPipeline) \
+	X(vkCmdBindDescriptorSets) \
+	X(vkCmdBindVertexBuffers) \
+	X(vkCmdBindIndexBuffer) \
+	X(vkCmdSetViewport) \
+	X(vkCmdSetScissor) \
+	X(vkCmdDispatch) \
+	X(vkCmdDraw) \
+	X(vkCmdDrawIndexed) \
+	X(vkCmdDrawIndexedIndirect)
+
+//豸չ߰汾ṩĺûʱΪ
+#define VULKAN_DEVICE_OPTIONAL_FUNCTIONS(X) \
+	X(vkGetBufferMemoryRequirements2) \
+	X(vkGetImageMemoryRequirements2) \
+	X(vkCreateSwapchainKHR) \
+	X(vkDestroySwapchainKHR) \
+	X(vkGetSwapchainImagesKHR) \
+	X(vkAcquireNextImageKHR) \
+	X(vkQueuePresentKHR)
+
+struct VulkanDispatch
+{
+#define VULKAN_DECLARE_FUNCTION(name) PFN_##name name = nullptr;
+	VULKAN_INSTANCE_FUNCTIONS(VULKAN_DECLARE_FUNCTION)
+	VULKAN_INSTANCE_OPTIONAL_FUNCTIONS(VULKAN_DECLARE_FUNCTION)
+	VULKAN_DEVICE_FUNCTIONS(VULKAN_DECLARE_FUNCTION)
+	VULKAN_DEVICE_OPTIONAL_FUNCTIONS(VULKAN_DECLARE_FUNCTION)
+#undef VULKAN_DECLARE_FUNCTION
+
+	//vkCreateInstance֮
+	void loadInstance(VkInstance instance)
+	{
+#define VULKAN_LOAD_FUNCTION(name) name = reinterpret_cast<PFN_##name>(::vkGetInstanceProcAddr(instance, #name));
+		VULKAN_INSTANCE_FUNCTIONS(VULKAN_LOAD_FUNCTION)
+		VULKAN_INSTANCE_OPTIONAL_FUNCTIONS(VULKAN_LOAD_FUNCTION)
+#undef VULKAN_LOAD_FUNCTION
+
+#define VULKAN_CHECK_FUNCTION(name) if (name == nullptr) throw std::runtime_error("failed to load " #name "!");
+		VULKAN_INSTANCE_FUNCTIONS(VULKAN_CHECK_FUNCTION)
+#undef VULKAN_CHECK_FUNCTION
+	}
+
+	//vkCreateDevice֮ãȡ豸רõĺپ
+	void loadDevice(VkDevice device)
+	{
+#define VULKAN_LOAD_FUNCTION(name) name = reinterpret_cast<PFN_##name>(vkGetDeviceProcAddr(device, #name));
+		VULKAN_DEVICE_FUNCTIONS(VULKAN_LOAD_FUNCTION)
+		VULKAN_DEVICE_OPTIONAL_FUNCTIONS(VULKAN_LOAD_FUNCTION)
+#undef VULKAN_LOAD_FUNCTION
+
+#define VULKAN_CHECK_FUNCTION(name) if (name == nullptr) throw std::runtime_error("failed to load " #name "!");
+		VULKAN_DEVICE_FUNCTIONS(VULKAN_CHECK_FUNCTION)
+#undef VULKAN_CHECK_FUNCTION
+	}
+};
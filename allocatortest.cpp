@@ -0,0 +1,378 @@
+#include "MemoryAllocator.h"
+
+#include<cstdlib>
+#include<cstring>
+#include<string>
+
+//MemoryAllocatorĵԪԣ㷨ֻƫӷʵ豸ϲ⣨ûGPUʱlavapipe
+//ҲVulkan豸ʱ77ctestΪ
+static int failures = 0;
+
+#define CHECK(condition) \
+	do { if (!(condition)) { printf("  FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+static void testFreeList()
+{
+	printf("free list\n");
+	FreeListAllocator ranges(1024);
+	VkDeviceSize a, b, c, d;
+	CHECK(ranges.allocate(100, 1, a) && a == 0);
+	CHECK(ranges.allocate(100, 64, b) && b == 128);
+	CHECK(ranges.allocate(200, 256, c) && c == 256);
+	CHECK(ranges.usedSize() == 400);
+	//µĿ϶[100, 128)
+	CHECK(ranges.allocate(20, 4, d) && d == 100);
+	ranges.free(d, 20);
+
+	//ͷмͷߣڵĿϲص
+	ranges.free(b, 100);
+	CHECK(ranges.largestFreeRange() == 1024 - 456);
+	ranges.free(a, 100);
+	//[0, 256)ѾϳһΣ256ŽȥǺ
+	CHECK(ranges.allocate(256, 1, d) && d == 0);
+	ranges.free(d, 256);
+	ranges.free(c, 200);
+	CHECK(ranges.empty());
+	CHECK(ranges.largestFreeRange() == 1024);
+
+	//䣺նѡСǸ
+	VkDeviceSize holes[5];
+	for (int i = 0; i < 5; i++)
+		CHECK(ranges.allocate(i == 1 ? 300 : 100, 1, holes[i]));
+	ranges.free(holes[1], 300);
+	ranges.free(holes[3], 100);
+	VkDeviceSize best;
+	CHECK(ranges.allocate(80, 1, best) && best == holes[3]);
+	CHECK(!ranges.allocate(1024, 1, best));
+}
+
+static void testBuddy()
+{
+	printf("buddy\n");
+	BuddyAllocator ranges(4096);
+	VkDeviceSize a, b, c;
+	//300ֽȡ512Ҫ1024ʱȡ1024
+	CHECK(ranges.allocate(300, 1, a) && a == 0);
+	CHECK(ranges.usedSize() == 512);
+	CHECK(ranges.allocate(100, 1024, b) && b % 1024 == 0);
+	CHECK(ranges.allocate(256, 1, c) && c == 512);
+	CHECK(ranges.largestFreeRange() == 2048);
+
+	//ͷź𼶺ϲ
+	ranges.free(a, 300);
+	ranges.free(c, 256);
+	CHECK(ranges.largestFreeRange() == 2048);
+	ranges.free(b, 100);
+	CHECK(ranges.empty());
+	CHECK(ranges.largestFreeRange() == 4096);
+	CHECK(!ranges.allocate(8192, 1, a));
+
+	bool threw = false;
+	try
+	{
+		BuddyAllocator invalid(3000);
+	}
+	catch (const std::exception&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+
+	//ظͷŻͷûƫҪܰѿбŪ
+	CHECK(ranges.allocate(300, 1, a));
+	ranges.free(a, 300);
+	threw = false;
+	try
+	{
+		ranges.free(a, 300);
+	}
+	catch (const std::exception&)
+	{
+		threw = true;
+	}
+	CHECK(threw);
+	CHECK(ranges.empty() && ranges.largestFreeRange() == 4096);
+}
+
+static void testLinear()
+{
+	printf("linear\n");
+	LinearAllocator ranges(1000);
+	VkDeviceSize a, b, c;
+	CHECK(ranges.allocate(100, 1, a) && a == 0);
+	CHECK(ranges.allocate(100, 256, b) && b == 256);
+	CHECK(!ranges.allocate(700, 1, c));
+	//ֻȫͷź
+	ranges.free(a, 100);
+	CHECK(!ranges.empty() && ranges.usedSize() == 356);
+	ranges.free(b, 100);
+	CHECK(ranges.empty() && ranges.largestFreeRange() == 1000);
+}
+
+struct TestDevice
+{
+	VkInstance instance = VK_NULL_HANDLE;
+	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+	VkDevice device = VK_NULL_HANDLE;
+	VulkanDispatch dispatch;
+	bool core11 = false;
+
+	//ûʵ豸ʱfalse
+	bool create()
+	{
+		//1.0ļʶߵapiVersionȷvkEnumerateInstanceVersion
+		uint32_t instanceVersion = VK_API_VERSION_1_0;
+		auto enumerateVersion = reinterpret_cast<PFN_vkEnumerateInstanceVersion>(vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion"));
+		if (enumerateVersion != nullptr)
+			enumerateVersion(&instanceVersion);
+
+		VkApplicationInfo appInfo{};
+		appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+		appInfo.pApplicationName = "Vulkan_01_allocatortest";
+		appInfo.apiVersion = instanceVersion >= VK_API_VERSION_1_1 ? VK_API_VERSION_1_1 : VK_API_VERSION_1_0;
+
+		VkInstanceCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+		createInfo.pApplicationInfo = &appInfo;
+		if (vkCreateInstance(&createInfo, nullptr, &instance) != VK_SUCCESS)
+			return false;
+		dispatch.loadInstance(instance);
+
+		uint32_t count = 0;
+		dispatch.vkEnumeratePhysicalDevices(instance, &count, nullptr);
+		if (count == 0)
+			return false;
+		count = 1;
+		dispatch.vkEnumeratePhysicalDevices(instance, &count, &physicalDevice);
+
+		VkPhysicalDeviceProperties properties;
+		dispatch.vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		core11 = appInfo.apiVersion >= VK_API_VERSION_1_1 && properties.apiVersion >= VK_API_VERSION_1_1;
+		printf("device: %s, Vulkan %u.%u\n", properties.deviceName, properties.apiVersion >> 22, (properties.apiVersion >> 12) & 0x3FF);
+
+		float priority = 1.0f;
+		VkDeviceQueueCreateInfo queueInfo{};
+		queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+		queueInfo.queueFamilyIndex = 0;
+		queueInfo.queueCount = 1;
+		queueInfo.pQueuePriorities = &priority;
+
+		VkDeviceCreateInfo deviceInfo{};
+		deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		deviceInfo.queueCreateInfoCount = 1;
+		deviceInfo.pQueueCreateInfos = &queueInfo;
+		if (dispatch.vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device) != VK_SUCCESS)
+			return false;
+		dispatch.loadDevice(device);
+		return true;
+	}
+
+	void destroy()
+	{
+		if (device != VK_NULL_HANDLE)
+			dispatch.vkDestroyDevice(device, nullptr);
+		if (instance != VK_NULL_HANDLE)
+			dispatch.vkDestroyInstance(instance, nullptr);
+	}
+};
+
+static VkDeviceSize totalReserved(const MemoryAllocator& allocator)
+{
+	VkDeviceSize bytes = 0;
+	for (const auto& stats : allocator.getStats())
+		bytes += stats.reservedBytes;
+	return bytes;
+}
+
+static uint32_t totalBlocks(const MemoryAllocator& allocator)
+{
+	uint32_t blocks = 0;
+	for (const auto& stats : allocator.getStats())
+		blocks += stats.blockCount;
+	return blocks;
+}
+
+static void testSubAllocation(const TestDevice& test)
+{
+	printf("sub-allocation\n");
+	const VkDeviceSize blockSize = 4 * 1024 * 1024;
+	MemoryAllocator allocator;
+	allocator.init(test.physicalDevice, test.device, test.dispatch, test.core11, blockSize);
+
+	//һСӦùͬһ飬以ص
+	const uint32_t count = 64;
+	VkBuffer buffers[count];
+	Allocation allocations[count];
+	for (uint32_t i = 0; i < count; i++)
+		allocator.createBuffer(16 * 1024, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, buffers[i], allocations[i]);
+	CHECK(totalBlocks(allocator) == 1);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		VkMemoryRequirements requirements;
+		test.dispatch.vkGetBufferMemoryRequirements(test.device, buffers[i], &requirements);
+		CHECK(allocations[i].memory == allocations[0].memory);
+		CHECK(allocations[i].offset % requirements.alignment == 0);
+		CHECK(allocations[i].mapped != nullptr);
+		for (uint32_t j = 0; j < i; j++)
+			CHECK(allocations[i].offset + allocations[i].size <= allocations[j].offset || allocations[j].offset + allocations[j].size <= allocations[i].offset);
+	}
+
+	//־ӳָָԵ䣺ÿдԼıٶ
+	for (uint32_t i = 0; i < count; i++)
+		memset(allocations[i].mapped, static_cast<int>(i), static_cast<size_t>(allocations[i].size));
+	for (uint32_t i = 0; i < count; i++)
+		CHECK(static_cast<const uint8_t*>(allocations[i].mapped)[allocations[i].size - 1] == i);
+
+	//һͷһƬȫͷźϲ
+	for (uint32_t i = 0; i < count; i += 2)
+	{
+		test.dispatch.vkDestroyBuffer(test.device, buffers[i], nullptr);
+		allocator.free(allocations[i]);
+		CHECK(allocations[i].memory == VK_NULL_HANDLE);
+	}
+	auto stats = allocator.getStats();
+	double fragmentation = 0.0;
+	for (const auto& s : stats)
+		fragmentation = std::max(fragmentation, s.fragmentation());
+	CHECK(fragmentation > 0.0);
+	for (uint32_t i = 1; i < count; i += 2)
+	{
+		test.dispatch.vkDestroyBuffer(test.device, buffers[i], nullptr);
+		allocator.free(allocations[i]);
+	}
+	for (const auto& s : allocator.getStats())
+	{
+		CHECK(s.usedBytes == 0);
+		CHECK(s.fragmentation() == 0.0);
+		CHECK(s.blockCount == 0 || s.largestFreeRange == blockSize);
+	}
+
+	//տ黹֮ķ鲢ԭλ
+	allocator.releaseEmptyBlocks();
+	CHECK(totalBlocks(allocator) == 0);
+	CHECK(totalReserved(allocator) == 0);
+	VkBuffer buffer;
+	Allocation allocation;
+	allocator.createBuffer(1024, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, buffer, allocation);
+	CHECK(allocation.pool >= 0 && allocation.block == 0 && allocation.offset == 0);
+	test.dispatch.vkDestroyBuffer(test.device, buffer, nullptr);
+	allocator.free(allocation);
+
+	allocator.destroy();
+}
+
+static void testStrategies(const TestDevice& test)
+{
+	printf("strategies\n");
+	const VkDeviceSize blockSize = 1024 * 1024;
+	MemoryAllocator allocator;
+	allocator.init(test.physicalDevice, test.device, test.dispatch, test.core11, blockSize);
+
+	//ͬòͬĳأ鲻
+	VkBuffer buddyBuffer, linearBuffer, freeListBuffer;
+	Allocation buddy, linear, freeList;
+	allocator.createBuffer(3000, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, buddyBuffer, buddy, AllocationStrategy::Buddy);
+	allocator.createBuffer(3000, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, linearBuffer, linear, AllocationStrategy::Linear);
+	allocator.createBuffer(3000, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, freeListBuffer, freeList);
+	CHECK(buddy.memory != linear.memory && linear.memory != freeList.memory && buddy.memory != freeList.memory);
+	CHECK(totalBlocks(allocator) == 3);
+	for (auto* pair : { &buddyBuffer, &linearBuffer, &freeListBuffer })
+		test.dispatch.vkDestroyBuffer(test.device, *pair, nullptr);
+	allocator.free(buddy);
+	allocator.free(linear);
+	allocator.free(freeList);
+	allocator.releaseEmptyBlocks();
+	CHECK(totalBlocks(allocator) == 0);
+
+	//ֱӶ䣬ռ
+	VkBuffer large;
+	Allocation largeAllocation;
+	allocator.createBuffer(blockSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, large, largeAllocation);
+	CHECK(largeAllocation.pool < 0 && largeAllocation.offset == 0);
+	uint32_t dedicatedCount = 0;
+	for (const auto& s : allocator.getStats())
+		dedicatedCount += s.dedicatedCount;
+	CHECK(dedicatedCount == 1 && totalBlocks(allocator) == 0);
+	test.dispatch.vkDestroyBuffer(test.device, large, nullptr);
+	allocator.free(largeAllocation);
+	CHECK(totalReserved(allocator) == 0);
+
+	allocator.destroy();
+}
+
+static void testImages(const TestDevice& test)
+{
+	printf("images\n");
+	MemoryAllocator allocator;
+	allocator.init(test.physicalDevice, test.device, test.dispatch, test.core11, 16 * 1024 * 1024);
+
+	VkImageCreateInfo imageInfo{};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+	imageInfo.extent = { 256, 256, 1 };
+	imageInfo.mipLevels = 1;
+	imageInfo.arrayLayers = 1;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	//еͼͻ岻ͬһҪbufferImageGranularity
+	VkImage image;
+	Allocation imageAllocation;
+	allocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, imageAllocation);
+	VkBuffer buffer;
+	Allocation bufferAllocation;
+	allocator.createBuffer(4096, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, bufferAllocation);
+	CHECK(imageAllocation.memory != bufferAllocation.memory);
+
+	//ҪͼԼռһڴ棬ƫΪ0
+	VkImage dedicatedImage;
+	Allocation dedicatedAllocation;
+	imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+	allocator.createImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, dedicatedImage, dedicatedAllocation, true);
+	CHECK(dedicatedAllocation.pool < 0 && dedicatedAllocation.offset == 0);
+	CHECK(dedicatedAllocation.memory != imageAllocation.memory);
+
+	test.dispatch.vkDestroyImage(test.device, image, nullptr);
+	test.dispatch.vkDestroyImage(test.device, dedicatedImage, nullptr);
+	test.dispatch.vkDestroyBuffer(test.device, buffer, nullptr);
+	allocator.free(imageAllocation);
+	allocator.free(dedicatedAllocation);
+	allocator.free(bufferAllocation);
+	allocator.releaseEmptyBlocks();
+	CHECK(totalReserved(allocator) == 0);
+	allocator.destroy();
+}
+
+int main()
+{
+	testFreeList();
+	testBuddy();
+	testLinear();
+
+	TestDevice test;
+	try
+	{
+		if (!test.create())
+		{
+			printf("no Vulkan device, device tests skipped\n");
+			test.destroy();
+			return failures == 0 ? 77 : EXIT_FAILURE;
+		}
+		testSubAllocation(test);
+		testStrategies(test);
+		testImages(test);
+	}
+	catch (const std::exception& e)
+	{
+		printf("  FAILED: %s\n", e.what());
+		failures++;
+	}
+	test.destroy();
+
+	printf("%s: %d failures\n", failures == 0 ? "passed" : "FAILED", failures);
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,174 @@
+#include "HelloTriangleApplication.h"
+
+#include<iostream>
+#include<cstdlib>
+#include<ctime>
+#include<thread>
+
+//׼Գ޴Уlavapipeβʼ׶Ρϴ¡߳¼ơ
+//ÿGPU޳غ֡ѭGoogle BenchmarkʽJSONڲͬύ֮Ƚ
+struct BenchConfig
+{
+	std::string jsonPath;			//Ϊʱֻӡ
+	uint32_t startupRuns = 10;		//ʼ/ظ
+	uint32_t uploadMB = 256;		//ϴԴ0ʾ
+	bool record = true;				//߳¼Ʋ
+	bool dispatch = true;			//ͷַĵÿ
+	bool culling = true;			//CPUƺGPU޳+ӻƵĶԱȣҪõɫ
+	bool cullKernel = true;			//SSEAVX2޳ں˵
+	bool mesh = true;				//OBJӳ.vkmeshʱ
+	bool renderGraph = true;		//ȾͼıʱϺϲʱԴ
+	bool scheduler = true;			//ύ+ȶпкʱߵÿ֡ʱύ
+	std::vector<std::string> appArgs;	//--device--frames--draws
+};
+
+static BenchConfig parseBenchArgs(int argc, char** argv)
+{
+	BenchConfig bench;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--json" && i + 1 < argc)
+			bench.jsonPath = argv[++i];
+		else if (arg == "--startup-runs" && i + 1 < argc)
+			bench.startupRuns = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--upload-mb" && i + 1 < argc)
+			bench.uploadMB = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--no-record")
+			bench.record = false;
+		else if (arg == "--no-dispatch")
+			bench.dispatch = false;
+		else if (arg == "--no-culling")
+			bench.culling = false;
+		else if (arg == "--no-cull-kernel")
+			bench.cullKernel = false;
+		else if (arg == "--no-mesh")
+			bench.mesh = false;
+		else if (arg == "--no-render-graph")
+			bench.renderGraph = false;
+		else if (arg == "--no-scheduler")
+			bench.scheduler = false;
+		else
+			bench.appArgs.push_back(arg);
+	}
+	return bench;
+}
+
+//ʼÿ׶һȡеƽ׶ֻǽʱ
+static void runStartupBenchmark(const AppConfig& config, uint32_t runs, BenchmarkReport& report)
+{
+	std::vector<std::string> order;
+	std::map<std::string, double> totals;
+	double totalMs = 0.0;
+	BenchmarkReport::Timer timer;
+	for (uint32_t i = 0; i < runs; i++)
+	{
+		HelloTriangleApplication app(config);
+		app.runStartupCycle();
+		for (const auto& phase : app.getStartupTimer().getPhases())
+		{
+			if (totals.find(phase.name) == totals.end())
+				order.push_back(phase.name);
+			totals[phase.name] += phase.ms;
+		}
+		totalMs += app.getStartupTimer().total();
+	}
+	for (const auto& name : order)
+		report.add("startup/" + name, runs, totals[name], totals[name]);
+	report.add("startup/total", runs, totalMs, timer.cpuMs());
+}
+
+//֡ѭCPUʱΪ֡ʱȥȴդͽͼʱ
+static void addFrameResults(const AppConfig& config, const FrameStats& stats, BenchmarkReport& report)
+{
+	if (stats.frames == 0)
+		return;
+	double cpuMs = stats.frameMs - stats.fenceWaitMs - stats.acquireWaitMs;
+	report.add("frame/draws:" + std::to_string(config.drawCount) + "/frames_in_flight:" + std::to_string(config.framesInFlight),
+		stats.frames, stats.frameMs, cpuMs,
+		{ { "fence_wait_ms", stats.fenceWaitMs / stats.frames }, { "acquire_wait_ms", stats.acquireWaitMs / stats.frames },
+		  { "fps", 1000.0 * stats.frames / stats.frameMs } });
+}
+
+static std::string currentDate()
+{
+	char buffer[64];
+	std::time_t now = std::time(nullptr);
+	std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+	return buffer;
+}
+
+int main(int argc, char** argv)
+{
+	BenchConfig bench;
+	AppConfig config;
+	try {
+		bench = parseBenchArgs(argc, argv);
+		std::vector<char*> appArgv = { argv[0] };
+		bool validationGiven = false;
+		for (auto& arg : bench.appArgs)
+		{
+			appArgv.push_back(&arg[0]);
+			validationGiven = validationGiven || arg == "--validation";
+		}
+		config = parseArgs(static_cast<int>(appArgv.size()), appArgv.data());
+
+		//׼Ĭϲ֤㣬Ҳֱܴͬ
+		config.headless = true;
+		config.printStats = false;
+		config.pacing = PacingMode::Uncapped;
+		if (!validationGiven)
+			config.validation = ValidationProfile::Off;
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: Vulkan_01_bench [--json <file>] [--startup-runs N] [--upload-mb N] [--no-record] [--no-dispatch] [--no-culling] [--no-cull-kernel] [--no-mesh] [--no-render-graph] [--no-scheduler]" << std::endl
+			<< "                       [any Vulkan_01 option, e.g. --device <name|uuid> --frames N --draws N --validation perf]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	BenchmarkReport report;
+	report.setContext("date", currentDate());
+	report.setContext("executable", argv[0]);
+	report.setContext("num_cpus", std::to_string(std::thread::hardware_concurrency()));
+#ifdef NDEBUG
+	report.setContext("library_build_type", "release");
+#else
+	report.setContext("library_build_type", "debug");
+#endif
+#ifdef VULKAN_01_GIT_REVISION
+	report.setContext("git_revision", VULKAN_01_GIT_REVISION);
+#endif
+	report.setContext("validation", validationProfileName(config.validation));
+
+	try {
+		if (bench.startupRuns > 0)
+			runStartupBenchmark(config, bench.startupRuns, report);
+
+		AppConfig cycleConfig = config;
+		cycleConfig.uploadBenchMB = bench.uploadMB;
+		cycleConfig.recordBench = bench.record;
+		cycleConfig.dispatchBench = bench.dispatch;
+		cycleConfig.cullingBench = bench.culling && config.drawCount == 0;
+		cycleConfig.cullKernelBench = bench.cullKernel;
+		cycleConfig.meshBench = bench.mesh;
+		cycleConfig.renderGraphBench = bench.renderGraph;
+		cycleConfig.schedulerBench = bench.scheduler;
+		HelloTriangleApplication app(cycleConfig);
+		app.runBenchmarkCycle(report);
+		addFrameResults(cycleConfig, app.getTotalStats(), report);
+		report.setContext("device", app.getDeviceName());
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	report.print();
+	if (!bench.jsonPath.empty() && !report.writeJson(bench.jsonPath))
+	{
+		std::cerr << "failed to write " << bench.jsonPath << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
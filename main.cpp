@@ -1,414 +1,95 @@
-#define GLFW_INCLUDE_VULKAN
-#include <GLFW/glfw3.h>
+#include "HelloTriangleApplication.h"
 
 #include<iostream>
-#include<stdexcept>
 #include<cstdlib>
-#include<vector>
-#include<string.h>
-#include<optional>
 
-const uint32_t WIDTH = 800;
-const uint32_t HEIGHT = 600;
-
-//б׼֤㶼VK_LAYER_KHRONOS_validation
-const std::vector<const char*> validationLayers = {
-	"VK_LAYER_KHRONOS_validation"
-};
-
-//ǷdebugģʽǷ֤
-#ifdef NDEBUG
-	const bool enableValidationLayers = false;
-#else
-	const bool enableValidationLayers = true;
-#endif // NDEBUG
-
-VkResult CreateDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDebugUtilsMessengerEXT* pDebugMessenger) {
-	auto func = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance, "vkCreateDebugUtilsMessengerEXT");
-	if (func != nullptr) {
-		return func(instance, pCreateInfo, pAllocator, pDebugMessenger);
-	}
-	else {
-		return VK_ERROR_EXTENSION_NOT_PRESENT;
-	}
-}
-
-void DestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT debugMessenger, const VkAllocationCallbacks* pAllocator) {
-	auto func = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT");
-	if (func != nullptr) {
-		func(instance, debugMessenger, pAllocator);
-	}
-}
-
-//豸Ķнṹ
-struct QueueFamilyIndices
+int main(int argc, char** argv)
 {
-	std::optional<uint32_t> graphicsFamily;
-
-	bool isComplete()
-	{
-		return graphicsFamily.has_value();
-	}
-};
-
-class HelloTriangleApplication{
-public:
-	void run()
-	{
-		initWindow();
-		initVulcan();
-		mainLoop();
-		cleanup();
-	}
-
-private:
-	void initWindow()
-	{
-		//ȳʼglfw
-		glfwInit();
-
-		//رOPGL
-		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-
-		//ôڲɵС
-		glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
-
-		//
-		window = glfwCreateWindow(WIDTH,HEIGHT,"Vulkan",nullptr,nullptr);
-
-	}
-
-	void initVulcan() 
-	{
-		createInstance();
-		setupDebugMessenger();
-		createSurface();
-		pickPhysicalDevice();
-		createLogicalDevice();
-	}
-
-	void mainLoop()
-	{
-		while (!glfwWindowShouldClose(window))
-		{
-			//ȡϢ
-			glfwPollEvents();
-		}
-	}
-
-	void cleanup()
-	{
-		//߼豸
-		vkDestroyDevice(device, nullptr);
-
-		//Ϣ
-		if (enableValidationLayers) {
-			DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
-		}
-		//VKʵ
-		vkDestroyInstance(instance, nullptr);
-
-		//
-		glfwDestroyWindow(window);
-
+	std::cout << "ԭ" << std::endl;
 
-		//GLFW
-		glfwTerminate();
+	AppConfig config;
+	try {
+		config = parseArgs(argc, argv);
 	}
-
-private:
-	//ʵ
-	void createInstance()
-	{
-		//֤ 鵫Ǽܲ
-		if (enableValidationLayers && !checkValidationLayerSupport())
-		{
-			throw std::runtime_error("validation layers requested, but not available!");
-		}
-
-		//APPϢǱҪ
-		VkApplicationInfo appInfo{};
-		appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;  //עЩϢϢΪϢ
-		appInfo.pApplicationName = "Hello Triangle";
-		appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
-		appInfo.pEngineName = "No Engine";
-		appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-		appInfo.apiVersion = VK_API_VERSION_1_0;
-
-		//VKʵϢҪ
-		VkInstanceCreateInfo createInfo{};
-		createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
-		createInfo.pApplicationInfo = &appInfo;
-
-		/*uint32_t glfwExtensionCount = 0;
-		const char** glfwExtension;
-		glfwExtension = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-		ⲿʹúԶgetRequiredExtensionsˣڲдһּ*/
-
-		auto extensions = getRequiredExtensions();
-
-		createInfo.enabledExtensionCount = static_cast<uint32_t> (extensions.size());
-		createInfo.ppEnabledExtensionNames = extensions.data();
-
-		VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
-		if (enableValidationLayers) {
-			createInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
-			createInfo.ppEnabledLayerNames = validationLayers.data();
-
-			populateDebugMessengerCreateInfo(debugCreateInfo);
-			createInfo.pNext = (VkDebugUtilsMessengerCreateInfoEXT*)&debugCreateInfo;
-		}
-		else {
-			createInfo.enabledLayerCount = 0;
-
-			createInfo.pNext = nullptr;
-		}
-
-		//ʼʵ
-		if (vkCreateInstance(&createInfo, nullptr, &instance) != VK_SUCCESS)
-		{
-			throw std::runtime_error("failed to create instance!");
-		}
-		
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << "usage: Vulkan_01 [--headless] [--device <name|uuid>] [--frames-in-flight N] [--frames N]" << std::endl
+			<< "                 [--pacing uncapped|fps|vsync] [--fps N] [--idle-fps N] [--no-idle-throttle]" << std::endl
+			<< "                 [--pipeline-cache <file>] [--no-pipeline-cache]" << std::endl
+			<< "                 [--staging-mb N] [--upload-bench <total MB>]" << std::endl
+			<< "                 [--threads N] [--draws N] [--record-bench] [--trace <file.json>]" << std::endl
+			<< "                 [--startup-report <file.json>] [--startup-bench N]" << std::endl
+			<< "                 [--debug-log <file>] [--debug-severity verbose,info,warning,error] [--debug-repeat N]" << std::endl
+			<< "                 [--validation off|perf|full] [--validation-bench]   (env: VULKAN_01_VALIDATION)" << std::endl
+			<< "                 [--max-api 1.0|1.1|1.2|1.3] [--dispatch-bench] [--no-host-allocator]" << std::endl
+			<< "                 [--regression clear|draws-1k|draws-10k] [--golden <file.ppm>] [--update-golden]" << std::endl
+			<< "                 [--tolerance N] [--cpu-budget ms] [--gpu-budget ms]" << std::endl
+			<< "                 [--objects N] [--culling cpu|gpu|gpu-nocount] [--culling-bench] [--shader-dir <dir>]" << std::endl
+			<< "                 [--cull-kernel scalar|sse|avx2] [--cull-kernel-bench] [--mesh <file.vkmesh>] [--mesh-bench]" << std::endl
+			<< "                 [--shader-src <dir>] [--shader-cache <dir>] [--hot-reload] [--render-graph] [--render-graph-bench]" << std::endl
+			<< "                 [--scheduler-bench] [--scheduler-trace <file.json>]" << std::endl;
+		return EXIT_FAILURE;
 	}
 
-	//ѡ豸
-	void pickPhysicalDevice()
+	//ԣ޴ڵطʼ/ÿ׶κʱķֲ
+	if (config.startupBenchRuns > 0)
 	{
-		//гп豸
-		uint32_t deviceCount = 0;
-		vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
-
-		if (deviceCount == 0)
-		{
-			throw std::runtime_error("failed to find GPUs with Vulkan support!");
-		}
-
-		std::vector<VkPhysicalDevice> devices(deviceCount);
-		vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
-		
-		//Ƿ
-		for (const auto& device:devices)
-		{
-			if (isDeviceSuitable(device))
+		config.headless = true;
+		config.printStats = false;
+		StartupBenchmark bench;
+		try {
+			for (uint32_t i = 0; i < config.startupBenchRuns; i++)
 			{
-				physicalDevice = device;
-				break;
-			}	
-		}
-
-		if (physicalDevice == VK_NULL_HANDLE)
-			throw std::runtime_error("failed to find a suitable GPU!");
-	}
-
-	//߼豸
-	void createLogicalDevice()
-	{
-		//ָ
-		QueueFamilyIndices indices = findQueueFamily(physicalDevice);
-
-		VkDeviceQueueCreateInfo queueCreateInfo{};
-		queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-		queueCreateInfo.queueFamilyIndex = indices.graphicsFamily.value();
-		queueCreateInfo.queueCount = 1;
-		float queuePriority = 1.0f;
-		queueCreateInfo.pQueuePriorities = &queuePriority;
-
-		//ָʹ豸Щ
-		VkPhysicalDeviceFeatures deviceFeatures{};
-
-		//߼豸Ϣ
-		VkDeviceCreateInfo deviceCreateInfo{};
-		deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-		deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
-		deviceCreateInfo.queueCreateInfoCount = 1;
-
-		deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-
-		deviceCreateInfo.enabledExtensionCount = 0;
-		if (enableValidationLayers)
-		{
-			deviceCreateInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
-			deviceCreateInfo.ppEnabledLayerNames = validationLayers.data();
-		}
-		else
-		{
-			deviceCreateInfo.enabledLayerCount = 0;
+				HelloTriangleApplication app(config);
+				app.runStartupCycle();
+				bench.add(app.getStartupTimer());
+			}
 		}
-		//߼豸
-		if (vkCreateDevice(physicalDevice, &deviceCreateInfo, nullptr, &device) != VK_SUCCESS)
-			throw std::runtime_error("failed to create logical device!");
-
-		//һضо
-		vkGetDeviceQueue(device, indices.graphicsFamily.value(), 0, &graphicsQueue);
-	}
-
-	//ڱ
-	void createSurface()
-	{
-		if (glfwCreateWindowSurface(instance, window, nullptr, &surface) != VK_SUCCESS)
-			throw std::runtime_error("failed to create window surface!");
-	}
-private:
-	//ϢṹϢ
-	void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo) {
-		createInfo = {};
-		createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
-		createInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
-		createInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
-		createInfo.pfnUserCallback = debugCallback;
-		createInfo.pUserData = nullptr; // Optional
-	}
-
-	//debugϢ
-	void setupDebugMessenger()
-	{
-		if (!enableValidationLayers) return;
-
-		VkDebugUtilsMessengerCreateInfoEXT createInfo{};
-		populateDebugMessengerCreateInfo(createInfo);
-
-		if (CreateDebugUtilsMessengerEXT(instance, &createInfo, nullptr, &debugMessenger) != VK_SUCCESS) {
-			throw std::runtime_error("failed to set up debug messenger!");
+		catch (const std::exception& e) {
+			std::cerr << e.what() << std::endl;
+			return EXIT_FAILURE;
 		}
+		bench.print();
+		if (!config.startupReportPath.empty())
+			bench.writeJson(config.startupReportPath);
+		return EXIT_SUCCESS;
 	}
 
-	//Ƿ
-	bool checkValidationLayerSupport()
+	//֤λԣÿλ޴һ飬offȽϳʼʱÿ֡CPUʱ
+	if (config.validationBench)
 	{
-		uint32_t layerCount;
-		vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
-
-		std::vector<VkLayerProperties> availableLayers(layerCount);
-		vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
-
-		//üǷ 
-		//check if all of the layers in validationLayers exist in the availableLayers list
-		//ⲿBǷAֻҪһûоͷfalse
-		for (const char* layerName : validationLayers)
+		config.headless = true;
+		config.printStats = false;
+		config.pacing = PacingMode::Uncapped;
+		double baseStartup = 0.0;
+		double baseFrame = 0.0;
+		printf("validation bench: %u frames per profile\n", config.frameCount);
+		for (ValidationProfile profile : { ValidationProfile::Off, ValidationProfile::Perf, ValidationProfile::Full })
 		{
-			bool layerFound = false;
-
-			for (const auto& layerProperties : availableLayers)
-			{
-				if (strcmp(layerName, layerProperties.layerName) == 0)
+			config.validation = profile;
+			try {
+				HelloTriangleApplication app(config);
+				app.runFrameCycle();
+
+				const FrameStats& stats = app.getTotalStats();
+				double startup = app.getStartupTimer().total();
+				double frame = stats.frames > 0 ? stats.frameMs / stats.frames : 0.0;
+				if (profile == ValidationProfile::Off)
 				{
-					layerFound = true;
-					break;
+					baseStartup = startup;
+					baseFrame = frame;
 				}
+				printf("  %-5s startup %9.3f ms (x%.2f)  frame %8.3f ms (x%.2f)\n", validationProfileName(profile),
+					startup, baseStartup > 0.0 ? startup / baseStartup : 1.0, frame, baseFrame > 0.0 ? frame / baseFrame : 1.0);
 			}
-			
-			if (!layerFound)
-				return false;
-		}
-
-		return true;
-	}
-
-	//ȡչ
-	std::vector<const char*> getRequiredExtensions() 
-	{
-		uint32_t glfwExtensionCount = 0;
-		const char** glfwExtensions;
-		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-		std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
-
-		if (enableValidationLayers)
-			extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
-
-		return extensions;
-	}
-
-	//debugصԶdebugϢ
-	static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
-		VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
-		VkDebugUtilsMessageSeverityFlagsEXT messageType,
-		const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
-		void* pUserData) {
-		switch (messageSeverity)
-		{
-		/*case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-			std::cout << "Diagnostic message: " << std::endl
-				<<pCallbackData->pMessage << std::endl;
-			break;*/
-		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-			std::cout << "Informational message like the creation of a resource: " << std::endl
-				<< pCallbackData->pMessage << std::endl;
-			break;
-		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-			std::cout << "Message about behavior that is not necessarily an error,"<< 
-				"but very likely a bug in your application: " << std::endl
-				<< pCallbackData->pMessage << std::endl;
-			break;
-		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-			std::cout << "Message about behavior that is invalid and may cause crashes: " << std::endl
-				<< pCallbackData->pMessage << std::endl;
-			break;
-		}
-
-		//std::cout << "validation layer: " << pCallbackData->pMessage << std::endl;
-
-		return VK_FALSE;
-	}
-
-	//豸Ƿ
-	bool isDeviceSuitable(VkPhysicalDevice device) {
-		VkPhysicalDeviceProperties  deviceProperties;
-		VkPhysicalDeviceFeatures	deviceFeatures;
-		vkGetPhysicalDeviceProperties(device, &deviceProperties);
-		vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
-		
-		//豸Ķ
-		QueueFamilyIndices indice=findQueueFamily(device);
-
-		return deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU &&
-			deviceFeatures.geometryShader && indice.isComplete();
-	}
-
-	//Ѱ豸Ķ
-	QueueFamilyIndices findQueueFamily(VkPhysicalDevice device)
-	{
-		//г豸Ӧж
-		QueueFamilyIndices indice;
-		uint32_t queueFamilyCount = 0;
-		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
-
-		std::vector<VkQueueFamilyProperties> queueFamily(queueFamilyCount);
-		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamily.data());
-
-		//Ķ
-		int i = 0;
-		for (const auto& queue : queueFamily)
-		{
-			if (queue.queueFlags & VK_QUEUE_GRAPHICS_BIT)
-			{
-				indice.graphicsFamily = i;
+			catch (const std::exception& e) {
+				printf("  %-5s skipped: %s\n", validationProfileName(profile), e.what());
 			}
-			if (indice.isComplete())
-				break;
-			i++;
-
 		}
-
-		return indice;
+		return EXIT_SUCCESS;
 	}
 
-private:
-	GLFWwindow* window = nullptr;
-	VkInstance instance = VK_NULL_HANDLE;
-	VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
-	VkSurfaceKHR surface = VK_NULL_HANDLE;
-
-	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;   //豸
-	VkDevice device = VK_NULL_HANDLE;					//߼豸
-	VkQueue  graphicsQueue = VK_NULL_HANDLE;			//о
-};
-
-int main()
-{
-	std::cout << "ԭ" << std::endl;
-	HelloTriangleApplication app;
+	HelloTriangleApplication app(config);
 
 	try {
 		app.run();
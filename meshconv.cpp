@@ -0,0 +1,55 @@
+#include "MeshImport.h"
+
+#include<iostream>
+#include<chrono>
+#include<cstdlib>
+
+//תOBJ/glTF -> .vkmeshкmeshletѡLZ4ѹʱ--meshɵļ
+int main(int argc, char** argv)
+{
+	std::string input, output;
+	bool compress = false;
+	bool meshlets = true;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--lz4")
+			compress = true;
+		else if (arg == "--no-meshlets")
+			meshlets = false;
+		else if (input.empty())
+			input = arg;
+		else if (output.empty())
+			output = arg;
+		else
+			input.clear();
+	}
+	if (input.empty() || output.empty())
+	{
+		std::cerr << "usage: Vulkan_01_meshconv <input.obj|input.gltf|input.glb> <output.vkmesh> [--lz4] [--no-meshlets]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		auto start = std::chrono::steady_clock::now();
+		MeshData mesh = importMesh(input);
+		if (meshlets)
+			buildMeshlets(mesh);
+		uint64_t rawBytes = mesh.vertices.size() * sizeof(MeshVertex) + mesh.indices.size() * sizeof(uint32_t) +
+			mesh.meshlets.size() * sizeof(Meshlet) + mesh.meshletVertices.size() * sizeof(uint32_t) + mesh.meshletTriangles.size();
+		uint64_t fileBytes = writeMeshFile(mesh, output, compress);
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		printf("%s: %zu vertices, %zu triangles, %zu submeshes, %zu meshlets\n", input.c_str(), mesh.vertices.size(),
+			mesh.indices.size() / 3, mesh.submeshes.size(), mesh.meshlets.size());
+		printf("%s: %.2f MB (%.2f MB uncompressed%s), converted in %.1f ms\n", output.c_str(), fileBytes / (1024.0 * 1024.0),
+			rawBytes / (1024.0 * 1024.0), compress ? ", lz4" : "", ms);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
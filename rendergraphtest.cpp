@@ -0,0 +1,278 @@
+#include "RenderGraph.h"
+
+#include<cstdlib>
+#include<cstdint>
+#include<string>
+#include<vector>
+
+//RenderGraphĵԪԣҪ豸ͼVulkanöVulkanDispatchϼٵĺ
+//ͼСߡÿֽ㣬ֻ¼ÿεõ
+static int failures = 0;
+
+#define CHECK(condition) \
+	do { if (!(condition)) { printf("  FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+namespace fake
+{
+	uintptr_t nextHandle = 0x1000;
+	std::vector<std::pair<VkImage, VkDeviceSize>> imageSizes;
+	uint32_t imagesCreated = 0;
+	uint32_t liveMemory = 0;
+	std::vector<uint32_t> barrierCalls;		//ÿϵͼ
+
+	template<typename Handle>
+	Handle newHandle()
+	{
+		return reinterpret_cast<Handle>(nextHandle++);
+	}
+
+	uint32_t bytesPerPixel(VkFormat format)
+	{
+		return format == VK_FORMAT_R16G16B16A16_SFLOAT ? 8 : 4;
+	}
+
+	void VKAPI_CALL getPhysicalDeviceProperties(VkPhysicalDevice, VkPhysicalDeviceProperties* properties)
+	{
+		*properties = {};
+		properties->limits.maxMemoryAllocationCount = 4096;
+		properties->limits.bufferImageGranularity = 1;
+	}
+
+	void VKAPI_CALL getPhysicalDeviceMemoryProperties(VkPhysicalDevice, VkPhysicalDeviceMemoryProperties* properties)
+	{
+		*properties = {};
+		properties->memoryTypeCount = 1;
+		properties->memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+		properties->memoryHeapCount = 1;
+		properties->memoryHeaps[0].size = 1ull << 30;
+	}
+
+	VkResult VKAPI_CALL createImage(VkDevice, const VkImageCreateInfo* info, const VkAllocationCallbacks*, VkImage* image)
+	{
+		*image = newHandle<VkImage>();
+		imageSizes.push_back({ *image, static_cast<VkDeviceSize>(info->extent.width) * info->extent.height * bytesPerPixel(info->format) });
+		imagesCreated++;
+		return VK_SUCCESS;
+	}
+
+	void VKAPI_CALL getImageMemoryRequirements(VkDevice, VkImage image, VkMemoryRequirements* requirements)
+	{
+		for (const auto& [handle, size] : imageSizes)
+		{
+			if (handle == image)
+				*requirements = { size, 4096, 1 };
+		}
+	}
+
+	VkResult VKAPI_CALL bindImageMemory(VkDevice, VkImage, VkDeviceMemory, VkDeviceSize) { return VK_SUCCESS; }
+
+	VkResult VKAPI_CALL createImageView(VkDevice, const VkImageViewCreateInfo*, const VkAllocationCallbacks*, VkImageView* view)
+	{
+		*view = newHandle<VkImageView>();
+		return VK_SUCCESS;
+	}
+
+	void VKAPI_CALL destroyImage(VkDevice, VkImage, const VkAllocationCallbacks*) {}
+	void VKAPI_CALL destroyImageView(VkDevice, VkImageView, const VkAllocationCallbacks*) {}
+
+	VkResult VKAPI_CALL allocateMemory(VkDevice, const VkMemoryAllocateInfo*, const VkAllocationCallbacks*, VkDeviceMemory* memory)
+	{
+		*memory = newHandle<VkDeviceMemory>();
+		liveMemory++;
+		return VK_SUCCESS;
+	}
+
+	void VKAPI_CALL freeMemory(VkDevice, VkDeviceMemory, const VkAllocationCallbacks*)
+	{
+		liveMemory--;
+	}
+
+	void VKAPI_CALL cmdPipelineBarrier2(VkCommandBuffer, const VkDependencyInfo* dependency)
+	{
+		barrierCalls.push_back(dependency->imageMemoryBarrierCount);
+	}
+
+	void VKAPI_CALL cmdPipelineBarrier(VkCommandBuffer, VkPipelineStageFlags, VkPipelineStageFlags, VkDependencyFlags,
+		uint32_t, const VkMemoryBarrier*, uint32_t, const VkBufferMemoryBarrier*, uint32_t imageBarrierCount, const VkImageMemoryBarrier*)
+	{
+		barrierCalls.push_back(imageBarrierCount);
+	}
+
+	VulkanDispatch dispatch()
+	{
+		VulkanDispatch table;
+		table.vkGetPhysicalDeviceProperties = getPhysicalDeviceProperties;
+		table.vkGetPhysicalDeviceMemoryProperties = getPhysicalDeviceMemoryProperties;
+		table.vkCreateImage = createImage;
+		table.vkGetImageMemoryRequirements = getImageMemoryRequirements;
+		table.vkBindImageMemory = bindImageMemory;
+		table.vkCreateImageView = createImageView;
+		table.vkDestroyImage = destroyImage;
+		table.vkDestroyImageView = destroyImageView;
+		table.vkAllocateMemory = allocateMemory;
+		table.vkFreeMemory = freeMemory;
+		table.vkCmdPipelineBarrier = cmdPipelineBarrier;
+		return table;
+	}
+
+	void reset()
+	{
+		imageSizes.clear();
+		imagesCreated = 0;
+		barrierCalls.clear();
+	}
+}
+
+static const VkDevice device = reinterpret_cast<VkDevice>(uintptr_t(1));
+static const VkCommandBuffer commandBuffer = reinterpret_cast<VkCommandBuffer>(uintptr_t(2));
+
+//ӳȾļ򻯰棬ͨ⵹
+//  gbuffer -> lighting -> bloom -> composite -> backbufferdebuggbufferû
+struct TestGraph
+{
+	RenderGraph graph;
+	std::vector<std::string> executed;
+	uint32_t gbuffer, lighting, bloom, debug, backbuffer;
+
+	void build(const VulkanDispatch& dispatch, MemoryAllocator& allocator, PFN_vkCmdPipelineBarrier2 cmdPipelineBarrier2)
+	{
+		graph.init(device, dispatch, allocator, cmdPipelineBarrier2);
+		gbuffer = graph.createImage("gbuffer", { 256, 256, VK_FORMAT_R8G8B8A8_UNORM });			//256 KB
+		lighting = graph.createImage("lighting", { 256, 256, VK_FORMAT_R16G16B16A16_SFLOAT });	//512 KB
+		bloom = graph.createImage("bloom", { 128, 128, VK_FORMAT_R8G8B8A8_UNORM });				//64 KB
+		debug = graph.createImage("debug", { 256, 256, VK_FORMAT_R8G8B8A8_UNORM });
+		backbuffer = graph.importImage("backbuffer", { 256, 256, VK_FORMAT_R8G8B8A8_UNORM }, VK_IMAGE_LAYOUT_UNDEFINED,
+			VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
+		graph.setImportedImage(backbuffer, fake::newHandle<VkImage>(), fake::newHandle<VkImageView>());
+
+		add("composite", { { lighting, GraphAccess::SampledRead }, { bloom, GraphAccess::SampledRead }, { backbuffer, GraphAccess::ColorAttachmentWrite } });
+		add("debug", { { gbuffer, GraphAccess::SampledRead }, { debug, GraphAccess::ColorAttachmentWrite } });
+		add("bloom", { { lighting, GraphAccess::SampledRead }, { bloom, GraphAccess::StorageWrite } });
+		add("lighting", { { gbuffer, GraphAccess::SampledRead }, { lighting, GraphAccess::ColorAttachmentWrite } });
+		add("gbuffer", { { gbuffer, GraphAccess::ColorAttachmentWrite } });
+	}
+
+	void add(const std::string& name, std::vector<RenderGraph::ResourceUse> uses)
+	{
+		graph.addPass(name, std::move(uses), [this, name](VkCommandBuffer, const RenderGraph&) { executed.push_back(name); });
+	}
+};
+
+static void testCompile(PFN_vkCmdPipelineBarrier2 cmdPipelineBarrier2)
+{
+	printf("compile (%s)\n", cmdPipelineBarrier2 != nullptr ? "synchronization2" : "vkCmdPipelineBarrier");
+	fake::reset();
+	VulkanDispatch dispatch = fake::dispatch();
+	MemoryAllocator allocator;
+	allocator.init(VK_NULL_HANDLE, device, dispatch, false);
+
+	TestGraph test;
+	test.build(dispatch, allocator, cmdPipelineBarrier2);
+	test.graph.compile();
+	const RenderGraph::Stats& stats = test.graph.getStats();
+
+	//˳ͬʱİ˳ͼֻһֺϷ˳
+	test.graph.execute(commandBuffer);
+	CHECK((test.executed == std::vector<std::string>{ "gbuffer", "lighting", "bloom", "composite" }));
+
+	//debugĽû˶޳ռͼҲ
+	CHECK(stats.passes == 5);
+	CHECK(stats.culledPasses == 1);
+	CHECK(stats.transientImages == 3);
+	CHECK(fake::imagesCreated == 3);
+
+	//ÿͨǰһεãgbuffer 1״ʹãlighting 2gbufferתΪlighting״ʹã
+	//bloom 2lightingתΪbloom״ʹãcomposite 2bloomתΪbackbufferlightingӣ
+	//backbufferתPRESENT 1
+	CHECK((fake::barrierCalls == std::vector<uint32_t>{ 1, 2, 2, 2, 1 }));
+	CHECK(stats.barriers == 8);
+	CHECK(stats.barrierCalls == 5);
+
+	//״䣺lighting(512K, ͨ1-3)0gbuffer(256K, 0-1)ص512K
+	//bloom(64K, 2-3)gbufferصgbufferλãֵ768Kʱ832K
+	CHECK(stats.peakWithoutAliasing == (256 + 512 + 64) * 1024);
+	CHECK(stats.peakWithAliasing == (512 + 256) * 1024);
+
+	test.graph.destroy();
+	allocator.destroy();
+	CHECK(fake::liveMemory == 0);
+}
+
+static void testErrors()
+{
+	printf("errors\n");
+	fake::reset();
+	VulkanDispatch dispatch = fake::dispatch();
+	MemoryAllocator allocator;
+	allocator.init(VK_NULL_HANDLE, device, dispatch, false);
+
+	auto compileThrows = [&](auto declare)
+	{
+		RenderGraph graph;
+		graph.init(device, dispatch, allocator, fake::cmdPipelineBarrier2);
+		declare(graph);
+		bool threw = false;
+		try
+		{
+			graph.compile();
+		}
+		catch (const std::exception&)
+		{
+			threw = true;
+		}
+		graph.destroy();
+		return threw;
+	};
+	auto none = [](VkCommandBuffer, const RenderGraph&) {};
+	const RenderGraph::ImageDesc desc{ 64, 64, VK_FORMAT_R8G8B8A8_UNORM };
+
+	//ͨдͬһԴ
+	CHECK(compileThrows([&](RenderGraph& graph)
+	{
+		uint32_t target = graph.importImage("target", desc, VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_NONE,
+			VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
+		graph.addPass("a", { { target, GraphAccess::ColorAttachmentWrite } }, none);
+		graph.addPass("b", { { target, GraphAccess::TransferWrite } }, none);
+	}));
+
+	//abĽbaĽ
+	CHECK(compileThrows([&](RenderGraph& graph)
+	{
+		uint32_t x = graph.createImage("x", desc);
+		uint32_t y = graph.createImage("y", desc);
+		uint32_t target = graph.importImage("target", desc, VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_NONE,
+			VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
+		graph.addPass("a", { { x, GraphAccess::SampledRead }, { y, GraphAccess::ColorAttachmentWrite } }, none);
+		graph.addPass("b", { { y, GraphAccess::SampledRead }, { x, GraphAccess::ColorAttachmentWrite } }, none);
+		graph.addPass("c", { { x, GraphAccess::SampledRead }, { target, GraphAccess::ColorAttachmentWrite } }, none);
+	}));
+
+	//һûͨдʱͼ
+	CHECK(compileThrows([&](RenderGraph& graph)
+	{
+		uint32_t x = graph.createImage("x", desc);
+		uint32_t target = graph.importImage("target", desc, VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_NONE,
+			VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
+		graph.addPass("a", { { x, GraphAccess::SampledRead }, { target, GraphAccess::ColorAttachmentWrite } }, none);
+	}));
+
+	allocator.destroy();
+}
+
+int main()
+{
+	try
+	{
+		testCompile(fake::cmdPipelineBarrier2);
+		testCompile(nullptr);
+		testErrors();
+	}
+	catch (const std::exception& e)
+	{
+		printf("  FAILED: %s\n", e.what());
+		failures++;
+	}
+
+	printf("%s: %d failures\n", failures == 0 ? "passed" : "FAILED", failures);
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,28 @@
+#version 450
+
+// 物体的位置、大小和颜色都在存储缓冲里，用gl_InstanceIndex（间接命令的firstInstance）索引
+
+struct Object
+{
+	vec4 sphere;
+	vec4 color;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects { Object objects[]; };
+
+layout(push_constant) uniform Camera
+{
+	mat4 viewProj;
+} camera;
+
+layout(location = 0) in vec3 inPosition;
+
+layout(location = 0) out vec3 outColor;
+
+void main()
+{
+	Object object = objects[gl_InstanceIndex];
+	gl_Position = camera.viewProj * vec4(object.sphere.xyz + inPosition * object.sphere.w, 1.0);
+	// 上下两面明暗不同，能看出立方体的朝向
+	outColor = object.color.rgb * (0.75 + 0.25 * inPosition.y);
+}